@@ -7,6 +7,7 @@
 #include <AP_ADC.h>
 #include <AP_DCM.h>
 #include <AP_Compass.h>
+#include <AP_Math.h>
 #include <Wire.h>
 #include <AP_GPS.h>
 #include <AP_IMU.h>
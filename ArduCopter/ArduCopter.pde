@@ -68,12 +68,14 @@ And much more so PLEASE PM me on DIYDRONES to add your contribution to the List
 #include <AP_TimerAperiodicProcess.h>   // TimerAperiodicProcess is the scheduler for ADC reads.
 #include <AP_DCM.h>         // ArduPilot Mega DCM Library
 #include <APM_PI.h>            	// PI library
+#include <APM_Nav.h>			// Navigation rate control library
 #include <RC_Channel.h>     // RC Channel Library
 #include <AP_RangeFinder.h>	// Range finder library
 #include <AP_OpticalFlow.h> // Optical Flow library
 #include <ModeFilter.h>
 #include <AP_Relay.h>		// APM relay
 #include <GCS_MAVLink.h>    // MAVLink GCS definitions
+#include <AP_Scheduler.h>   // main loop task scheduler
 #include <memcheck.h>
 
 // Configuration
@@ -272,8 +274,6 @@ AP_AnalogSource_Arduino sonar_analog_source(CONFIG_SONAR_SOURCE_ANALOG_PIN);
 ////////////////////////////////////////////////////////////////////////////////
 // Global variables
 ////////////////////////////////////////////////////////////////////////////////
-static const char *comma = ",";
-
 static const char* flight_mode_strings[] = {
 	"STABILIZE",
 	"ACRO",
@@ -297,14 +297,6 @@ static const char* flight_mode_strings[] = {
 			8	TBD
 */
 
-// temp
-static int16_t y_actual_speed;
-static int16_t y_rate_error;
-
-// calc the
-static int16_t x_actual_speed;
-static int16_t x_rate_error;
-
 // Radio
 // -----
 static byte 	control_mode		= STABILIZE;
@@ -348,8 +340,7 @@ static byte	led_mode = NORMAL_LEDS;
 // GPS variables
 // -------------
 static const 	float t7			= 10000000.0;	// used to scale GPS values for EEPROM storage
-static float 	scaleLongUp			= 1;			// used to reverse longitude scaling
-static float 	scaleLongDown 		= 1;			// used to reverse longitude scaling
+static LocalFrame	local_frame;					// meters north and east of home
 static byte 	ground_start_count	= 10;			// have we achieved first lock and set Home?
 static bool 	did_ground_start	= false;		// have we ground started after first arming
 
@@ -369,14 +360,9 @@ static byte	command_cond_index;						// current command memory location
 //static byte	command_cond_ID;						// current command ID
 static byte wp_verify_byte;							// used for tracking state of navigating waypoints
 
-static float cos_roll_x 	= 1;
-static float cos_pitch_x 	= 1;
-static float cos_yaw_x 		= 1;
-static float sin_pitch_y, sin_yaw_y, sin_roll_y;
 static int32_t initial_simple_bearing;					// used for Simple mode
 static float simple_sin_y, simple_cos_x;
 static int8_t jump = -10;								// used to track loops in jump command
-static int16_t waypoint_speed_gov;
 
 static float circle_angle;
 // replace with param
@@ -465,10 +451,9 @@ static int32_t		nav_roll;							// deg * 100 : target roll angle
 static int32_t		nav_pitch;							// deg * 100 : target pitch angle
 static int32_t		nav_yaw;							// deg * 100 : target yaw angle
 static int32_t		auto_yaw;							// deg * 100 : target yaw angle
-static int32_t		nav_lat;							// for error calcs
-static int32_t		nav_lon;							// for error calcs
 static int16_t		nav_throttle;						// 0-1000 for throttle control
-static int16_t		crosstrack_error;
+// waypoint and loiter rate control, which works out nav_lat and nav_lon
+static APM_Nav		wp_nav(g.pi_nav_lat, g.pi_nav_lon, g.pi_loiter_lat, g.pi_loiter_lon);
 
 static uint32_t throttle_integrator;				// used to integrate throttle output to predict battery life
 static bool 	invalid_throttle;					// used to control when we calculate nav_throttle
@@ -541,11 +526,8 @@ static int				pmTest1;
 // System Timers
 // --------------
 static uint32_t 	    fast_loopTimer;				// Time in miliseconds of main control loop
-static byte 			medium_loopCounter;			// Counters for branching from main control loop to slower loops
-
-static uint32_t	        fiftyhz_loopTimer;
+static byte 			medium_loopCounter;			// Counters for branching from main control loop to slower loops (test and planner only)
 
-static byte 			slow_loopCounter;
 static int16_t			superslow_loopCounter;
 static byte				simple_timer;				// for limiting the execution of flight mode thingys
 
@@ -553,12 +535,14 @@ static byte				simple_timer;				// for limiting the execution of flight mode thi
 static float 			dTnav;						// Delta Time in milliseconds for navigation computations
 static uint32_t         nav_loopTimer;				// used to track the elapsed ime for GPS nav
 
-static byte				counter_one_herz;
 static bool				GPS_enabled 	= false;
 static bool				new_radio_frame;
 
 AP_Relay relay;
 
+// Runs everything apart from the fast loop
+static AP_Scheduler scheduler;
+
 #if USB_MUX_PIN > 0
 static bool usb_connected;
 #endif
@@ -568,55 +552,58 @@ static bool usb_connected;
 // Top-level logic
 ////////////////////////////////////////////////////////////////////////////////
 
+/*
+  scheduler table - all regular tasks apart from the fast_loop()
+  should be listed here, along with how often they should be called
+  (in 5ms ticks) and the maximum time they are expected to take (in
+  microseconds). Tasks run in the order listed whenever they are due
+  and fit in what is left of the current tick.
+ */
+static const AP_Scheduler::Task scheduler_tasks[] PROGMEM = {
+	{ fifty_hz_loop,		  4,	 950 },
+	{ gps_compass_loop,		 20,	1400 },
+	{ navigation_loop,		 20,	 800 },
+	{ altitude_loop,		 20,	 700 },
+	{ commands_loop,		 20,	1000 },
+	{ mission_write_loop,	  1,	  50 },
+	{ medium_loop,			 20,	 600 },
+	{ compass_offsets_loop,	 60,	 200 },
+	{ control_switch_loop,	 60,	 300 },
+	{ slow_loop,			 60,	 800 },
+	{ super_slow_loop,		200,	 500 },
+	{ perf_update,			240,	 300 },
+};
+
+// what the scheduler keeps for each task in the table
+static AP_Scheduler::Task_State scheduler_state[sizeof(scheduler_tasks) / sizeof(scheduler_tasks[0])];
+
 void setup() {
 	memcheck_init();
 	init_ardupilot();
+
+	scheduler.init(scheduler_tasks, scheduler_state);
 }
 
 void loop()
 {
-	int32_t timer 			= micros();
+	uint32_t timer 			= micros();
+	uint32_t time_used;
+
 	// We want this to execute fast
 	// ----------------------------
 	if ((timer - fast_loopTimer) >= 5000) {
-		//PORTK |= B00010000;
 		G_Dt 				= (float)(timer - fast_loopTimer) / 1000000.f;		// used by PI Loops
 		fast_loopTimer 		= timer;
 
 		// Execute the fast loop
 		// ---------------------
 		fast_loop();
-	}
-	//PORTK &= B11101111;
-
-	if ((timer - fiftyhz_loopTimer) >= 20000) {
-		fiftyhz_loopTimer		= timer;
-		//PORTK |= B01000000;
-
-		// reads all of the necessary trig functions for cameras, throttle, etc.
-		update_trig();
-
-		// perform 10hz tasks
-		medium_loop();
 
-		// Stuff to run at full 50hz, but after the loops
-		fifty_hz_loop();
-
-		counter_one_herz++;
-
-		if(counter_one_herz == 50){
-			super_slow_loop();
-			counter_one_herz = 0;
-		}
-
-		if (millis() - perf_mon_timer > 1200 /*20000*/) {
-			if (g.log_bitmask & MASK_LOG_PM)
-				Log_Write_Performance();
-
-			gps_fix_count 		= 0;
-			perf_mon_timer 		= millis();
-        }
-		//PORTK &= B10111111;
+		// hand whatever is left of the 5ms slot to the slower tasks
+		// ---------------------------------------------------------
+		scheduler.tick();
+		time_used = micros() - timer;
+		scheduler.run(time_used < 5000 ? 5000 - time_used : 0);
 	}
 }
 //  PORTK |= B01000000;
@@ -655,163 +642,139 @@ static void fast_loop()
 
 }
 
-static void medium_loop()
+// This deals with the GPS and Compass
+//------------------------------------
+static void gps_compass_loop()
 {
-	// This is the start of the medium (10 Hz) loop pieces
-	// -----------------------------------------
-	switch(medium_loopCounter) {
-
-		// This case deals with the GPS and Compass
-		//-----------------------------------------
-		case 0:
-			medium_loopCounter++;
-
-			#ifdef OPTFLOW_ENABLED
-			if(g.optflow_enabled){
-				optflow.read();
-				optflow.update_position(dcm.roll, dcm.pitch, cos_yaw_x, sin_yaw_y, current_loc.alt);  // updates internal lon and lat with estimation based on optical flow
-
-				// write to log
-				if (g.log_bitmask & MASK_LOG_OPTFLOW){
-					Log_Write_Optflow();
-				}
-			}
-			#endif
-
-			if(GPS_enabled){
-				update_GPS();
-			}
-
-
-			#if HIL_MODE != HIL_MODE_ATTITUDE					// don't execute in HIL mode
-				if(g.compass_enabled){
-					compass.read();		 						// Read magnetometer
-					compass.calculate(dcm.get_dcm_matrix());  	// Calculate heading
-					compass.null_offsets(dcm.get_dcm_matrix());
-				}
-			#endif
-
-			// auto_trim, uses an auto_level algorithm
-			auto_trim();
-
-			// record throttle output
-			// ------------------------------
-			throttle_integrator += g.rc_3.servo_out;
-			break;
+	#ifdef OPTFLOW_ENABLED
+	if(g.optflow_enabled){
+		optflow.read();
+		optflow.update_position(dcm.roll(), dcm.pitch(), dcm.sin_yaw(), dcm.cos_yaw(), current_loc.alt);  // updates internal lon and lat with estimation based on optical flow
 
-		// This case performs some navigation computations
-		//------------------------------------------------
-		case 1:
-			medium_loopCounter++;
+		// write to log
+		if (g.log_bitmask & MASK_LOG_OPTFLOW){
+			Log_Write_Optflow();
+		}
+	}
+	#endif
 
-			// Auto control modes:
-			if(nav_ok){
-				// clear nav flag
-				nav_ok = false;
+	if(GPS_enabled){
+		update_GPS();
+	}
 
-				// invalidate GPS data
-				// -------------------
-				g_gps->new_data 	= false;
 
-				// calculate the copter's desired bearing and WP distance
-				// ------------------------------------------------------
-				if(navigate()){
+	#if HIL_MODE != HIL_MODE_ATTITUDE					// don't execute in HIL mode
+		if(g.compass_enabled){
+			compass.read();		 						// Read magnetometer
+			compass.calculate(dcm.get_dcm_matrix());  	// Calculate heading
+			compass.null_offsets(dcm.get_dcm_matrix());
 
-					// control mode specific updates
-					// -----------------------------
-					update_navigation();
+			if (g.log_bitmask & MASK_LOG_COMPASS)
+				Log_Write_Compass();
+		}
+	#endif
 
-					if (g.log_bitmask & MASK_LOG_NTUN)
-						Log_Write_Nav_Tuning();
-				}
-			}
-			break;
+	// auto_trim, uses an auto_level algorithm
+	auto_trim();
 
-		// command processing
-		//-------------------
-		case 2:
-			medium_loopCounter++;
+	// record throttle output
+	// ------------------------------
+	throttle_integrator += g.rc_3.servo_out;
+}
 
-			// Read altitude from sensors
-			// --------------------------
-			#if HIL_MODE != HIL_MODE_ATTITUDE					// don't execute in HIL mode
-			update_altitude();
-			#endif
+// This performs some navigation computations
+//-------------------------------------------
+static void navigation_loop()
+{
+	// Auto control modes:
+	if(nav_ok){
+		// clear nav flag
+		nav_ok = false;
 
-			// invalidate the throttle hold value
-			// ----------------------------------
-			invalid_throttle = true;
+		// invalidate GPS data
+		// -------------------
+		g_gps->new_data 	= false;
 
-			break;
+		// calculate the copter's desired bearing and WP distance
+		// ------------------------------------------------------
+		if(navigate()){
 
-		// This case deals with sending high rate telemetry
-		//-------------------------------------------------
-		case 3:
-			medium_loopCounter++;
-			// test
-			// perform next command
-			// --------------------
-			if(control_mode == AUTO){
-				if(home_is_set == true && g.command_total > 1){
-					update_commands();
-				}
-			}
+			// control mode specific updates
+			// -----------------------------
+			update_navigation();
 
-            if(motor_armed){
-                if (g.log_bitmask & MASK_LOG_ATTITUDE_MED)
-                    Log_Write_Attitude();
+			if (g.log_bitmask & MASK_LOG_NTUN)
+				Log_Write_Nav_Tuning();
+		}
+	}
+}
 
-                if (g.log_bitmask & MASK_LOG_CTUN)
-                    Log_Write_Control_Tuning();
-            }
+static void altitude_loop()
+{
+	// Read altitude from sensors
+	// --------------------------
+	#if HIL_MODE != HIL_MODE_ATTITUDE					// don't execute in HIL mode
+	update_altitude();
+	#endif
 
-				// send all requested output streams with rates requested
-				// between 5 and 45 Hz
-				gcs_data_stream_send(5,45);
+	// invalidate the throttle hold value
+	// ----------------------------------
+	invalid_throttle = true;
+}
 
-			if (g.log_bitmask & MASK_LOG_MOTORS)
-				Log_Write_Motors();
+// This deals with command processing and sending high rate telemetry
+//-------------------------------------------------------------------
+static void commands_loop()
+{
+	// perform next command
+	// --------------------
+	if(control_mode == AUTO){
+		if(home_is_set == true && g.command_total > 1){
+			update_commands();
+		}
+	}
 
-			break;
+    if(motor_armed){
+        if (g.log_bitmask & MASK_LOG_ATTITUDE_MED)
+            Log_Write_Attitude();
 
-		// This case controls the slow loop
-		//---------------------------------
-		case 4:
-			medium_loopCounter = 0;
+        if (g.log_bitmask & MASK_LOG_CTUN)
+            Log_Write_Control_Tuning();
+    }
 
-			if (g.battery_monitoring != 0){
-				read_battery();
-			}
+	// send all requested output streams with rates requested
+	// between 5 and 45 Hz
+	gcs_data_stream_send(5,45);
 
-			// Accel trims 		= hold > 2 seconds
-			// Throttle cruise  = switch less than 1 second
-			// --------------------------------------------
-			read_trim_switch();
+	if (g.log_bitmask & MASK_LOG_MOTORS)
+		Log_Write_Motors();
+}
 
-			// Check for engine arming
-			// -----------------------
-			arm_motors();
+static void medium_loop()
+{
+	if (g.battery_monitoring != 0){
+		read_battery();
+	}
 
-			// Do an extra baro read
-			// ---------------------
-			#if HIL_MODE != HIL_MODE_ATTITUDE
-			barometer.Read();
-			#endif
+	// Accel trims 		= hold > 2 seconds
+	// Throttle cruise  = switch less than 1 second
+	// --------------------------------------------
+	read_trim_switch();
 
-			// agmatthews - USERHOOKS
-			#ifdef USERHOOK_MEDIUMLOOP
-			   USERHOOK_MEDIUMLOOP
-			#endif
+	// Check for engine arming
+	// -----------------------
+	arm_motors();
 
-			slow_loop();
-			break;
+	// Do an extra baro read
+	// ---------------------
+	#if HIL_MODE != HIL_MODE_ATTITUDE
+	barometer.Read();
+	#endif
 
-		default:
-			// this is just a catch all
-			// ------------------------
-			medium_loopCounter = 0;
-			break;
-	}
+	// agmatthews - USERHOOKS
+	#ifdef USERHOOK_MEDIUMLOOP
+	   USERHOOK_MEDIUMLOOP
+	#endif
 }
 
 // stuff that happens at 50 hz
@@ -862,82 +825,64 @@ static void fifty_hz_loop()
 }
 
 
-static void slow_loop()
+// This is the slow (3 1/3 Hz) loop pieces
+//----------------------------------------
+static void compass_offsets_loop()
 {
-	// This is the slow (3 1/3 Hz) loop pieces
-	//----------------------------------------
-	switch (slow_loopCounter){
-		case 0:
-			slow_loopCounter++;
-			superslow_loopCounter++;
-
-			if(superslow_loopCounter > 1200){
-				#if HIL_MODE != HIL_MODE_ATTITUDE
-					if(g.rc_3.control_in == 0 && control_mode == STABILIZE && g.compass_enabled){
-						compass.save_offsets();
-						superslow_loopCounter = 0;
-					}
-				#endif
-            }
-			break;
+	superslow_loopCounter++;
 
-		case 1:
-			slow_loopCounter++;
-
-			// Read 3-position switch on radio
-			// -------------------------------
-			read_control_switch();
-
-			// Read main battery voltage if hooked up - does not read the 5v from radio
-			// ------------------------------------------------------------------------
-			//#if BATTERY_EVENT == 1
-			//	read_battery();
-			//#endif
-
-			#if AUTO_RESET_LOITER == 1
-			if(control_mode == LOITER){
-				//if((abs(g.rc_2.control_in) + abs(g.rc_1.control_in)) > 1500){
-					// reset LOITER to current position
-					//next_WP 	= current_loc;
-				//}
+	if(superslow_loopCounter > 1200){
+		#if HIL_MODE != HIL_MODE_ATTITUDE
+			if(g.rc_3.control_in == 0 && control_mode == STABILIZE && g.compass_enabled){
+				compass.save_offsets();
+				superslow_loopCounter = 0;
 			}
-			#endif
+		#endif
+    }
+}
 
-			break;
+static void control_switch_loop()
+{
+	// Read 3-position switch on radio
+	// -------------------------------
+	read_control_switch();
+
+	#if AUTO_RESET_LOITER == 1
+	if(control_mode == LOITER){
+		//if((abs(g.rc_2.control_in) + abs(g.rc_1.control_in)) > 1500){
+			// reset LOITER to current position
+			//next_WP 	= current_loc;
+		//}
+	}
+	#endif
+}
 
-		case 2:
-			slow_loopCounter = 0;
-			update_events();
+static void slow_loop()
+{
+	update_events();
 
-			// blink if we are armed
-			update_lights();
+	// blink if we are armed
+	update_lights();
 
-            // send all requested output streams with rates requested
-            // between 1 and 5 Hz
-            gcs_data_stream_send(1,5);
+    // send all requested output streams with rates requested
+    // between 1 and 5 Hz
+    gcs_data_stream_send(1,5);
 
-			if(g.radio_tuning > 0)
-				tuning();
+	if(g.radio_tuning > 0)
+		tuning();
 
-			#if MOTOR_LEDS == 1
-				update_motor_leds();
-			#endif
+	#if MOTOR_LEDS == 1
+		update_motor_leds();
+	#endif
 
 #if USB_MUX_PIN > 0
-            check_usb_mux();
+    check_usb_mux();
 #endif
-			break;
-
-		default:
-			slow_loopCounter = 0;
-			break;
 
-	}
 	// agmatthews - USERHOOKS
 	#ifdef USERHOOK_SLOWLOOP
 	   USERHOOK_SLOWLOOP
 	#endif
-
 }
 
 // 1Hz loop
@@ -953,6 +898,15 @@ static void super_slow_loop()
 	#endif
 }
 
+static void perf_update()
+{
+	if (g.log_bitmask & MASK_LOG_PM)
+		Log_Write_Performance();
+
+	gps_fix_count 		= 0;
+	perf_mon_timer 		= millis();
+}
+
 static void update_GPS(void)
 {
 	g_gps->update();
@@ -1070,7 +1024,7 @@ void update_roll_pitch_mode(void)
 		new_radio_frame = false;
 		simple_timer++;
 
-		int delta = wrap_360(dcm.yaw_sensor - initial_simple_bearing)/100;
+		int delta = wrap_360(dcm.yaw_sensor() - initial_simple_bearing)/100;
 
 		if (simple_timer == 1){
 			// roll
@@ -1272,30 +1226,6 @@ static void read_AHRS(void)
 	omega = dcm.get_gyro();
 }
 
-static void update_trig(void){
-	Vector2f yawvector;
-	Matrix3f temp 	= dcm.get_dcm_matrix();
-
-	yawvector.x 	= temp.a.x; // sin
-	yawvector.y 	= temp.b.x;	// cos
-	yawvector.normalize();
-
-
-	sin_pitch_y 	= -temp.c.x;
-	cos_pitch_x 	= sqrt(1 - (temp.c.x * temp.c.x));
-
-	cos_roll_x 		= temp.c.z / cos_pitch_x;
-	sin_roll_y 		= temp.c.y / cos_pitch_x;
-
-	cos_yaw_x 		= yawvector.y;	// 0 x = north
-	sin_yaw_y 		= yawvector.x;	// 1 y
-
-	//flat:
-	// 0 ° = cos_yaw:  0.00, sin_yaw:  1.00,
-	// 90° = cos_yaw:  1.00, sin_yaw:  0.00,
-	// 180 = cos_yaw:  0.00, sin_yaw: -1.00,
-	// 270 = cos_yaw: -1.00, sin_yaw:  0.00,
-}
 
 // updated at 10hz
 static void update_altitude()
@@ -1348,7 +1278,7 @@ static void update_altitude()
 		if(baro_alt < 800){
 			#if SONAR_TILT_CORRECTION == 1
 				// correct alt for angle of the sonar
-				float temp = cos_pitch_x * cos_roll_x;
+				float temp = dcm.cos_pitch() * dcm.cos_roll();
 				temp = max(temp, 0.707);
 				sonar_alt = (float)sonar_alt * temp;
 			#endif
@@ -1548,7 +1478,7 @@ static void update_nav_wp()
 		if (circle_angle > 6.28318531)
 			circle_angle -= 6.28318531;
 
-		target_WP.lng = next_WP.lng + (g.loiter_radius * 100 * cos(1.57 - circle_angle) * scaleLongUp);
+		target_WP.lng = next_WP.lng + (g.loiter_radius * 100 * cos(1.57 - circle_angle) / local_frame.lng_scale());
 		target_WP.lat = next_WP.lat + (g.loiter_radius * 100 * sin(1.57 - circle_angle));
 
 		// calc the lat and long error to the target
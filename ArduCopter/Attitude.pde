@@ -5,7 +5,7 @@ get_stabilize_roll(int32_t target_angle)
 	int32_t error;
 	int32_t rate;
 
-	error 		= wrap_180(target_angle - dcm.roll_sensor);
+	error 		= wrap_180(target_angle - dcm.roll_sensor());
 
 	// limit the error we're feeding to the PID
 	error 		= constrain(error, -2500, 2500);
@@ -31,7 +31,7 @@ get_stabilize_pitch(int32_t target_angle)
 	int32_t error;
 	int32_t rate;
 
-	error 		= wrap_180(target_angle - dcm.pitch_sensor);
+	error 		= wrap_180(target_angle - dcm.pitch_sensor());
 
 	// limit the error we're feeding to the PID
 	error 		= constrain(error, -2500, 2500);
@@ -59,7 +59,7 @@ get_stabilize_yaw(int32_t target_angle)
 	int32_t error;
 	int32_t rate;
 
-	yaw_error 		= wrap_180(target_angle - dcm.yaw_sensor);
+	yaw_error 		= wrap_180(target_angle - dcm.yaw_sensor());
 
 	// limit the error we're feeding to the PID
 	yaw_error 		= constrain(yaw_error, -YAW_ERROR_MAX, YAW_ERROR_MAX);
@@ -146,9 +146,7 @@ static void reset_nav(void)
 	g.pi_nav_lon.reset_I();
 
 	circle_angle			= 0;
-	crosstrack_error 		= 0;
-	nav_lat 				= 0;
-	nav_lon 				= 0;
+	wp_nav.reset();
 	nav_roll 				= 0;
 	nav_pitch 				= 0;
 	target_bearing 			= 0;
@@ -170,13 +168,13 @@ get_nav_yaw_offset(int yaw_input, int reset)
 
 	if(reset == 0){
 		// we are on the ground
-		return dcm.yaw_sensor;
+		return dcm.yaw_sensor();
 
 	}else{
 		// re-define nav_yaw if we have stick input
 		if(yaw_input != 0){
 			// set nav_yaw + or - the current location
-			_yaw = yaw_input + dcm.yaw_sensor;
+			_yaw = yaw_input + dcm.yaw_sensor();
 			// we need to wrap our value so we can be 0 to 360 (*100)
 			return wrap_360(_yaw);
 
@@ -189,7 +187,7 @@ get_nav_yaw_offset(int yaw_input, int reset)
 
 static int get_angle_boost(int value)
 {
-	float temp = cos_pitch_x * cos_roll_x;
+	float temp = dcm.cos_pitch() * dcm.cos_roll();
 	temp = 1.0 - constrain(temp, .5, 1.0);
 	return (int)(temp * value);
 }
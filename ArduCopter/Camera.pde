@@ -19,7 +19,7 @@ camera_stabilization()
 	// -----
 	// allow control mixing
 	g.rc_camera_pitch.set_pwm(APM_RC.InputCh(CH_6)); // I'm using CH 6 input here.
-	g.rc_camera_pitch.servo_out = g.rc_camera_pitch.control_mix(dcm.pitch_sensor);
+	g.rc_camera_pitch.servo_out = g.rc_camera_pitch.control_mix(dcm.pitch_sensor());
 
 	g.rc_camera_pitch.servo_out	= (float)g.rc_camera_pitch.servo_out * g.camera_pitch_gain;
 
@@ -28,7 +28,7 @@ camera_stabilization()
 
 	// dont allow control mixing
 	/*
-	g.rc_camera_pitch.servo_out = dcm.pitch_sensor  * -1;
+	g.rc_camera_pitch.servo_out = dcm.pitch_sensor()  * -1;
 	*/
 
 
@@ -37,14 +37,14 @@ camera_stabilization()
 	// allow control mixing
 	/*
 	g.rc_camera_roll.set_pwm(APM_RC.InputCh(CH_6)); // I'm using CH 6 input here.
-	g.rc_camera_roll.servo_out = g.rc_camera_roll.control_mix(-dcm.roll_sensor);
+	g.rc_camera_roll.servo_out = g.rc_camera_roll.control_mix(-dcm.roll_sensor());
 	*/
 
 	// dont allow control mixing
-	g.rc_camera_roll.servo_out	= (float)-dcm.roll_sensor * g.camera_roll_gain;
+	g.rc_camera_roll.servo_out	= (float)-dcm.roll_sensor() * g.camera_roll_gain;
 
 	// limit
-	//g.rc_camera_roll.servo_out = constrain(-dcm.roll_sensor, -4500, 4500);
+	//g.rc_camera_roll.servo_out = constrain(-dcm.roll_sensor(), -4500, 4500);
 
 	// Output
 	// ------
@@ -38,9 +38,9 @@ static NOINLINE void send_attitude(mavlink_channel_t chan)
     mavlink_msg_attitude_send(
         chan,
         micros(),
-        dcm.roll,
-        dcm.pitch,
-        dcm.yaw,
+        dcm.roll(),
+        dcm.pitch(),
+        dcm.yaw(),
         omega.x,
         omega.y,
         omega.z);
@@ -112,11 +112,11 @@ static void NOINLINE send_nav_controller_output(mavlink_channel_t chan)
         nav_roll / 1.0e2,
         nav_pitch / 1.0e2,
         target_bearing / 1.0e2,
-        dcm.yaw_sensor / 1.0e2, // was target_bearing
+        dcm.yaw_sensor() / 1.0e2, // was target_bearing
         wp_distance,
         altitude_error / 1.0e2,
-        nav_lon,	// was 0
-        nav_lat);	// was 0
+        wp_nav.nav_lon,	// was 0
+        wp_nav.nav_lat);	// was 0
 }
 
 static void NOINLINE send_gps_raw(mavlink_channel_t chan)
@@ -207,7 +207,7 @@ static void NOINLINE send_vfr_hud(mavlink_channel_t chan)
         chan,
         (float)airspeed / 100.0,
         (float)g_gps->ground_speed / 100.0,
-        (dcm.yaw_sensor / 100) % 360,
+        (dcm.yaw_sensor() / 100) % 360,
         g.rc_3.servo_out/10,
         current_loc.alt / 100.0,
         climb_rate);
@@ -410,63 +410,384 @@ static bool mavlink_try_send_message(mavlink_channel_t chan, enum ap_message id,
 }
 
 
-#define MAX_DEFERRED_MESSAGES MSG_RETRY_DEFERRED
-static struct mavlink_queue {
-    enum ap_message deferred_messages[MAX_DEFERRED_MESSAGES];
-    uint8_t next_deferred_message;
-    uint8_t num_deferred_messages;
-} mavlink_queue[2];
+#if LOGGING_ENABLED == ENABLED
+/*
+  log download. LOG_REQUEST_LIST and LOG_REQUEST_DATA set up a
+  transfer, which mavlink_send_pending() then feeds from whatever
+  budget and tx space the link has left once the regular messages
+  have gone, so a download runs at the full link rate without holding
+  up anything else. LOG_DATA carries the raw DataFlash pages of a log,
+  page headers included, so the downloaded file is a page image that
+  Tools/LogDecode reads as is. A new LOG_REQUEST_DATA replaces the one
+  being served, which is how a GCS fills in anything it missed.
+
+  Reading the chip shares its buffers and file number with the writer,
+  so logging stops for the transfer, and a new log is started when the
+  GCS sends LOG_REQUEST_END or goes quiet.
+ */
+#define LOG_READ_NONE 0xFFFFFFFFUL
+
+static struct log_transfer {
+    bool        active;         // logging is stopped for a transfer
+    uint8_t     chan;           // channel being served
+    bool        listing;        // sending LOG_ENTRYs
+    bool        sending;        // sending LOG_DATA
+    uint16_t    num_logs;
+    uint16_t    list_next;      // next LOG_ENTRY to send
+    uint16_t    list_last;      // last LOG_ENTRY to send
+    uint16_t    log_id;         // log the fields below are for, 0 for none
+    uint16_t    start_page;     // its first page
+    uint32_t    size;           // its size in bytes
+    uint32_t    ofs;            // offset of the next LOG_DATA
+    uint32_t    end;            // offset the request ends at
+    uint32_t    read_ofs;       // offset of the next DataFlash.ReadByte()
+    uint32_t    last_ms;        // time of the last request or packet
+} log_transfer;
+
+// first page and size in bytes of a log
+static uint32_t mavlink_log_size(uint16_t log_num, uint16_t *start)
+{
+    int start_page, end_page;
+    uint16_t pages;
 
-// send a message using mavlink
-static void mavlink_send_message(mavlink_channel_t chan, enum ap_message id, uint16_t packet_drops)
+    get_log_boundaries(log_num, start_page, end_page);
+    if (end_page >= start_page) {
+        pages = end_page - start_page + 1;
+    } else {
+        // the log wraps around the end of the chip
+        pages = DF_LAST_PAGE - start_page + 1 + end_page;
+    }
+    *start = start_page;
+    return (uint32_t)pages * DataFlash.df_PageSize;
+}
+
+// start serving log requests on chan, stopping logging while we do
+static bool mavlink_log_begin(mavlink_channel_t chan)
 {
-    uint8_t i, nextid;
-    struct mavlink_queue *q = &mavlink_queue[(uint8_t)chan];
+    if (motor_armed) {
+        // never turn logging off in flight
+        return false;
+    }
+    if (!log_transfer.active) {
+        DataFlash.StopWrite();
+        log_transfer.num_logs = get_num_logs();
+        log_transfer.log_id = 0;
+    }
+    log_transfer.active = true;
+    log_transfer.chan = chan;
+    log_transfer.listing = false;
+    log_transfer.sending = false;
+    log_transfer.read_ofs = LOG_READ_NONE;
+    log_transfer.last_ms = millis();
+    return true;
+}
 
-    // see if we can send the deferred messages, if any
-    while (q->num_deferred_messages != 0) {
-        if (!mavlink_try_send_message(chan,
-                                      q->deferred_messages[q->next_deferred_message],
-                                      packet_drops)) {
-            break;
+// the GCS is done with the logs: go back to logging
+static void mavlink_log_end(void)
+{
+    if (!log_transfer.active) {
+        return;
+    }
+    log_transfer.active = false;
+    log_transfer.listing = false;
+    log_transfer.sending = false;
+    if (g.log_bitmask != 0) {
+        start_new_log();
+    }
+}
+
+static void mavlink_log_request_list(mavlink_channel_t chan, uint16_t start, uint16_t end)
+{
+    uint16_t first;
+
+    if (!mavlink_log_begin(chan)) {
+        return;
+    }
+    // num_logs is only known once the transfer has begun
+    first = g.log_last_filenumber - log_transfer.num_logs + 1;
+    if (log_transfer.num_logs == 0) {
+        // a single empty entry says there are no logs
+        start = end = 0;
+    } else {
+        if (start < first) {
+            start = first;
         }
-        q->next_deferred_message++;
-        if (q->next_deferred_message == MAX_DEFERRED_MESSAGES) {
-            q->next_deferred_message = 0;
+        if (end > g.log_last_filenumber) {
+            end = g.log_last_filenumber;
+        }
+        if (start > end) {
+            return;
         }
-        q->num_deferred_messages--;
     }
+    log_transfer.list_next = start;
+    log_transfer.list_last = end;
+    log_transfer.listing = true;
+}
 
-    if (id == MSG_RETRY_DEFERRED) {
+static void mavlink_log_request_data(mavlink_channel_t chan, uint16_t id, uint32_t ofs, uint32_t count)
+{
+    if (!mavlink_log_begin(chan)) {
         return;
     }
+    if (id > g.log_last_filenumber || id <= g.log_last_filenumber - log_transfer.num_logs) {
+        return;
+    }
+    if (id != log_transfer.log_id) {
+        log_transfer.size = mavlink_log_size(id, &log_transfer.start_page);
+        log_transfer.log_id = id;
+    }
+    log_transfer.ofs = ofs;
+    log_transfer.end = log_transfer.size;
+    if (ofs < log_transfer.size && count < log_transfer.size - ofs) {
+        log_transfer.end = ofs + count;
+    }
+    log_transfer.sending = true;
+}
 
-    // this message id might already be deferred
-    for (i=0, nextid = q->next_deferred_message; i < q->num_deferred_messages; i++) {
-        if (q->deferred_messages[nextid] == id) {
-            // its already deferred, discard
+/*
+  the byte at offset ofs of the log being sent. Reads carry on from
+  the last one where they can, as starting a read costs a page
+  transfer. The first four bytes of each page are its file number and
+  file page, which the library reads for us when it loads the page.
+ */
+static uint8_t mavlink_log_byte(uint32_t ofs)
+{
+    uint16_t page_size = DataFlash.df_PageSize;
+    uint16_t idx = ofs % page_size;
+    uint32_t page_ofs = ofs - idx;
+    uint16_t page = log_transfer.start_page + ofs / page_size;
+    uint8_t b;
+
+    if (page > DF_LAST_PAGE) {
+        page -= DF_LAST_PAGE;
+    }
+    if (DataFlash.GetPage() != page || log_transfer.read_ofs != max(ofs, page_ofs + 4)) {
+        DataFlash.StartRead(page);
+        log_transfer.read_ofs = page_ofs + 4;
+    }
+    if (idx < 4) {
+        uint16_t v = idx < 2 ? DataFlash.GetFileNumber() : DataFlash.GetFilePage();
+        return (idx & 1) ? (v & 0xFF) : (v >> 8);
+    }
+    while (log_transfer.read_ofs < ofs) {
+        DataFlash.ReadByte();
+        log_transfer.read_ofs++;
+    }
+    b = DataFlash.ReadByte();
+    log_transfer.read_ofs++;
+    if (idx == page_size - 1) {
+        // ReadByte() has moved on to the next page, past its header
+        log_transfer.read_ofs += 4;
+    }
+    return b;
+}
+
+static void NOINLINE send_log_entry(mavlink_channel_t chan)
+{
+    uint16_t id = log_transfer.list_next;
+    uint16_t start;
+    uint32_t size = 0;
+
+    if (id != 0) {
+        size = mavlink_log_size(id, &start);
+        // the boundary search moved the read
+        log_transfer.read_ofs = LOG_READ_NONE;
+    }
+    mavlink_msg_log_entry_send(
+        chan,
+        id,
+        log_transfer.num_logs,
+        g.log_last_filenumber,
+        size);
+}
+
+static void NOINLINE send_log_data(mavlink_channel_t chan, uint8_t count)
+{
+    uint8_t data[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN];
+
+    for (uint8_t i = 0; i < count; i++) {
+        data[i] = mavlink_log_byte(log_transfer.ofs + i);
+    }
+    memset(&data[count], 0, sizeof(data) - count);
+    mavlink_msg_log_data_send(
+        chan,
+        log_transfer.log_id,
+        log_transfer.ofs,
+        count,
+        data);
+}
+
+// send as much of the log transfer on chan as budget and the serial tx
+// buffer allow, taking what is sent off budget
+static void mavlink_log_send(mavlink_channel_t chan, uint16_t *budget)
+{
+    uint16_t length;
+
+    if (!log_transfer.active || log_transfer.chan != chan) {
+        return;
+    }
+
+    if (log_transfer.listing) {
+        // one entry at a time, as finding the boundaries of a log
+        // takes a few dozen page reads
+        length = MAVLINK_MSG_ID_LOG_ENTRY_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        if (length > *budget || comm_get_txspace(chan) < (int)length) {
             return;
         }
-        nextid++;
-        if (nextid == MAX_DEFERRED_MESSAGES) {
-            nextid = 0;
+        send_log_entry(chan);
+        *budget -= length;
+        log_transfer.last_ms = millis();
+        if (log_transfer.list_next++ == log_transfer.list_last) {
+            log_transfer.listing = false;
         }
+        return;
     }
 
-    if (q->num_deferred_messages != 0 ||
-        !mavlink_try_send_message(chan, id, packet_drops)) {
-        // can't send it now, so defer it
-        if (q->num_deferred_messages == MAX_DEFERRED_MESSAGES) {
-            // the defer buffer is full, discard
-            return;
+    length = MAVLINK_MSG_ID_LOG_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    while (log_transfer.sending &&
+           length <= *budget && comm_get_txspace(chan) >= (int)length) {
+        uint8_t count = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+
+        if (log_transfer.ofs >= log_transfer.end) {
+            // a zero length packet marks the end of the log, the end of
+            // a shorter request needs nothing
+            count = 0;
+            log_transfer.sending = false;
+            if (log_transfer.end < log_transfer.size) {
+                break;
+            }
+        } else if (log_transfer.end - log_transfer.ofs < count) {
+            count = log_transfer.end - log_transfer.ofs;
         }
-        nextid = q->next_deferred_message + q->num_deferred_messages;
-        if (nextid >= MAX_DEFERRED_MESSAGES) {
-            nextid -= MAX_DEFERRED_MESSAGES;
+        send_log_data(chan, count);
+        *budget -= length;
+        log_transfer.ofs += count;
+        log_transfer.last_ms = millis();
+    }
+}
+#endif // LOGGING_ENABLED
+
+
+/*
+  messages that can't go out straight away are remembered in a per
+  channel bitmask, so asking for the same message again before it has
+  been sent just sends the latest values once. Pending messages are
+  sent in the priority order below, for as long as they fit in both the
+  serial tx buffer and the bandwidth budget for the link. Bulk transfers
+  (parameters and waypoints) come last so they can't hold up attitude,
+  and on a slow link the lower rate streams simply thin out.
+ */
+static const struct mavlink_priority {
+    uint8_t id;                 // ap_message
+    uint8_t length;             // payload length
+} mavlink_priority[] PROGMEM = {
+    { MSG_HEARTBEAT,                MAVLINK_MSG_ID_HEARTBEAT_LEN },
+    { MSG_ATTITUDE,                 MAVLINK_MSG_ID_ATTITUDE_LEN },
+    { MSG_STATUSTEXT,               MAVLINK_MSG_ID_STATUSTEXT_LEN },
+    { MSG_RADIO_OUT,                MAVLINK_MSG_ID_SERVO_OUTPUT_RAW_LEN },
+    { MSG_LOCATION,                 MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN },
+    { MSG_VFR_HUD,                  MAVLINK_MSG_ID_VFR_HUD_LEN },
+    { MSG_EXTENDED_STATUS1,         MAVLINK_MSG_ID_SYS_STATUS_LEN },
+    { MSG_NAV_CONTROLLER_OUTPUT,    MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT_LEN },
+    { MSG_RADIO_IN,                 MAVLINK_MSG_ID_RC_CHANNELS_RAW_LEN },
+    { MSG_SERVO_OUT,                MAVLINK_MSG_ID_RC_CHANNELS_SCALED_LEN },
+    { MSG_GPS_RAW,                  MAVLINK_MSG_ID_GPS_RAW_LEN },
+    { MSG_GPS_STATUS,               MAVLINK_MSG_ID_GPS_STATUS_LEN },
+    { MSG_CURRENT_WAYPOINT,         MAVLINK_MSG_ID_WAYPOINT_CURRENT_LEN },
+    { MSG_EXTENDED_STATUS2,         MAVLINK_MSG_ID_MEMINFO_LEN },
+    { MSG_RAW_IMU1,                 MAVLINK_MSG_ID_RAW_IMU_LEN },
+    { MSG_RAW_IMU2,                 MAVLINK_MSG_ID_SCALED_PRESSURE_LEN },
+    { MSG_RAW_IMU3,                 MAVLINK_MSG_ID_SENSOR_OFFSETS_LEN },
+    { MSG_NEXT_WAYPOINT,            MAVLINK_MSG_ID_WAYPOINT_REQUEST_LEN },
+    { MSG_NEXT_PARAM,               MAVLINK_MSG_ID_PARAM_VALUE_LEN },
+};
+
+static struct mavlink_queue {
+    uint32_t pending;           // bitmask of ap_message IDs waiting to go
+    uint16_t budget;            // bytes the link can take right now
+    uint16_t last_refill_ms;    // when budget was last topped up
+} mavlink_queue[2];
+
+// link speed in bytes per second, 8N1 framing
+static uint16_t mavlink_link_rate(mavlink_channel_t chan)
+{
+    uint32_t baud = map_baudrate(g.serial3_baud, SERIAL3_BAUD);
+
+#if USB_MUX_PIN > 0
+    // UART0 runs at the console rate when USB is plugged in
+    if (chan == MAVLINK_COMM_0 && usb_connected) {
+        baud = SERIAL0_BAUD;
+    }
+#else
+    if (chan == MAVLINK_COMM_0) {
+        baud = SERIAL0_BAUD;
+    }
+#endif
+    return baud / 10;
+}
+
+// top up the bandwidth budget for the time since we last looked,
+// allowing up to 50ms worth of bytes to build up. On a slow link that
+// is less than the longest message, which would then never fit, so
+// the budget can always grow to at least one packet of any length
+static void mavlink_refill_budget(mavlink_channel_t chan)
+{
+    struct mavlink_queue *q = &mavlink_queue[(uint8_t)chan];
+    uint16_t now = millis();
+    uint16_t rate = mavlink_link_rate(chan);
+    uint16_t cap = max(rate / 20, MAVLINK_MAX_PACKET_LEN);
+    uint32_t budget;
+
+    budget = q->budget + ((uint32_t)(uint16_t)(now - q->last_refill_ms) * rate) / 1000;
+    if (budget > cap) {
+        budget = cap;
+    }
+    q->budget = budget;
+    q->last_refill_ms = now;
+}
+
+// send pending messages in priority order, for as long as they fit
+static void mavlink_send_pending(mavlink_channel_t chan, uint16_t packet_drops)
+{
+    struct mavlink_queue *q = &mavlink_queue[(uint8_t)chan];
+
+    mavlink_refill_budget(chan);
+
+    for (uint8_t i = 0; q->pending != 0 && i < sizeof(mavlink_priority)/sizeof(mavlink_priority[0]); i++) {
+        uint8_t id = pgm_read_byte((const prog_char *)&mavlink_priority[i].id);
+        uint16_t length;
+
+        if (!(q->pending & (1UL << id))) {
+            continue;
         }
-        q->deferred_messages[nextid] = id;
-        q->num_deferred_messages++;
+        length = pgm_read_byte((const prog_char *)&mavlink_priority[i].length) + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+
+        // stop at the first message that doesn't fit, so a steady
+        // stream of small messages can't starve a bigger, more
+        // important one
+        if (length > q->budget ||
+            !mavlink_try_send_message(chan, (enum ap_message)id, packet_drops)) {
+            break;
+        }
+        q->pending &= ~(1UL << id);
+        q->budget -= length;
+    }
+
+#if LOGGING_ENABLED == ENABLED
+    // a log download gets whatever is left over
+    if (q->pending == 0) {
+        mavlink_log_send(chan, &q->budget);
     }
+#endif
+}
+
+// send a message using mavlink
+static void mavlink_send_message(mavlink_channel_t chan, enum ap_message id, uint16_t packet_drops)
+{
+    if (id != MSG_RETRY_DEFERRED) {
+        mavlink_queue[(uint8_t)chan].pending |= (1UL << id);
+    }
+    mavlink_send_pending(chan, packet_drops);
 }
 
 void mavlink_send_text(mavlink_channel_t chan, gcs_severity severity, const char *str)
@@ -530,24 +851,30 @@ GCS_MAVLINK::init(FastSerial * port)
 	_queued_parameter = NULL;
 }
 
-void
-GCS_MAVLINK::update(void)
+uint8_t
+GCS_MAVLINK::_handle_message(void *gcs, mavlink_message_t *msg, uint16_t used)
 {
-	// receive new packets
-	mavlink_message_t msg;
-	mavlink_status_t status;
-	status.packet_rx_drop_count = 0;
+    GCS_MAVLINK *g = (GCS_MAVLINK *)gcs;
+
+    mavlink_active = true;
+    g->_rx_used = used;
+    g->handleMessage(msg);
+
+    // stop if a nested update has taken over the rest of the block
+    return !g->_rx_released;
+}
 
-	// process received bytes
-	while(comm_get_available(chan))
-	{
-		uint8_t c = comm_receive_ch(chan);
+void
+GCS_MAVLINK::receive_bytes(const uint8_t *buf, uint16_t len)
+{
+    mavlink_status_t status;
 
 #if CLI_ENABLED == ENABLED
-        /* allow CLI to be started by hitting enter 3 times, if no
-           heartbeat packets have been received */
-        if (mavlink_active == false) {
-            if (c == '\n' || c == '\r') {
+    /* allow CLI to be started by hitting enter 3 times, if no
+       heartbeat packets have been received */
+    if (mavlink_active == false) {
+        for (uint16_t i = 0; i < len; i++) {
+            if (buf[i] == '\n' || buf[i] == '\r') {
                 crlf_count++;
             } else {
                 crlf_count = 0;
@@ -556,23 +883,72 @@ GCS_MAVLINK::update(void)
                 run_cli();
             }
         }
+    }
 #endif
 
-		// Try to get a new message
-        if (mavlink_parse_char(chan, c, &msg, &status)) {
-            mavlink_active = true;
-            handleMessage(&msg);
+    // Try to get new messages
+    status.packet_rx_drop_count = 0;
+    mavlink_parse_buffer(chan, buf, len, &status, _handle_message, this);
+
+    // Update packet drops counter
+    packet_drops += status.packet_rx_drop_count;
+}
+
+void
+GCS_MAVLINK::update(void)
+{
+    const uint8_t *buf;
+    uint16_t nbytes;
+    bool released = _rx_released;
+
+    if (_rx_in_block) {
+        // called from mavlink_delay() while a message in the middle of
+        // a block is handled. Release the block up to the end of that
+        // message, so that what follows it is parsed here and the outer
+        // update stops
+        comm_receive_done(chan, _rx_used);
+        _rx_in_block = false;
+        released = true;
+    }
+
+    // process received bytes a block at a time, straight out of the
+    // serial receive buffer
+    while ((buf = comm_receive_block(chan, &nbytes)) != NULL && nbytes != 0) {
+        _rx_in_block = true;
+        _rx_released = false;
+        receive_bytes(buf, nbytes);
+        if (_rx_in_block) {
+            _rx_in_block = false;
+            comm_receive_done(chan, nbytes);
         }
-	}
+    }
+    _rx_released = released;
 
-	// Update packet drops counter
-	packet_drops += status.packet_rx_drop_count;
+    // ports that can't lend out their buffer go a byte at a time
+    if (buf == NULL) {
+        while (comm_get_available(chan)) {
+            uint8_t c = comm_receive_ch(chan);
+            receive_bytes(&c, 1);
+        }
+    }
 
     // send out queued params/ waypoints
     if (NULL != _queued_parameter) {
         send_message(MSG_NEXT_PARAM);
     }
 
+#if LOGGING_ENABLED == ENABLED
+    // keep a log download going, or end it if the GCS has gone away
+    if (log_transfer.active && log_transfer.chan == chan) {
+        if (!log_transfer.listing && !log_transfer.sending &&
+            millis() - log_transfer.last_ms > LOG_TRANSFER_TIMEOUT) {
+            mavlink_log_end();
+        } else {
+            send_message(MSG_RETRY_DEFERRED);
+        }
+    }
+#endif
+
     if (!waypoint_receiving && !waypoint_sending) {
         return;
     }
@@ -1171,6 +1547,35 @@ void GCS_MAVLINK::handleMessage(mavlink_message_t* msg)
 			break;
 		}
 
+#if LOGGING_ENABLED == ENABLED
+    case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+    {
+        mavlink_log_request_list_t packet;
+        mavlink_msg_log_request_list_decode(msg, &packet);
+        if (mavlink_check_target(packet.target_system,packet.target_component)) break;
+        mavlink_log_request_list(chan, packet.start, packet.end);
+        break;
+    }
+
+    case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+    {
+        mavlink_log_request_data_t packet;
+        mavlink_msg_log_request_data_decode(msg, &packet);
+        if (mavlink_check_target(packet.target_system,packet.target_component)) break;
+        mavlink_log_request_data(chan, packet.id, packet.ofs, packet.count);
+        break;
+    }
+
+    case MAVLINK_MSG_ID_LOG_REQUEST_END:
+    {
+        mavlink_log_request_end_t packet;
+        mavlink_msg_log_request_end_decode(msg, &packet);
+        if (mavlink_check_target(packet.target_system,packet.target_component)) break;
+        mavlink_log_end();
+        break;
+    }
+#endif
+
 #ifdef MAVLINK_MSG_ID_SET_MAG_OFFSETS
     case MAVLINK_MSG_ID_SET_MAG_OFFSETS:
     {
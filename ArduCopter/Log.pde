@@ -9,6 +9,80 @@
 #define HEAD_BYTE2 	0x95	// Decimal 149
 #define END_BYTE	0xBA	// Decimal 186
 
+#if FRAME_CONFIG == HEXA_FRAME || FRAME_CONFIG == Y6_FRAME
+ #define LOG_MOTORS_FORMAT	"hhhhhh"
+ #define LOG_MOTORS_LABELS	"Mot1,Mot2,Mot3,Mot4,Mot5,Mot6"
+#elif FRAME_CONFIG == OCTA_FRAME || FRAME_CONFIG == OCTA_QUAD_FRAME
+ #define LOG_MOTORS_FORMAT	"hhhhhhhh"
+ #define LOG_MOTORS_LABELS	"Mot1,Mot2,Mot3,Mot4,Mot5,Mot6,Mot7,Mot8"
+#elif FRAME_CONFIG == HELI_FRAME
+ #define LOG_MOTORS_FORMAT	"hhhhh"
+ #define LOG_MOTORS_LABELS	"Servo1,Servo2,Servo3,Servo4,GyrGain"
+#else // quads, TRIs
+ #define LOG_MOTORS_FORMAT	"hhhh"
+ #define LOG_MOTORS_LABELS	"Mot1,Mot2,Mot3,Mot4"
+#endif
+
+// The format of each message the Log_Write_ functions below write, see
+// struct Log_Format in DataFlash.h. The lengths and formats must match
+// what the functions write. The table is written at the start of every
+// log, and is what the CLI dump uses to print the packets.
+static const struct Log_Format log_formats[] PROGMEM = {
+	{ LOG_ATTITUDE_MSG,			12,	"ATT",	"hhHhhh",
+	  "Roll,Pitch,Yaw,RollOut,PitchOut,YawOut" },
+	{ LOG_GPS_MSG,				25,	"GPS",	"IBLLeehH",
+	  "Time,NSats,Lat,Lng,Alt,GPSAlt,Spd,Crs" },
+	{ LOG_MODE_MSG,				3,	"MODE",	"Mh",
+	  "Mode,ThrCrs" },
+	{ LOG_CONTROL_TUNING_MSG,	28,	"CTUN",	"hhhhhhhhhhhhhh",
+	  "InR,InP,InT,InY,Son,Baro,WPA,NThr,AngB,ManB,Clmb,TOut,AltI,ThrI" },
+	{ LOG_NAV_TUNING_MSG,		21,	"NTUN",	"hhhhhhhhhhB",
+	  "Dist,TBrg,LngErr,LatErr,NLng,NLat,NLngI,NLatI,LLngI,LLatI,WPCtl" },
+	{ LOG_PERFORMANCE_MSG,		13,	"PM",	"IBBBBBHH",
+	  "Time,GyrSat,AdcCon,RenSqrt,RenBlow,GPSFix,DFDrop,SchOvr" },
+	{ LOG_RAW_MSG,				24,	"RAW",	"LLLLLL",
+	  "GyrX,GyrY,GyrZ,AccX,AccY,AccZ" },
+	{ LOG_CMD_MSG,				17,	"CMD",	"BBBBBiii",
+	  "Total,Num,Id,Opt,P1,Alt,Lat,Lng" },
+	{ LOG_CURRENT_MSG,			12,	"CURR",	"hicch",
+	  "Thr,ThrInt,Volt,Curr,CurrTot" },
+	{ LOG_STARTUP_MSG,			0,	"STRT",	"",
+	  "" },
+	{ LOG_MOTORS_MSG,			2 * (sizeof(LOG_MOTORS_FORMAT) - 1),	"MOT",	LOG_MOTORS_FORMAT,
+	  LOG_MOTORS_LABELS },
+	{ LOG_OPTFLOW_MSG,			14,	"OF",	"hhhii",
+	  "Dx,Dy,SQual,VLat,VLon" },
+	{ LOG_DATA_MSG,				5,	"DATA",	"bi",
+	  "Type,Value" },
+	{ LOG_COMPASS_MSG,			14,	"MAG",	"hhhhhhc",
+	  "MagX,MagY,MagZ,OfsX,OfsY,OfsZ,Dec" }
+};
+
+// The message types that can be written as deltas, see LOG_DELTA_FLAG
+// in DataFlash.h, and their slot in the delta state of the writer and
+// of the reader
+#define LOG_DELTA_TYPES	3
+
+static int8_t Log_Delta_Slot(byte type)
+{
+	switch (type) {
+		case LOG_ATTITUDE_MSG:	return 0;
+		case LOG_RAW_MSG:		return 1;
+		case LOG_MOTORS_MSG:	return 2;
+	}
+	return -1;
+}
+
+#if LOG_COMPRESS == ENABLED
+// One record in LOG_DELTA_KEYFRAME of each type is written in full, so
+// that a reader that loses its place picks it up again within a second
+// or so at the usual rates
+#define LOG_DELTA_KEYFRAME	50
+
+static struct Log_Delta	log_delta[LOG_DELTA_TYPES];
+static uint16_t			log_delta_dropped;	// DataFlash.GetDropped() at the last record
+#endif
+
 
 // These are function definitions so the Menu can be constructed before the functions
 // are defined below. Order matters to the compiler.
@@ -46,16 +120,22 @@ const struct Menu::command log_menu_commands[] PROGMEM = {
 // A Macro to create the Menu
 MENU2(log_menu, "Log", log_menu_commands, print_log_menu);
 
-static void get_log_boundaries(byte log_num, int & start_page, int & end_page);
+static void get_log_boundaries(uint16_t log_num, int & start_page, int & end_page);
+
+// the log directory, see log_dir_load()
+#define LOG_DIR_MAGIC	0x4C44		// "LD"
+#define LOG_DIR_LOGS	32			// the most logs it lists
+
+static bool		log_writing;		// start_new_log() has started the writer
+static uint16_t	log_search_end;		// end of the newest log found by log_end_page(), 0 before the search
 
 static bool
 print_log_menu(void)
 {
-	int log_start;
-	int log_end;
-	int temp;
+	uint16_t log_start[LOG_DIR_LOGS];
+	uint16_t log_end;
 
-	uint16_t num_logs = get_num_logs();
+	uint8_t num_logs = log_dir_load(log_start, &log_end);
 
 	Serial.printf_P(PSTR("logs enabled: "));
 
@@ -73,6 +153,7 @@ print_log_menu(void)
 		if (g.log_bitmask & MASK_LOG_CUR)			Serial.printf_P(PSTR(" CURRENT"));
 		if (g.log_bitmask & MASK_LOG_MOTORS)		Serial.printf_P(PSTR(" MOTORS"));
 		if (g.log_bitmask & MASK_LOG_OPTFLOW)		Serial.printf_P(PSTR(" OPTFLOW"));
+		if (g.log_bitmask & MASK_LOG_COMPASS)		Serial.printf_P(PSTR(" COMPASS"));
 	}
 
 	Serial.println();
@@ -82,15 +163,11 @@ print_log_menu(void)
 	}else{
 		Serial.printf_P(PSTR("\n%d logs\n"), num_logs);
 
-		for(int i=num_logs;i>=1;i--) {
-            int last_log_start = log_start, last_log_end = log_end;
-			temp = g.log_last_filenumber-i+1;
-			get_log_boundaries(temp, log_start, log_end);
-			Serial.printf_P(PSTR("Log %d,    start %d,   end %d\n"), temp, log_start, log_end);
-            if (last_log_start == log_start && last_log_end == log_end) {
-                // we are printing bogus logs
-                break;
-            }
+		for(int i=0;i<num_logs;i++) {
+			Serial.printf_P(PSTR("Log %d,    start %d,   end %d\n"),
+							g.log_last_filenumber-num_logs+i+1,
+							log_start[i],
+							i == num_logs-1 ? log_end : log_prev_page(log_start[i+1]));
 		}
 		Serial.println();
 	}
@@ -103,7 +180,7 @@ dump_log(uint8_t argc, const Menu::arg *argv)
 	int dump_log;
 	int dump_log_start;
 	int dump_log_end;
-	byte last_log_num;
+	int last_log_num;
 
 	// check that the requested log number can be read
 	dump_log = argv[1].i;
@@ -133,15 +210,16 @@ erase_logs(uint8_t argc, const Menu::arg *argv)
 {
 	Serial.printf_P(PSTR("\nErasing log...\n"));
 	DataFlash.SetFileNumber(0xFFFF);
-	for(int j = 1; j <= DF_LAST_PAGE; j++) {
+	for(int j = 1; j < DF_NUM_PAGES; j++) {		// the logs and the log directory
 		DataFlash.PageErase(j);
 		DataFlash.StartWrite(j);		// We need this step to clean FileNumbers
 		if(j%128 == 0) Serial.printf_P(PSTR("+"));
 	}
 	g.log_last_filenumber.set_and_save(0);
+	log_search_end = 0;
 
 	Serial.printf_P(PSTR("\nLog erased.\n"));
-	DataFlash.FinishWrite();
+	DataFlash.StopWrite();
     return 0;
 }
 
@@ -179,6 +257,7 @@ select_logs(uint8_t argc, const Menu::arg *argv)
 		TARG(CUR);
 		TARG(MOTORS);
 		TARG(OPTFLOW);
+		TARG(COMPASS);
 		#undef TARG
 	}
 
@@ -200,102 +279,194 @@ process_logs(uint8_t argc, const Menu::arg *argv)
 
 
 
-// This function determines the number of whole or partial log files in the DataFlash
-// Wholly overwritten files are (of course) lost.
-static byte get_num_logs(void)
+// The log directory lives in the DF_DIR_PAGES pages after DF_LAST_PAGE.
+// Each copy lists the start pages of the logs on the chip, oldest first,
+// so that finding a log takes a page read instead of searches over the
+// whole chip. start_new_log() writes a new copy for each log, into the
+// page picked by the log's number, which spreads the writes over all of
+// the directory pages.
+//
+// A log ends on the page before the next one starts. The end of the
+// newest log comes from the writer once logging has started, and from a
+// search of that log's own pages before then.
+
+// page holding the directory written when log_num was started
+static uint16_t log_dir_page(uint16_t log_num)
 {
-	uint16_t lastpage;
-	uint16_t last;
-	uint16_t first;
+	return DF_DIR_PAGE + log_num % DF_DIR_PAGES;
+}
 
-	if(g.log_last_filenumber < 1) return 0;
+// the page before page, wrapping around the log pages
+static uint16_t log_prev_page(uint16_t page)
+{
+	return page > 1 ? page - 1 : DF_LAST_PAGE;
+}
 
-	DataFlash.StartRead(1);
+// the number of pages from start to end, wrapping around the log pages
+static uint16_t log_pages(uint16_t start, uint16_t end)
+{
+	if (end >= start) {
+		return end - start + 1;
+	}
+	return DF_LAST_PAGE - start + 1 + end;
+}
 
-	if(DataFlash.GetFileNumber() == 0XFFFF) return 0;
+// This function finds the last page of the newest log, given its first page
+static uint16_t log_end_page(uint16_t start)
+{
+	uint16_t end;
 
-	lastpage = find_last();
-	DataFlash.StartRead(lastpage);
-	last = DataFlash.GetFileNumber();
-	DataFlash.StartRead(lastpage + 2);
-	first = DataFlash.GetFileNumber();
-	if(first > last) {
-		DataFlash.StartRead(1);
-		first = DataFlash.GetFileNumber();
-	}
-	if(last == first)
-	{
-		return 1;
+	if (log_writing) {
+		end = log_prev_page(DataFlash.GetWritePage());
 	} else {
-		return (last - first + 1);
+		if (log_search_end == 0) {
+			// the pages of the newest log hold its number and the
+			// count of pages since its start, up to where it ends
+			uint16_t bottom = 0;
+			uint16_t top = DF_LAST_PAGE;
+			uint16_t look;
+
+			while (top - bottom > 1) {
+				look = (top + bottom) / 2;
+				DataFlash.StartRead((start - 1 + look) % DF_LAST_PAGE + 1);
+				if (DataFlash.GetFileNumber() == (uint16_t)g.log_last_filenumber &&
+					DataFlash.GetFilePage() == look + 1) {
+					bottom = look;
+				} else {
+					top = look;
+				}
+			}
+			log_search_end = (start - 1 + bottom) % DF_LAST_PAGE + 1;
+		}
+		end = log_search_end;
 	}
+	if (end == log_prev_page(start)) {
+		// nothing of it has been written out yet
+		end = start;
+	}
+	return end;
+}
+
+// This function reads the log directory into start[], oldest log first,
+// leaving out the logs the newer ones have since written over, and
+// returns the number of logs. end is set to the last page of the newest log.
+static uint8_t log_dir_load(uint16_t *start, uint16_t *end)
+{
+	uint8_t n, first;
+	uint16_t pages;
+
+	if (g.log_last_filenumber < 1) return 0;
+
+	// the directory can't be read while the log is being written
+	if (!DataFlash.StartRead(log_dir_page(g.log_last_filenumber)) ||
+		DataFlash.GetFileNumber() != 0 ||
+		(uint16_t)DataFlash.ReadInt() != LOG_DIR_MAGIC ||
+		DataFlash.ReadInt() != g.log_last_filenumber) {
+		return 0;
+	}
+	pages = DataFlash.ReadInt();
+	if (pages == 0 || pages > LOG_DIR_LOGS) return 0;
+	n = pages;
+	for (uint8_t i = 0; i < n; i++) {
+		start[i] = DataFlash.ReadInt();
+		if (start[i] < 1 || start[i] > DF_LAST_PAGE) return 0;
+	}
+	*end = log_end_page(start[n-1]);
+
+	// go back from the newest log until the logs after one cover the chip
+	first = n - 1;
+	pages = log_pages(start[first], *end);
+	while (first > 0 && pages < DF_LAST_PAGE) {
+		first--;
+		pages += log_pages(start[first], log_prev_page(start[first+1]));
+	}
+	if (pages > DF_LAST_PAGE) {
+		// the oldest log has lost its first pages
+		start[first] = *end % DF_LAST_PAGE + 1;
+	}
+	n -= first;
+	memmove(start, &start[first], n * sizeof(start[0]));
+	return n;
+}
+
+// This function writes a new copy of the log directory, for the newest log
+static void log_dir_write(const uint16_t *start, uint8_t n)
+{
+	DataFlash.SetFileNumber(0);		// not a log, so nothing reads it as one
+	DataFlash.StartWrite(log_dir_page(g.log_last_filenumber));
+	DataFlash.WriteInt(LOG_DIR_MAGIC);
+	DataFlash.WriteInt(g.log_last_filenumber);
+	DataFlash.WriteInt(n);
+	for (uint8_t i = 0; i < n; i++) {
+		DataFlash.WriteInt(start[i]);
+	}
+	DataFlash.StopWrite();
+}
+
+// This function determines the number of whole or partial log files in the DataFlash
+// Wholly overwritten files are (of course) lost.
+static byte get_num_logs(void)
+{
+	uint16_t start[LOG_DIR_LOGS];
+	uint16_t end;
+
+	return log_dir_load(start, &end);
 }
 
 // This function starts a new log file in the DataFlash
 static void start_new_log()
 {
-	uint16_t	last_page = find_last();
-	if(last_page == 1) last_page = 0;
-	
+	uint16_t start[LOG_DIR_LOGS];
+	uint16_t end;
+	uint8_t n;
+
+	n = log_dir_load(start, &end);
+	if (n == 0) {
+		// no directory, as after erasing the logs or loading this
+		// code; start after whatever is on the chip
+		end = find_last();
+		if(end == 1) end = DF_LAST_PAGE;
+	} else if (n == LOG_DIR_LOGS) {
+		// the directory is full, forget the oldest log
+		n--;
+		memmove(start, &start[1], n * sizeof(start[0]));
+	}
+	start[n++] = end % DF_LAST_PAGE + 1;
+
 	g.log_last_filenumber.set_and_save(g.log_last_filenumber+1);
+	log_dir_write(start, n);
+	log_writing = true;
+
 	DataFlash.SetFileNumber(g.log_last_filenumber);
-	DataFlash.StartWrite(last_page + 1);
+	DataFlash.StartWrite(start[n-1]);
+	Log_Write_Formats();
+#if LOG_COMPRESS == ENABLED
+	// each log starts with keyframes
+	memset(log_delta, 0, sizeof(log_delta));
+#endif
 }
 
 // This function finds the first and last pages of a log file
 // The first page may be greater than the last page if the DataFlash has been filled and partially overwritten.
-static void get_log_boundaries(byte log_num, int & start_page, int & end_page)
+static void get_log_boundaries(uint16_t log_num, int & start_page, int & end_page)
 {
-	int num = get_num_logs();
-	int look;
-
-	if(num == 1)
-	{
-		DataFlash.StartRead(DF_LAST_PAGE);
-		if(DataFlash.GetFileNumber() == 0xFFFF)
-		{
-			start_page = 1;
-			end_page = find_last_log_page((uint16_t)log_num);
-		} else {
-			end_page = find_last_log_page((uint16_t)log_num);
-			start_page = end_page + 1;
-		}
-
+	uint16_t start[LOG_DIR_LOGS];
+	uint16_t end;
+	uint8_t n;
+	int i;
+
+	n = log_dir_load(start, &end);
+	i = n - 1 - (g.log_last_filenumber - log_num);
+	if (i < 0 || i >= n) {
+		// not a log we have
+		start_page = end_page = 1;
 	} else {
-		if(log_num==1) {
-			DataFlash.StartRead(DF_LAST_PAGE);
-			if(DataFlash.GetFileNumber() == 0xFFFF) {
-				start_page = 1;
-			} else {
-				start_page = find_last() + 1;
-			}
-		 } else {
-			if(log_num == g.log_last_filenumber - num + 1) {
-				start_page = find_last() + 1;
-			} else {
-				look = log_num-1;
-				do {
-				start_page = find_last_log_page(look) + 1;
-				look--;
-				} while (start_page <= 0);
-			}
-		}
+		start_page = start[i];
+		end_page = (i == n - 1) ? end : log_prev_page(start[i+1]);
 	}
-	if(start_page == DF_LAST_PAGE+1 || start_page == 0) start_page=1;
-	end_page = find_last_log_page((uint16_t)log_num);
-	if(end_page <= 0) end_page = start_page;
 }
 
-static bool check_wrapped(void)
-{
-	DataFlash.StartRead(DF_LAST_PAGE);
-	if(DataFlash.GetFileNumber() == 0xFFFF)
-		return 0;
-	else
-		return 1;
-}
-
-// This function finds the last page of the last file
+// This function finds the last page of the last file, for when there is no log directory
 static int find_last(void)
 {
 uint16_t look;
@@ -336,60 +507,6 @@ uint32_t top_hash;
 		}
 }
 
-// This function finds the last page of a particular log file
-static int find_last_log_page(uint16_t log_number)
-{
-
-uint16_t look;
-uint16_t bottom;
-uint16_t top;
-uint32_t look_hash;
-uint32_t check_hash;
-
-	if(check_wrapped())
-	{
-		DataFlash.StartRead(1);
-		bottom = DataFlash.GetFileNumber();
-		if (bottom > log_number)
-		{
-			bottom = find_last();
-			top = DF_LAST_PAGE;
-		} else {
-			bottom = 1;
-			top = find_last();
-		}
-	} else {
-		bottom = 1;
-		top = find_last();
-	}
-
-	check_hash = (long)log_number<<16 | 0xFFFF;
-
-	while(top-bottom > 1)
-	{
-		look = (top+bottom)/2;
-		DataFlash.StartRead(look);
-		look_hash = (long)DataFlash.GetFileNumber()<<16 | DataFlash.GetFilePage();
-		if (look_hash >= 0xFFFF0000) look_hash = 0;
-
-		if(look_hash > check_hash) {
-			// move down
-			top = look;
-		} else {
-			// move up
-			bottom = look;
-		}
-	}
-
-	DataFlash.StartRead(top);
-	if (DataFlash.GetFileNumber() == log_number) return top;
-
-	DataFlash.StartRead(bottom);
-	if (DataFlash.GetFileNumber() == log_number) return bottom;
-
-	return -1;
-}
-
 
 
 // Write an GPS packet. Total length : 30 bytes
@@ -413,30 +530,6 @@ static void Log_Write_GPS()
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read a GPS packet
-static void Log_Read_GPS()
-{
-	int32_t temp1 	= DataFlash.ReadLong();			// 1 time
-	int8_t temp2 	= DataFlash.ReadByte();			// 2 sats
-	float temp3 	= DataFlash.ReadLong() / t7;	// 3 lat
-	float temp4 	= DataFlash.ReadLong() / t7;	// 4 lon
-	float temp5 	= DataFlash.ReadLong() / 100.0;	// 5 gps alt
-	float temp6 	= DataFlash.ReadLong() / 100.0;	// 6 sensor alt
-	int16_t temp7 	= DataFlash.ReadInt();			// 7 ground speed
-	uint32_t temp8 	= (unsigned)DataFlash.ReadInt();// 8 ground course
-
-							//  1   2    3      4     5      6      7    8
-	Serial.printf_P(PSTR("GPS, %ld, %d, %4.7f, %4.7f, %4.4f, %4.4f, %d, %u\n"),
-							temp1,		// 1 time
-							temp2,		// 2 sats
-							temp3,		// 3 lat
-							temp4,		// 4 lon
-							temp5,		// 5 gps alt
-							temp6,		// 6 sensor alt
-							temp7,		// 7 ground speed
-							temp8);		// 8 ground course
-}
-
 // Write an raw accel/gyro data packet. Total length : 28 bytes
 #if HIL_MODE != HIL_MODE_ATTITUDE
 static void Log_Write_Raw()
@@ -445,44 +538,36 @@ static void Log_Write_Raw()
 	Vector3f accel = imu.get_accel();
 	//Vector3f accel_filt	= imu.get_accel_filtered();
 
+	int32_t v[6];
+
 	gyro *= t7;								// Scale up for storage as long integers
 	accel *= t7;
 	//accel_filt *= t7;
 
-	DataFlash.WriteByte(HEAD_BYTE1);
-	DataFlash.WriteByte(HEAD_BYTE2);
-	DataFlash.WriteByte(LOG_RAW_MSG);
-
-	DataFlash.WriteLong(gyro.x);
-	DataFlash.WriteLong(gyro.y);
-	DataFlash.WriteLong(gyro.z);
+	v[0] = gyro.x;
+	v[1] = gyro.y;
+	v[2] = gyro.z;
 
+	//v[3] = accels_rot.x * t7;
+	//v[4] = accels_rot.y * t7;
+	//v[5] = accels_rot.z * t7;
 
-	//DataFlash.WriteLong(accels_rot.x * t7);
-	//DataFlash.WriteLong(accels_rot.y * t7);
-	//DataFlash.WriteLong(accels_rot.z * t7);
+	v[3] = accel.x;
+	v[4] = accel.y;
+	v[5] = accel.z;
 
-	DataFlash.WriteLong(accel.x);
-	DataFlash.WriteLong(accel.y);
-	DataFlash.WriteLong(accel.z);
+	if (Log_Write_Delta(LOG_RAW_MSG, v, 6)) return;
 
+	DataFlash.WriteByte(HEAD_BYTE1);
+	DataFlash.WriteByte(HEAD_BYTE2);
+	DataFlash.WriteByte(LOG_RAW_MSG);
+	for (uint8_t i = 0; i < 6; i++) {
+		DataFlash.WriteLong(v[i]);
+	}
 	DataFlash.WriteByte(END_BYTE);
 }
 #endif
 
-// Read a raw accel/gyro packet
-static void Log_Read_Raw()
-{
-	float logvar;
-	Serial.printf_P(PSTR("RAW,"));
-	for (int y = 0; y < 6; y++) {
-		logvar = (float)DataFlash.ReadLong() / t7;
-		Serial.print(logvar);
-		Serial.print(comma);
-	}
-	Serial.println(" ");
-}
-
 static void Log_Write_Current()
 {
 	DataFlash.WriteByte(HEAD_BYTE1);
@@ -498,148 +583,69 @@ static void Log_Write_Current()
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read a Current packet
-static void Log_Read_Current()
-{
-	int16_t temp1 = DataFlash.ReadInt();			// 1
-	int32_t	temp2 = DataFlash.ReadLong();			// 2
-	float 	temp3 = DataFlash.ReadInt() / 100.f;	// 3
-	float 	temp4 = DataFlash.ReadInt() / 100.f;	// 4
-	int16_t temp5 = DataFlash.ReadInt();			// 5
-
-							//  1    2    3      4      5
-	Serial.printf_P(PSTR("CURR, %d, %ld, %4.4f, %4.4f, %d\n"),
-		temp1,
-		temp2,
-		temp3,
-		temp4,
-		temp5);
-}
-
 static void Log_Write_Motors()
 {
-	DataFlash.WriteByte(HEAD_BYTE1);
-	DataFlash.WriteByte(HEAD_BYTE2);
-	DataFlash.WriteByte(LOG_MOTORS_MSG);
+	int32_t v[sizeof(LOG_MOTORS_FORMAT) - 1];
+	uint8_t n = 0;
 
 	#if FRAME_CONFIG ==	TRI_FRAME
-	DataFlash.WriteInt(motor_out[CH_1]);//1
-	DataFlash.WriteInt(motor_out[CH_2]);//2
-	DataFlash.WriteInt(motor_out[CH_4]);//3
-	DataFlash.WriteInt(g.rc_4.radio_out);//4
+	v[n++] = motor_out[CH_1];//1
+	v[n++] = motor_out[CH_2];//2
+	v[n++] = motor_out[CH_4];//3
+	v[n++] = g.rc_4.radio_out;//4
 
 	#elif FRAME_CONFIG == HEXA_FRAME
-	DataFlash.WriteInt(motor_out[CH_1]);//1
-	DataFlash.WriteInt(motor_out[CH_2]);//2
-	DataFlash.WriteInt(motor_out[CH_3]);//3
-	DataFlash.WriteInt(motor_out[CH_4]);//4
-	DataFlash.WriteInt(motor_out[CH_7]);//5
-	DataFlash.WriteInt(motor_out[CH_8]);//6
+	v[n++] = motor_out[CH_1];//1
+	v[n++] = motor_out[CH_2];//2
+	v[n++] = motor_out[CH_3];//3
+	v[n++] = motor_out[CH_4];//4
+	v[n++] = motor_out[CH_7];//5
+	v[n++] = motor_out[CH_8];//6
 
 	#elif FRAME_CONFIG == Y6_FRAME
 	//left
-	DataFlash.WriteInt(motor_out[CH_2]);//1
-	DataFlash.WriteInt(motor_out[CH_3]);//2
+	v[n++] = motor_out[CH_2];//1
+	v[n++] = motor_out[CH_3];//2
 	//right
-	DataFlash.WriteInt(motor_out[CH_7]);//3
-	DataFlash.WriteInt(motor_out[CH_1]);//4
+	v[n++] = motor_out[CH_7];//3
+	v[n++] = motor_out[CH_1];//4
 	//back
-	DataFlash.WriteInt(motor_out[CH_8]);//5
-	DataFlash.WriteInt(motor_out[CH_4]);//6
+	v[n++] = motor_out[CH_8];//5
+	v[n++] = motor_out[CH_4];//6
 
 	#elif FRAME_CONFIG == OCTA_FRAME || FRAME_CONFIG == OCTA_QUAD_FRAME
-	DataFlash.WriteInt(motor_out[CH_1]);//1
-	DataFlash.WriteInt(motor_out[CH_2]);//2
-	DataFlash.WriteInt(motor_out[CH_3]);//3
-	DataFlash.WriteInt(motor_out[CH_4]);//4
-	DataFlash.WriteInt(motor_out[CH_7]);//5
-	DataFlash.WriteInt(motor_out[CH_8]); //6
-	DataFlash.WriteInt(motor_out[CH_10]);//7
-	DataFlash.WriteInt(motor_out[CH_11]);//8
+	v[n++] = motor_out[CH_1];//1
+	v[n++] = motor_out[CH_2];//2
+	v[n++] = motor_out[CH_3];//3
+	v[n++] = motor_out[CH_4];//4
+	v[n++] = motor_out[CH_7];//5
+	v[n++] = motor_out[CH_8];//6
+	v[n++] = motor_out[CH_10];//7
+	v[n++] = motor_out[CH_11];//8
 
 	#elif FRAME_CONFIG == HELI_FRAME
-	DataFlash.WriteInt(heli_servo_out[0]);//1
-	DataFlash.WriteInt(heli_servo_out[1]);//2
-	DataFlash.WriteInt(heli_servo_out[2]);//3
-	DataFlash.WriteInt(heli_servo_out[3]);//4
-	DataFlash.WriteInt(g.heli_ext_gyro_gain);//5
+	v[n++] = (int16_t)heli_servo_out[0];//1
+	v[n++] = (int16_t)heli_servo_out[1];//2
+	v[n++] = (int16_t)heli_servo_out[2];//3
+	v[n++] = (int16_t)heli_servo_out[3];//4
+	v[n++] = g.heli_ext_gyro_gain;//5
 
 	#else // quads
-	DataFlash.WriteInt(motor_out[CH_1]);//1
-	DataFlash.WriteInt(motor_out[CH_2]);//2
-	DataFlash.WriteInt(motor_out[CH_3]);//3
-	DataFlash.WriteInt(motor_out[CH_4]);//4
+	v[n++] = motor_out[CH_1];//1
+	v[n++] = motor_out[CH_2];//2
+	v[n++] = motor_out[CH_3];//3
+	v[n++] = motor_out[CH_4];//4
 	#endif
 
-	DataFlash.WriteByte(END_BYTE);
-}
+	if (Log_Write_Delta(LOG_MOTORS_MSG, v, n)) return;
 
-// Read a Current packet
-static void Log_Read_Motors()
-{
-	#if FRAME_CONFIG == HEXA_FRAME || FRAME_CONFIG == Y6_FRAME
-	int16_t temp1 = DataFlash.ReadInt();			// 1
-	int16_t	temp2 = DataFlash.ReadInt();			// 2
-	int16_t temp3 = DataFlash.ReadInt();			// 3
-	int16_t temp4 = DataFlash.ReadInt();			// 4
-	int16_t temp5 = DataFlash.ReadInt();			// 5
-	int16_t temp6 = DataFlash.ReadInt();			// 6
-							  // 1  2   3   4   5   6
-	Serial.printf_P(PSTR("MOT, %d, %d, %d, %d, %d, %d\n"),
-			temp1,	//1
-			temp2,	//2
-			temp3,	//3
-			temp4,	//4
-			temp5,	//5
-			temp6);	//6
-
-	#elif FRAME_CONFIG == OCTA_FRAME || FRAME_CONFIG == OCTA_QUAD_FRAME
-	int16_t temp1 = DataFlash.ReadInt();			// 1
-	int16_t	temp2 = DataFlash.ReadInt();			// 2
-	int16_t temp3 = DataFlash.ReadInt();			// 3
-	int16_t temp4 = DataFlash.ReadInt();			// 4
-	int16_t temp5 = DataFlash.ReadInt();			// 5
-	int16_t temp6 = DataFlash.ReadInt();			// 6
-	int16_t temp7 = DataFlash.ReadInt();			// 7
-	int16_t temp8 = DataFlash.ReadInt();			// 8
-							 // 1   2   3   4   5   6   7   8
-	Serial.printf_P(PSTR("MOT, %d, %d, %d, %d, %d, %d, %d, %d\n"),
-			temp1,	//1
-			temp2,	//2
-			temp3,	//3
-			temp4,	//4
-			temp5,	//5
-			temp6,	//6
-			temp7,	//7
-			temp8);	//8
-
-	#elif FRAME_CONFIG == HELI_FRAME
-	int16_t temp1 = DataFlash.ReadInt();			// 1
-	int16_t	temp2 = DataFlash.ReadInt();			// 2
-	int16_t temp3 = DataFlash.ReadInt();			// 3
-	int16_t temp4 = DataFlash.ReadInt();			// 4
-	int16_t temp5 = DataFlash.ReadInt();			// 5
-							 // 1   2   3   4   5
-	Serial.printf_P(PSTR("MOT, %d, %d, %d, %d, %d\n"),
-			temp1,	//1
-			temp2,	//2
-			temp3,	//3
-			temp4,	//4
-			temp5);	//5
-
-	#else // quads, TRIs
-	int16_t temp1 = DataFlash.ReadInt();			// 1
-	int16_t	temp2 = DataFlash.ReadInt();			// 2
-	int16_t temp3 = DataFlash.ReadInt();			// 3
-	int16_t temp4 = DataFlash.ReadInt();			// 4
-
-							 // 1   2   3   4
-	Serial.printf_P(PSTR("MOT, %d, %d, %d, %d\n"),
-			temp1, 	//1
-			temp2, 	//2
-			temp3, 	//3
-			temp4); //4;
-	#endif
+	DataFlash.WriteByte(HEAD_BYTE1);
+	DataFlash.WriteByte(HEAD_BYTE2);
+	DataFlash.WriteByte(LOG_MOTORS_MSG);
+	for (uint8_t i = 0; i < n; i++) {
+		DataFlash.WriteInt(v[i]);
+	}
+	DataFlash.WriteByte(END_BYTE);
 }
 
 #ifdef OPTFLOW_ENABLED
@@ -658,21 +664,23 @@ static void Log_Write_Optflow()
 }
 #endif
 
-
-static void Log_Read_Optflow()
+// Write a magnetometer packet, the field as read() left it and the
+// offsets and declination that went into it
+static void Log_Write_Compass()
 {
-	int16_t temp1 	= DataFlash.ReadInt();			// 1
-	int16_t temp2 	= DataFlash.ReadInt();			// 2
-	int16_t temp3 	= DataFlash.ReadInt();			// 3
-	float temp4 	= DataFlash.ReadLong();			// 4
-	float temp5 	= DataFlash.ReadLong();			// 5
-
-	Serial.printf_P(PSTR("OF, %d, %d, %d, %4.7f, %4.7f\n"),
-			temp1,
-			temp2,
-			temp3,
-			temp4,
-			temp5);
+	Vector3f ofs = compass.get_offsets();
+
+	DataFlash.WriteByte(HEAD_BYTE1);
+	DataFlash.WriteByte(HEAD_BYTE2);
+	DataFlash.WriteByte(LOG_COMPASS_MSG);
+	DataFlash.WriteInt(compass.mag_x);
+	DataFlash.WriteInt(compass.mag_y);
+	DataFlash.WriteInt(compass.mag_z);
+	DataFlash.WriteInt((int)ofs.x);
+	DataFlash.WriteInt((int)ofs.y);
+	DataFlash.WriteInt((int)ofs.z);
+	DataFlash.WriteInt((int)(degrees(compass.get_declination()) * 100));
+	DataFlash.WriteByte(END_BYTE);
 }
 
 static void Log_Write_Nav_Tuning()
@@ -687,32 +695,18 @@ static void Log_Write_Nav_Tuning()
 	DataFlash.WriteInt(target_bearing/100);					// 2
 	DataFlash.WriteInt(long_error);							// 3
 	DataFlash.WriteInt(lat_error);							// 4
-	DataFlash.WriteInt(nav_lon);							// 5
-	DataFlash.WriteInt(nav_lat);							// 6
+	DataFlash.WriteInt(wp_nav.nav_lon);		// 5
+	DataFlash.WriteInt(wp_nav.nav_lat);		// 6
 	DataFlash.WriteInt(g.pi_nav_lon.get_integrator());		// 7
 	DataFlash.WriteInt(g.pi_nav_lat.get_integrator());	    // 8
 	DataFlash.WriteInt(g.pi_loiter_lon.get_integrator());	// 9
 	DataFlash.WriteInt(g.pi_loiter_lat.get_integrator());	// 10
+	DataFlash.WriteByte(wp_control);						// 11
 
 	DataFlash.WriteByte(END_BYTE);
 }
 
 
-static void Log_Read_Nav_Tuning()
-{
-	int16_t temp;
-
-	Serial.printf_P(PSTR("NTUN, "));
-
-	for(int8_t i = 1; i < 10; i++ ){
-		temp = DataFlash.ReadInt();
-		Serial.printf("%d, ", temp);
-	}
-
-	temp = DataFlash.ReadInt();
-	Serial.printf("%d\n", temp);
-}
-
 
 // Write a control tuning packet. Total length : 22 bytes
 static void Log_Write_Control_Tuning()
@@ -739,22 +733,6 @@ static void Log_Write_Control_Tuning()
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read an control tuning packet
-static void Log_Read_Control_Tuning()
-{
-	int16_t temp;
-
-	Serial.printf_P(PSTR("CTUN, "));
-
-	for(int8_t i = 0; i < 13; i++ ){
-		temp = DataFlash.ReadInt();
-		Serial.printf("%d, ", temp);
-	}
-	// read 13
-	temp = DataFlash.ReadInt();
-	Serial.printf("%d\n", temp);
-}
-
 // Write a performance monitoring packet. Total length : 19 bytes
 static void Log_Write_Performance()
 {
@@ -773,6 +751,8 @@ static void Log_Write_Performance()
 	DataFlash.WriteByte(	dcm.renorm_sqrt_count);				//4
 	DataFlash.WriteByte(	dcm.renorm_blowup_count);			//5
 	DataFlash.WriteByte(	gps_fix_count);						//6
+	DataFlash.WriteInt(		DataFlash.GetDropped());			//7
+	DataFlash.WriteInt(		scheduler.total_overruns());		//8
 	DataFlash.WriteByte(END_BYTE);
 
 
@@ -793,26 +773,6 @@ static void Log_Write_Performance()
 
 }
 
-// Read a performance packet
-static void Log_Read_Performance()
-{
-	int32_t temp1 	= DataFlash.ReadLong();
-	int8_t  temp2 	= DataFlash.ReadByte();
-	int8_t  temp3 	= DataFlash.ReadByte();
-	int8_t  temp4 	= DataFlash.ReadByte();
-	int8_t 	temp5 	= DataFlash.ReadByte();
-	int8_t	temp6 	= DataFlash.ReadByte();
-
-							 //1   2   3   4   5   6
-	Serial.printf_P(PSTR("PM, %ld, %d, %d, %d, %d, %d\n"),
-		temp1,
-		temp2,
-		temp3,
-		temp4,
-		temp5,
-		temp6);
-}
-
 // Write a command processing packet.
 static void Log_Write_Cmd(byte num, struct Location *wp)
 {
@@ -834,66 +794,28 @@ static void Log_Write_Cmd(byte num, struct Location *wp)
 //CMD, 3, 0, 16, 8, 1, 800, 340440192, -1180692736
 
 
-// Read a command processing packet
-static void Log_Read_Cmd()
-{
-	int8_t temp1 	= DataFlash.ReadByte();
-	int8_t temp2 	= DataFlash.ReadByte();
-	int8_t temp3 	= DataFlash.ReadByte();
-	int8_t temp4 	= DataFlash.ReadByte();
-	int8_t temp5 	= DataFlash.ReadByte();
-	long   temp6 	= DataFlash.ReadLong();
-	long   temp7 	= DataFlash.ReadLong();
-	long   temp8 	= DataFlash.ReadLong();
-
-							//  1   2    3   4   5   6   7    8
-	Serial.printf_P(PSTR( "CMD, %d, %d, %d, %d, %d, %ld, %ld, %ld\n"),
-                    temp1,
-                    temp2,
-                    temp3,
-                    temp4,
-                    temp5,
-                    temp6,
-                    temp7,
-                    temp8);
-}
-
 // Write an attitude packet. Total length : 10 bytes
 static void Log_Write_Attitude()
 {
-	DataFlash.WriteByte(HEAD_BYTE1);
-	DataFlash.WriteByte(HEAD_BYTE2);
-	DataFlash.WriteByte(LOG_ATTITUDE_MSG);
+	int32_t v[6];
 
-	DataFlash.WriteInt((int)dcm.roll_sensor);		// 1
-	DataFlash.WriteInt((int)dcm.pitch_sensor);		// 2
-	DataFlash.WriteInt((uint16_t)dcm.yaw_sensor);	// 3
+	v[0] = (int16_t)dcm.roll_sensor();		// 1
+	v[1] = (int16_t)dcm.pitch_sensor();		// 2
+	v[2] = (uint16_t)dcm.yaw_sensor();		// 3
 
-	DataFlash.WriteInt((int)g.rc_1.servo_out);		// 4
-	DataFlash.WriteInt((int)g.rc_2.servo_out);		// 5
-	DataFlash.WriteInt((int)g.rc_4.servo_out);		// 6
+	v[3] = (int16_t)g.rc_1.servo_out;		// 4
+	v[4] = (int16_t)g.rc_2.servo_out;		// 5
+	v[5] = (int16_t)g.rc_4.servo_out;		// 6
 
-	DataFlash.WriteByte(END_BYTE);
-}
+	if (Log_Write_Delta(LOG_ATTITUDE_MSG, v, 6)) return;
 
-// Read an attitude packet
-static void Log_Read_Attitude()
-{
-	int16_t temp1 	= DataFlash.ReadInt();
-	int16_t temp2 	= DataFlash.ReadInt();
-	uint16_t temp3 	= DataFlash.ReadInt();
-	int16_t temp4 	= DataFlash.ReadInt();
-	int16_t temp5 	= DataFlash.ReadInt();
-	int16_t temp6 	= DataFlash.ReadInt();
-
-							// 1   2   3    4   5   6
-	Serial.printf_P(PSTR("ATT, %d, %d, %u, %d, %d, %d\n"),
-		temp1,
-		temp2,
-		temp3,
-		temp4,
-		temp5,
-		temp6);
+	DataFlash.WriteByte(HEAD_BYTE1);
+	DataFlash.WriteByte(HEAD_BYTE2);
+	DataFlash.WriteByte(LOG_ATTITUDE_MSG);
+	for (uint8_t i = 0; i < 6; i++) {
+		DataFlash.WriteInt(v[i]);
+	}
+	DataFlash.WriteByte(END_BYTE);
 }
 
 // Write a mode packet. Total length : 5 bytes
@@ -907,14 +829,6 @@ static void Log_Write_Mode(byte mode)
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read a mode packet
-static void Log_Read_Mode()
-{
-	Serial.printf_P(PSTR("MOD:"));
-	Serial.print(flight_mode_strings[DataFlash.ReadByte()]);
-	Serial.printf_P(PSTR(", %d\n"),DataFlash.ReadInt());
-}
-
 static void Log_Write_Startup()
 {
 	DataFlash.WriteByte(HEAD_BYTE1);
@@ -923,12 +837,6 @@ static void Log_Write_Startup()
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read a mode packet
-static void Log_Read_Startup()
-{
-	Serial.printf_P(PSTR("START UP\n"));
-}
-
 static void Log_Write_Data(int8_t _type, float _data)
 {
 	Log_Write_Data(_type, (int32_t)(_data * 1000));
@@ -944,18 +852,208 @@ static void Log_Write_Data(int8_t _type, int32_t _data)
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read a mode packet
-static void Log_Read_Data()
+#if LOG_COMPRESS == ENABLED
+// Write a field of a delta record, see LOG_DELTA_FLAG
+static void Log_Write_Varint(uint32_t delta)
+{
+	uint32_t u = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+
+	while (u >= 0x80) {
+		DataFlash.WriteByte(u | 0x80);
+		u >>= 7;
+	}
+	DataFlash.WriteByte(u);
+}
+
+// Write the n fields of v as a delta record of type. Returns false when
+// it is time for a keyframe instead, which the caller writes as an
+// ordinary record
+static bool Log_Write_Delta(byte type, const int32_t *v, uint8_t n)
+{
+	struct Log_Delta *d = &log_delta[Log_Delta_Slot(type)];
+	bool delta;
+
+	// bytes lost to a full ring may have been part of any record, so
+	// every type starts again from a keyframe
+	if (DataFlash.GetDropped() != log_delta_dropped) {
+		log_delta_dropped = DataFlash.GetDropped();
+		memset(log_delta, 0, sizeof(log_delta));
+	}
+	delta = (d->count != 0);
+
+	if (++d->count == LOG_DELTA_KEYFRAME) {
+		d->count = 0;
+	}
+	if (delta) {
+		DataFlash.WriteByte(HEAD_BYTE1);
+		DataFlash.WriteByte(HEAD_BYTE2);
+		DataFlash.WriteByte(type | LOG_DELTA_FLAG);
+		for (uint8_t i = 0; i < n; i++) {
+			Log_Write_Varint((uint32_t)v[i] - (uint32_t)d->last[i]);
+		}
+		DataFlash.WriteByte(END_BYTE);
+	}
+	memcpy(d->last, v, n * sizeof(v[0]));
+	return delta;
+}
+#else
+// every record is written in full
+static bool Log_Write_Delta(byte type, const int32_t *v, uint8_t n) { return false; }
+#endif
+
+#define LOG_NUM_FORMATS	(sizeof(log_formats) / sizeof(log_formats[0]))
+
+// Write a format record for each message type at the start of the log,
+// so the log can be decoded without this version of the code. There are
+// more of them than the DataFlash ring holds, so they go to the chip
+// directly
+static void Log_Write_Formats()
+{
+	DataFlash.SyncWrite(true);
+	for (uint8_t i = 0; i < LOG_NUM_FORMATS; i++) {
+		PGM_P p = (PGM_P)&log_formats[i];
+
+		DataFlash.WriteByte(HEAD_BYTE1);
+		DataFlash.WriteByte(HEAD_BYTE2);
+		DataFlash.WriteByte(LOG_FORMAT_MSG);
+		for (uint8_t j = 0; j < sizeof(struct Log_Format); j++) {
+			DataFlash.WriteByte(pgm_read_byte(p + j));
+		}
+		DataFlash.WriteByte(END_BYTE);
+	}
+	DataFlash.SyncWrite(false);
+}
+
+// Find the format of a message type. Returns false for an unknown type
+static bool Log_Find_Format(byte type, struct Log_Format *fmt)
+{
+	for (uint8_t i = 0; i < LOG_NUM_FORMATS; i++) {
+		if (pgm_read_byte((PGM_P)&log_formats[i].type) == type) {
+			memcpy_P(fmt, (PGM_P)&log_formats[i], sizeof(*fmt));
+			return true;
+		}
+	}
+	return false;
+}
+
+// Print a fixed point field with the given number of decimal places
+static void Log_Print_Fixed(int32_t value, uint8_t places)
+{
+	uint32_t	u = value;
+	uint32_t	scale = 1;
+
+	for (uint8_t i = 0; i < places; i++) {
+		scale *= 10;
+	}
+	if (value < 0) {
+		u = -u;
+	}
+	Serial.printf_P(PSTR(", %s%lu."), value < 0 ? "-" : "", (unsigned long)(u / scale));
+	u %= scale;
+	for (scale /= 10; scale > 0; scale /= 10) {
+		Serial.print((char)('0' + (u / scale) % 10));
+	}
+}
+
+// Read a field of a packet
+static int32_t Log_Read_Field(char c)
+{
+	switch (c) {
+		case 'b':				return (int8_t)DataFlash.ReadByte();
+		case 'B': case 'M':		return DataFlash.ReadByte();
+		case 'h': case 'c':		return DataFlash.ReadInt();
+		case 'H': case 'C':		return (uint16_t)DataFlash.ReadInt();
+		case 'i': case 'I':
+		case 'e': case 'L':		return DataFlash.ReadLong();
+	}
+	return 0;
+}
+
+// Read a field of a delta record, see LOG_DELTA_FLAG
+static uint32_t Log_Read_Varint(void)
 {
-	int8_t  temp1 = DataFlash.ReadByte();
-	int32_t temp2 = DataFlash.ReadLong();
-	Serial.printf_P(PSTR("DATA: %d, %ld\n"), temp1, temp2);
+	uint32_t	u = 0;
+	uint8_t		shift = 0;
+	byte		data;
+
+	do {
+		data = DataFlash.ReadByte();
+		u |= (uint32_t)(data & 0x7F) << shift;
+		shift += 7;
+	} while ((data & 0x80) && shift < 35);
+	return (u >> 1) ^ -(u & 1);
+}
+
+// Read a packet and print its fields as described by its format. delta
+// holds the last record of each type that can be delta encoded, which
+// a delta record is added to
+static void Log_Read_Packet(const struct Log_Format *fmt, bool is_delta, struct Log_Delta *delta)
+{
+	int8_t				slot = Log_Delta_Slot(fmt->type);
+	struct Log_Delta	*d = slot < 0 ? NULL : &delta[slot];
+	int32_t				v;
+
+	if (is_delta && (d == NULL || d->count == 0)) {
+		// there's no keyframe to add it to, so skip it
+		for (uint8_t i = 0; i < sizeof(fmt->format) && fmt->format[i]; i++) {
+			Log_Read_Varint();
+		}
+		return;
+	}
+
+	Serial.print(fmt->name);
+	for (uint8_t i = 0; i < sizeof(fmt->format) && fmt->format[i]; i++) {
+		if (is_delta) {
+			v = (uint32_t)d->last[i] + Log_Read_Varint();
+		} else {
+			v = Log_Read_Field(fmt->format[i]);
+		}
+		if (d != NULL && i < LOG_DELTA_FIELDS) {
+			d->last[i] = v;
+		}
+		switch (fmt->format[i]) {
+			case 'b': case 'h':	Serial.printf_P(PSTR(", %d"), (int)v);					break;
+			case 'B': case 'H':	Serial.printf_P(PSTR(", %u"), (unsigned)v);				break;
+			case 'i': Serial.printf_P(PSTR(", %ld"), (long)v);							break;
+			case 'I': Serial.printf_P(PSTR(", %lu"), (unsigned long)(uint32_t)v);		break;
+			case 'c': case 'C':
+			case 'e': Log_Print_Fixed(v, 2);											break;
+			case 'L': Log_Print_Fixed(v, 7);											break;
+			case 'M':
+				Serial.printf_P(PSTR(", "));
+				Serial.print(flight_mode_strings[v]);
+				break;
+		}
+	}
+	if (d != NULL) {
+		d->count = 1;
+	}
+	Serial.println();
+}
+
+// Read a format record and print it
+static void Log_Read_Format()
+{
+	struct Log_Format	fmt;
+	uint8_t				*p = (uint8_t *)&fmt;
+
+	for (uint8_t i = 0; i < sizeof(fmt); i++) {
+		p[i] = DataFlash.ReadByte();
+	}
+	fmt.name[sizeof(fmt.name) - 1] = 0;
+	fmt.format[sizeof(fmt.format) - 1] = 0;
+	fmt.labels[sizeof(fmt.labels) - 1] = 0;
+	Serial.printf_P(PSTR("FMT, %u, %u, %s, %s, %s\n"),
+					fmt.type, fmt.length, fmt.name, fmt.format, fmt.labels);
 }
 
 // Read the DataFlash log memory
 static void Log_Read(int start_page, int end_page)
 {
 	int packet_count = 0;
+	struct Log_Delta delta[LOG_DELTA_TYPES];
+
+	memset(delta, 0, sizeof(delta));
 
 	#ifdef AIRFRAME_NAME
 		Serial.printf_P(PSTR((AIRFRAME_NAME)
@@ -966,24 +1064,28 @@ static void Log_Read(int start_page, int end_page)
 
     if(start_page > end_page)
     {
-    	packet_count = Log_Read_Process(start_page, DF_LAST_PAGE);
-    	packet_count += Log_Read_Process(1, end_page);
+    	packet_count = Log_Read_Process(start_page, DF_LAST_PAGE, delta);
+    	packet_count += Log_Read_Process(1, end_page, delta);
     } else {
-    	packet_count = Log_Read_Process(start_page, end_page);
+    	packet_count = Log_Read_Process(start_page, end_page, delta);
     }
 
 	Serial.printf_P(PSTR("Number of packets read: %d\n"), packet_count);
 }
 
 // Read the DataFlash log memory : Packet Parser
-static int Log_Read_Process(int start_page, int end_page)
+static int Log_Read_Process(int start_page, int end_page, struct Log_Delta *delta)
 {
 	byte data;
 	byte log_step 		= 0;
 	int page 			= start_page;
 	int packet_count = 0;
+	struct Log_Format fmt;
 
-	DataFlash.StartRead(start_page);
+	if (!DataFlash.StartRead(start_page)) {
+		// still logging
+		return 0;
+	}
 
 	while (page < end_page && page != -1){
 
@@ -1006,66 +1108,26 @@ static int Log_Read_Process(int start_page, int end_page)
 				break;
 
 			case 2:
-				log_step = 0;
-				switch(data){
-					case LOG_ATTITUDE_MSG:
-						Log_Read_Attitude();
-						break;
-
-					case LOG_MODE_MSG:
-						Log_Read_Mode();
-						break;
-
-					case LOG_CONTROL_TUNING_MSG:
-						Log_Read_Control_Tuning();
-						break;
-
-					case LOG_NAV_TUNING_MSG:
-						Log_Read_Nav_Tuning();
-						break;
-
-					case LOG_PERFORMANCE_MSG:
-						Log_Read_Performance();
-						break;
-
-					case LOG_RAW_MSG:
-						Log_Read_Raw();
-						break;
-
-					case LOG_CMD_MSG:
-						Log_Read_Cmd();
-						break;
-
-					case LOG_CURRENT_MSG:
-						Log_Read_Current();
-						break;
-
-					case LOG_STARTUP_MSG:
-						Log_Read_Startup();
-						break;
-
-					case LOG_MOTORS_MSG:
-						Log_Read_Motors();
-						break;
-
-					case LOG_OPTFLOW_MSG:
-						Log_Read_Optflow();
-						break;
-
-					case LOG_GPS_MSG:
-						Log_Read_GPS();
-						break;
-
-					case LOG_DATA_MSG:
-						Log_Read_Data();
-						break;
+				if(data == LOG_FORMAT_MSG){
+					Log_Read_Format();
+					log_step++;
+				}else if(Log_Find_Format(data & ~LOG_DELTA_FLAG, &fmt)){
+					Log_Read_Packet(&fmt, data & LOG_DELTA_FLAG, delta);
+					log_step++;
+				}else{
+					Serial.printf_P(PSTR("Error Reading Packet: %d\n"),packet_count);
+					log_step = 0;	 // Restart, we have a problem...
 				}
 				break;
+
 			case 3:
 				if(data == END_BYTE){
 					 packet_count++;
 				}else{
 					Serial.printf_P(PSTR("Error Reading END_BYTE: %d\n"),data);
+					// the packet was bad but has already been added to
+					// the delta state, so deltas wait for a keyframe
+					memset(delta, 0, LOG_DELTA_TYPES * sizeof(delta[0]));
 				}
 				log_step = 0;			// Restart sequence: new packet...
 				break;
@@ -1078,7 +1140,6 @@ static int Log_Read_Process(int start_page, int end_page)
 #else // LOGGING_ENABLED
 
 static void Log_Write_Startup() {}
-static void Log_Read_Startup() {}
 static void Log_Read(int start_page, int end_page) {}
 static void Log_Write_Cmd(byte num, struct Location *wp) {}
 static void Log_Write_Mode(byte mode) {}
@@ -1092,6 +1153,7 @@ static void Log_Write_Data(int8_t _type, int32_t _data){}
 #ifdef OPTFLOW_ENABLED
 static void Log_Write_Optflow() {}
 #endif
+static void Log_Write_Compass() {}
 static void Log_Write_Nav_Tuning() {}
 static void Log_Write_Control_Tuning() {}
 static void Log_Write_Motors() {}
@@ -10,11 +10,151 @@ static void init_commands()
 	command_nav_queue.id 	= NO_COMMAND;
 }
 
+/*
+  Mission cache
+
+  Commands are read from EEPROM once and then kept in RAM, decoded
+  and with their relative offsets applied, in a small window that
+  holds the ones navigation, command processing and the GCS are using.
+
+  Writes update the cache straight away and are queued for EEPROM,
+  which mission_write_loop() writes out a byte at a time whenever the
+  EEPROM is ready. Each byte takes 3.3ms to program, so this keeps a
+  mission upload from stalling the main loop. Reads check the queue
+  before EEPROM, so they always see the latest write.
+*/
+#define CMD_CACHE_SIZE		4
+#define CMD_WRITE_QUEUE		4
+
+static struct {
+	int16_t index;
+	struct Location loc;
+} cmd_cache[CMD_CACHE_SIZE];
+static uint8_t cmd_cache_valid;	// a bit for each entry holding a command
+static uint8_t cmd_cache_next;	// next entry to replace
+
+static struct {
+	int16_t index;
+	uint8_t bytes[WP_SIZE];	// as stored in EEPROM
+} cmd_write_queue[CMD_WRITE_QUEUE];
+static uint8_t cmd_write_head;
+static uint8_t cmd_write_count;
+static uint8_t cmd_write_offset;	// bytes of the head entry written so far
+
+// the layout in EEPROM is id, options, p1, then alt, lat and lng as
+// little endian dwords
+static void encode_cmd(const struct Location *loc, uint8_t *bytes)
+{
+	bytes[0] = loc->id;
+	bytes[1] = loc->options;
+	bytes[2] = loc->p1;
+	memcpy(&bytes[3], &loc->alt, 4);	// Alt is stored in CM!
+	memcpy(&bytes[7], &loc->lat, 4);	// Lat is stored in decimal degrees * 10^7
+	memcpy(&bytes[11], &loc->lng, 4);	// Long is stored in decimal degrees * 10^7
+}
+
+static void decode_cmd(const uint8_t *bytes, struct Location *loc)
+{
+	loc->id = bytes[0];
+	loc->options = bytes[1];
+	loc->p1 = bytes[2];
+	memcpy(&loc->alt, &bytes[3], 4);	// alt is stored in CM! Alt is stored relative!
+	memcpy(&loc->lat, &bytes[7], 4);
+	memcpy(&loc->lng, &bytes[11], 4);
+
+	// Add on home altitude if we are a nav command (or other command with altitude) and stored alt is relative
+	//if((loc->id < MAV_CMD_NAV_LAST || loc->id == MAV_CMD_CONDITION_CHANGE_ALT) && loc->options & MASK_OPTIONS_RELATIVE_ALT){
+		//loc->alt += home.alt;
+	//}
+
+	if(loc->options & WP_OPTION_RELATIVE){
+		// If were relative, just offset from home
+		loc->lat	+=	home.lat;
+		loc->lng	+=	home.lng;
+	}
+}
+
+static void cache_cmd(int i, const struct Location *loc)
+{
+	uint8_t n;
+
+	for (n = 0; n < CMD_CACHE_SIZE; n++) {
+		if ((cmd_cache_valid & (1<<n)) && cmd_cache[n].index == i)
+			break;
+	}
+	if (n == CMD_CACHE_SIZE) {
+		n = cmd_cache_next;
+		cmd_cache_next = (cmd_cache_next + 1) % CMD_CACHE_SIZE;
+	}
+	cmd_cache[n].index = i;
+	cmd_cache[n].loc = *loc;
+	cmd_cache_valid |= (1<<n);
+}
+
+// forget what is cached, when home moves or the EEPROM is erased
+static void invalidate_cmd_cache()
+{
+	cmd_cache_valid = 0;
+}
+
+// write the head of the queue out while the EEPROM will take it
+static void mission_write_loop()
+{
+	while (cmd_write_count > 0 && eeprom_is_ready()) {
+		uint32_t mem = WP_START_BYTE + (cmd_write_queue[cmd_write_head].index * WP_SIZE);
+
+		eeprom_write_byte((uint8_t *)(mem + cmd_write_offset),
+						  cmd_write_queue[cmd_write_head].bytes[cmd_write_offset]);
+		if (++cmd_write_offset == WP_SIZE) {
+			cmd_write_offset = 0;
+			cmd_write_head = (cmd_write_head + 1) % CMD_WRITE_QUEUE;
+			cmd_write_count--;
+		}
+	}
+}
+
+// write everything queued, waiting for the EEPROM if need be
+static void mission_write_flush()
+{
+	while (cmd_write_count > 0) {
+		eeprom_busy_wait();
+		mission_write_loop();
+	}
+}
+
+static void queue_cmd_write(int i, const uint8_t *bytes)
+{
+	uint8_t n;
+
+	// replace a queued write of the same command that hasn't started
+	for (n = 0; n < cmd_write_count; n++) {
+		uint8_t q = (cmd_write_head + n) % CMD_WRITE_QUEUE;
+		if (cmd_write_queue[q].index == i && (n > 0 || cmd_write_offset == 0)) {
+			memcpy(cmd_write_queue[q].bytes, bytes, WP_SIZE);
+			return;
+		}
+	}
+
+	if (cmd_write_count == CMD_WRITE_QUEUE) {
+		// the GCS is sending faster than the EEPROM can keep up
+		while (cmd_write_count == CMD_WRITE_QUEUE) {
+			eeprom_busy_wait();
+			mission_write_loop();
+		}
+	}
+	n = (cmd_write_head + cmd_write_count) % CMD_WRITE_QUEUE;
+	cmd_write_queue[n].index = i;
+	memcpy(cmd_write_queue[n].bytes, bytes, WP_SIZE);
+	cmd_write_count++;
+}
+
 // Getters
 // -------
 static struct Location get_cmd_with_index(int i)
 {
 	struct Location temp;
+	uint8_t bytes[WP_SIZE];
+	uint8_t n;
 
 	// Find out proper location in memory by using the start_byte position + the index
 	// --------------------------------------------------------------------------------
@@ -25,41 +165,28 @@ static struct Location get_cmd_with_index(int i)
 
 		// no reason to carry on
 		return temp;
-
-	}else{
-		// we can load a command, we don't process it yet
-		// read WP position
-		int32_t mem = (WP_START_BYTE) + (i * WP_SIZE);
-
-		temp.id = eeprom_read_byte((uint8_t*)mem);
-
-		mem++;
-		temp.options = eeprom_read_byte((uint8_t*)mem);
-
-		mem++;
-		temp.p1 = eeprom_read_byte((uint8_t*)mem);
-
-		mem++;
-		temp.alt = eeprom_read_dword((uint32_t*)mem);	// alt is stored in CM! Alt is stored relative!
-
-		mem += 4;
-		temp.lat = eeprom_read_dword((uint32_t*)mem); // lat is stored in decimal * 10,000,000
-
-		mem += 4;
-		temp.lng = eeprom_read_dword((uint32_t*)mem); // lon is stored in decimal * 10,000,000
 	}
 
-	// Add on home altitude if we are a nav command (or other command with altitude) and stored alt is relative
-	//if((temp.id < MAV_CMD_NAV_LAST || temp.id == MAV_CMD_CONDITION_CHANGE_ALT) && temp.options & MASK_OPTIONS_RELATIVE_ALT){
-		//temp.alt += home.alt;
-	//}
+	for (n = 0; n < CMD_CACHE_SIZE; n++) {
+		if ((cmd_cache_valid & (1<<n)) && cmd_cache[n].index == i)
+			return cmd_cache[n].loc;
+	}
 
-	if(temp.options & WP_OPTION_RELATIVE){
-		// If were relative, just offset from home
-		temp.lat	+=	home.lat;
-		temp.lng	+=	home.lng;
+	// the newest queued write wins over EEPROM
+	for (n = cmd_write_count; n > 0; n--) {
+		uint8_t q = (cmd_write_head + n - 1) % CMD_WRITE_QUEUE;
+		if (cmd_write_queue[q].index == i)
+			break;
+	}
+	if (n > 0) {
+		memcpy(bytes, cmd_write_queue[(cmd_write_head + n - 1) % CMD_WRITE_QUEUE].bytes, WP_SIZE);
+	} else {
+		// we can load a command, we don't process it yet
+		eeprom_read_block(bytes, (void *)(WP_START_BYTE + (i * WP_SIZE)), WP_SIZE);
 	}
 
+	decode_cmd(bytes, &temp);
+	cache_cmd(i, &temp);
 	return temp;
 }
 
@@ -67,6 +194,7 @@ static struct Location get_cmd_with_index(int i)
 // -------
 static void set_cmd_with_index(struct Location temp, int i)
 {
+	uint8_t bytes[WP_SIZE];
 
 	i = constrain(i, 0, g.command_total.get());
 	//Serial.printf("set_command: %d with id: %d\n", i, temp.id);
@@ -78,24 +206,12 @@ static void set_cmd_with_index(struct Location temp, int i)
 		temp.id = MAV_CMD_NAV_WAYPOINT;
 	}
 
-	uint32_t mem = WP_START_BYTE + (i * WP_SIZE);
-
-	eeprom_write_byte((uint8_t *)	mem, temp.id);
-
-	mem++;
-	eeprom_write_byte((uint8_t *)	mem, temp.options);
-
-	mem++;
-	eeprom_write_byte((uint8_t *)	mem, temp.p1);
+	encode_cmd(&temp, bytes);
+	queue_cmd_write(i, bytes);
 
-	mem++;
-	eeprom_write_dword((uint32_t *)	mem, temp.alt);	// Alt is stored in CM!
-
-	mem += 4;
-	eeprom_write_dword((uint32_t *)	mem, temp.lat);	// Lat is stored in decimal degrees * 10^7
-
-	mem += 4;
-	eeprom_write_dword((uint32_t *)	mem, temp.lng); // Long is stored in decimal degrees * 10^7
+	// cache it the way a read would see it
+	decode_cmd(bytes, &temp);
+	cache_cmd(i, &temp);
 
 	// Make sure our WP_total
 	if(g.command_total <= i)
@@ -166,10 +282,9 @@ static void set_next_WP(struct Location *wp)
 	// -----------------------------------------------------------------
 	target_altitude = current_loc.alt;
 
-	// this is used to offset the shrinking longitude as we go towards the poles
-	float rads 			= (abs(next_WP.lat)/t7) * 0.0174532925;
-	scaleLongDown 		= cos(rads);
-	scaleLongUp 		= 1.0f/cos(rads);
+	// until there is a home, measure from the WP
+	if (!home_is_set)
+		local_frame.set_origin(&next_WP);
 
 	// this is handy for the groundstation
 	// -----------------------------------
@@ -181,9 +296,9 @@ static void set_next_WP(struct Location *wp)
 	// ---------------------------------
 	original_target_bearing = target_bearing;
 
-	// reset speed governer
-	// --------------------
-	waypoint_speed_gov = 0;
+	// the leg we are about to fly, this also resets the speed governer
+	// -----------------------------------------------------------------
+	wp_nav.start_leg(local_frame, &prev_WP, &next_WP);
 }
 
 
@@ -207,6 +322,8 @@ static void init_home()
 	home.lat 	= g_gps->latitude;				// Lat * 10**7
 	//home.alt 	= max(g_gps->altitude, 0);		// we sometimes get negatives from GPS, not valid
 	home.alt 	= 0;							// Home is always 0
+	invalidate_cmd_cache();
+	local_frame.set_origin(&home);
 
 	// to point yaw towards home until we set it with Mavlink
 	target_WP 	= home;
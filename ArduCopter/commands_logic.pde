@@ -696,6 +696,8 @@ static void do_set_home()
 		home.lat	= command_cond_queue.lat;				// Lat * 10**7
 		home.alt	= max(command_cond_queue.alt, 0);
 		home_is_set = true;
+		invalidate_cmd_cache();
+		local_frame.set_origin(&home);
 	}
 }
 
@@ -718,6 +718,14 @@
 #ifndef LOG_OPTFLOW
 # define LOG_OPTFLOW				DISABLED
 #endif
+// magnetometer, for replaying the log through the attitude estimate
+#ifndef LOG_COMPASS
+# define LOG_COMPASS				DISABLED
+#endif
+// write ATT, RAW and MOT records as deltas between full ones
+#ifndef LOG_COMPRESS
+# define LOG_COMPRESS			ENABLED
+#endif
 
 // calculate the default log_bitmask
 #define LOGBIT(_s)     (LOG_##_s ? MASK_LOG_##_s : 0)
@@ -734,7 +742,8 @@
                LOGBIT(CMD)                             | \
                LOGBIT(CUR)						| \
                LOGBIT(MOTORS)					| \
-               LOGBIT(OPTFLOW)
+               LOGBIT(OPTFLOW)					| \
+               LOGBIT(COMPASS)
 
 // if we are using fast, Disable Medium
 //#if LOG_ATTITUDE_FAST == ENABLED
@@ -825,3 +834,9 @@
 #ifndef MAVLINK_TELEMETRY_PORT_DELAY
 # define MAVLINK_TELEMETRY_PORT_DELAY 2000
 #endif
+
+// a log download the GCS has gone quiet on is ended after this many
+// milliseconds, so that logging can't be left off
+#ifndef LOG_TRANSFER_TIMEOUT
+# define LOG_TRANSFER_TIMEOUT 10000
+#endif
@@ -180,8 +180,8 @@ static void trim_accel()
 
 	/*
 	Serial.printf_P(PSTR("r:%ld p:%ld ax:%f, ay:%f, az:%f\n"),
-							dcm.roll_sensor,
-							dcm.pitch_sensor,
+							dcm.roll_sensor(),
+							dcm.pitch_sensor(),
 							(float)imu.ax(),
 							(float)imu.ay(),
 							(float)imu.az());
@@ -219,7 +219,7 @@ enum ap_message {
     MSG_NEXT_WAYPOINT,
     MSG_NEXT_PARAM,
     MSG_STATUSTEXT,
-    MSG_RETRY_DEFERRED // this must be last
+    MSG_RETRY_DEFERRED // this must be last, and no more than 32
 };
 
 enum gcs_severity {
@@ -245,6 +245,7 @@ enum gcs_severity {
 #define LOG_MOTORS_MSG 			0x0B
 #define LOG_OPTFLOW_MSG 		0x0C
 #define LOG_DATA_MSG 			0x0D
+#define LOG_COMPASS_MSG			0x0E
 #define LOG_INDEX_MSG			0xF0
 #define MAX_NUM_LOGS			50
 
@@ -260,6 +261,7 @@ enum gcs_severity {
 #define MASK_LOG_CUR			(1<<9)
 #define MASK_LOG_MOTORS			(1<<10)
 #define MASK_LOG_OPTFLOW		(1<<11)
+#define MASK_LOG_COMPASS		(1<<12)
 
 // Waypoint Modes
 // ----------------
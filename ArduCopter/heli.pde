@@ -251,7 +251,7 @@ static void output_motor_test()
 // throttle value should be 0 ~ 1000
 static int heli_get_angle_boost(int throttle)
 {
-    float angle_boost_factor = cos_pitch_x * cos_roll_x;
+    float angle_boost_factor = dcm.cos_pitch() * dcm.cos_roll();
 	angle_boost_factor = 1.0 - constrain(angle_boost_factor, .5, 1.0);
 	int throttle_above_mid = max(throttle - heli_throttle_mid,0);
 	return throttle + throttle_above_mid*angle_boost_factor;
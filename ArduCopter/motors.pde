@@ -70,6 +70,11 @@ static void init_arm_motors()
 	gcs_send_text_P(SEVERITY_HIGH, PSTR("ARMING MOTORS"));
 	#endif
 
+	#if LOGGING_ENABLED == ENABLED
+	// a log download has logging stopped; end it so the flight is logged
+	mavlink_log_end();
+	#endif
+
 	motor_armed 	= true;
 
 	#if PIEZO_ARMING == 1
@@ -49,47 +49,27 @@ static void calc_location_error(struct Location *next_loc)
 	*/
 
 	// X ROLL
-	long_error	= (float)(next_loc->lng - current_loc.lng) * scaleLongDown;   // 500 - 0 = 500 roll EAST
+	long_error	= (float)(next_loc->lng - current_loc.lng) * local_frame.lng_scale();   // 500 - 0 = 500 roll EAST
 
 	// Y PITCH
 	lat_error	= next_loc->lat - current_loc.lat;							// 0 - 500 = -500 pitch NORTH
 }
 
-#define NAV_ERR_MAX 800
 static void calc_loiter(int x_error, int y_error)
 {
-	x_error = constrain(x_error, -NAV_ERR_MAX, NAV_ERR_MAX);
-	y_error = constrain(y_error, -NAV_ERR_MAX, NAV_ERR_MAX);
-
-	int x_target_speed = g.pi_loiter_lon.get_pi(x_error, dTnav);
-	int y_target_speed = g.pi_loiter_lat.get_pi(y_error, dTnav);
-
-	// find the rates:
-	float temp		= g_gps->ground_course * RADX100;
-
 	#ifdef OPTFLOW_ENABLED
 		// calc the cos of the error to tell how fast we are moving towards the target in cm
 		if(g.optflow_enabled && current_loc.alt < 500 &&  g_gps->ground_speed < 150){
-			x_actual_speed 	= optflow.vlon * 10;
-			y_actual_speed 	= optflow.vlat * 10;
+			wp_nav.x_actual_speed 	= optflow.vlon * 10;
+			wp_nav.y_actual_speed 	= optflow.vlat * 10;
 		}else{
-			x_actual_speed 	= (float)g_gps->ground_speed * sin(temp);
-			y_actual_speed 	= (float)g_gps->ground_speed * cos(temp);
+			wp_nav.set_ground_velocity(g_gps->ground_course, g_gps->ground_speed);
 		}
 	#else
-		x_actual_speed 	= (float)g_gps->ground_speed * sin(temp);
-		y_actual_speed 	= (float)g_gps->ground_speed * cos(temp);
+		wp_nav.set_ground_velocity(g_gps->ground_course, g_gps->ground_speed);
 	#endif
 
-	y_rate_error 	= y_target_speed - y_actual_speed; // 413
-	y_rate_error 	= constrain(y_rate_error, -250, 250);	// added a rate error limit to keep pitching down to a minimum
-	nav_lat		 	= g.pi_nav_lat.get_pi(y_rate_error, dTnav);
-	nav_lat			= constrain(nav_lat, -3500, 3500);
-
-	x_rate_error 	= x_target_speed - x_actual_speed;
-	x_rate_error 	= constrain(x_rate_error, -250, 250);
-	nav_lon		 	= g.pi_nav_lon.get_pi(x_rate_error, dTnav);
-	nav_lon			= constrain(nav_lon, -3500, 3500);
+	wp_nav.calc_loiter(x_error, y_error, dTnav);
 }
 
 static void calc_loiter2(int x_error, int y_error)
@@ -97,44 +77,30 @@ static void calc_loiter2(int x_error, int y_error)
 	static int last_x_error = 0;
 	static int last_y_error = 0;
 
-	x_error = constrain(x_error, -NAV_ERR_MAX, NAV_ERR_MAX);
-	y_error = constrain(y_error, -NAV_ERR_MAX, NAV_ERR_MAX);
-
-	int x_target_speed = g.pi_loiter_lon.get_pi(x_error, dTnav);
-	int y_target_speed = g.pi_loiter_lat.get_pi(y_error, dTnav);
-
 	// find the rates:
-	x_actual_speed 	= (float)(last_x_error - x_error)/dTnav;
-	y_actual_speed 	= (float)(last_y_error - y_error)/dTnav;
+	wp_nav.x_actual_speed 	= (float)(last_x_error - x_error)/dTnav;
+	wp_nav.y_actual_speed 	= (float)(last_y_error - y_error)/dTnav;
 
 	// save speeds
 	last_x_error	= x_error;
 	last_y_error	= y_error;
 
-	y_rate_error 	= y_target_speed - y_actual_speed; // 413
-	y_rate_error 	= constrain(y_rate_error, -250, 250);	// added a rate error limit to keep pitching down to a minimum
-	nav_lat		 	= g.pi_nav_lat.get_pi(y_rate_error, dTnav);
-	nav_lat			= constrain(nav_lat, -3500, 3500);
-
-	x_rate_error 	= x_target_speed - x_actual_speed;
-	x_rate_error 	= constrain(x_rate_error, -250, 250);
-	nav_lon		 	= g.pi_nav_lon.get_pi(x_rate_error, dTnav);
-	nav_lon			= constrain(nav_lon, -3500, 3500);
+	wp_nav.calc_loiter(x_error, y_error, dTnav);
 }
 
 // nav_roll, nav_pitch
 static void calc_loiter_pitch_roll()
 {
 
-	//float temp  	 = radians((float)(9000 - (dcm.yaw_sensor))/100.0);
+	//float temp  	 = radians((float)(9000 - (dcm.yaw_sensor()))/100.0);
 	//float _cos_yaw_x = cos(temp);
 	//float _sin_yaw_y = sin(temp);
 
-	//Serial.printf("ys %ld, cx %1.4f, _cx %1.4f | sy %1.4f, _sy %1.4f\n", dcm.yaw_sensor, cos_yaw_x, _cos_yaw_x, sin_yaw_y, _sin_yaw_y);
+	//Serial.printf("ys %ld, cx %1.4f, _cx %1.4f | sy %1.4f, _sy %1.4f\n", dcm.yaw_sensor(), dcm.sin_yaw(), _cos_yaw_x, dcm.cos_yaw(), _sin_yaw_y);
 
 	// rotate the vector
-	nav_roll 	=  (float)nav_lon * sin_yaw_y - (float)nav_lat * cos_yaw_x;
-	nav_pitch 	=  (float)nav_lon * cos_yaw_x + (float)nav_lat * sin_yaw_y;
+	nav_roll 	=  (float)wp_nav.nav_lon * dcm.cos_yaw() - (float)wp_nav.nav_lat * dcm.sin_yaw();
+	nav_pitch 	=  (float)wp_nav.nav_lon * dcm.sin_yaw() + (float)wp_nav.nav_lat * dcm.cos_yaw();
 
 	// flip pitch because forward is negative
 	nav_pitch = -nav_pitch;
@@ -142,97 +108,29 @@ static void calc_loiter_pitch_roll()
 
 static void calc_nav_rate(int max_speed)
 {
-	/*
-			   |< WP Radius
-	0  1   2   3   4   5   6   7   8m
-	...|...|...|...|...|...|...|...|
-		  100  |  200	  300	  400cm/s
-	           |  		 		            +|+
-	           |< we should slow to 1.5 m/s as we hit the target
-	*/
-
-	// max_speed is default 400 or 4m/s
-	// (wp_distance * 50) = 1/2 of the distance converted to speed
-	// wp_distance is always in m/s and not cm/s - I know it's stupid that way
-	// for example 4m from target = 200cm/s speed
-	// we choose the lowest speed based on disance
-	max_speed 		= min(max_speed, (wp_distance * 50));
-
-	// limit the ramp up of the speed
-	// waypoint_speed_gov is reset to 0 at each new WP command
-	if(waypoint_speed_gov < max_speed){
-		waypoint_speed_gov += (int)(100.0 * dTnav); // increase at 1.5/ms
-
-		// go at least 50cm/s
-		max_speed 		= max(50, waypoint_speed_gov);
-		// limit with governer
-		max_speed 		= min(max_speed, waypoint_speed_gov);
-	}
-
-	//float temp		= radians((target_bearing - g_gps->ground_course)/100.0);
-	float temp 		= (target_bearing - g_gps->ground_course) * RADX100;
-
 	// push us towards the original track
-	update_crosstrack();
-
-	// heading laterally, we want a zero speed here
-	x_actual_speed 	= -sin(temp) * (float)g_gps->ground_speed;
-	x_rate_error 	= crosstrack_error -x_actual_speed;
-	x_rate_error 	= constrain(x_rate_error, -800, 800);
-	nav_lon		 	= constrain(g.pi_nav_lon.get_pi(x_rate_error, dTnav), -3500, 3500);
-
-	// heading towards target
-	y_actual_speed 	= cos(temp) * (float)g_gps->ground_speed;
-	y_rate_error 	= max_speed - y_actual_speed; // 413
-	y_rate_error 	= constrain(y_rate_error, -800, 800);	// added a rate error limit to keep pitching down to a minimum
-	nav_lat		 	= constrain(g.pi_nav_lat.get_pi(y_rate_error, dTnav), -3500, 3500);
+	wp_nav.update_crosstrack(local_frame, &current_loc, &next_WP,
+							 target_bearing, original_target_bearing, g.crosstrack_gain);
 
+	wp_nav.calc_nav_rate(max_speed, wp_distance,
+						 target_bearing - g_gps->ground_course, g_gps->ground_speed, dTnav);
 
 	// nav_lat and nav_lon will be rotated to the angle of the quad in calc_nav_pitch_roll()
-
-	/*Serial.printf("max_speed: %d, xspeed: %d, yspeed: %d, x_re: %d, y_re: %d, nav_lon: %ld, nav_lat: %ld  ",
-					max_speed,
-					x_actual_speed,
-					y_actual_speed,
-					x_rate_error,
-					y_rate_error,
-					nav_lon,
-					nav_lat);*/
-}
-
-static void update_crosstrack(void)
-{
-	// Crosstrack Error
-	// ----------------
-	if (cross_track_test() < 5000) {	 // If we are too far off or too close we don't do track following
-		float temp = (target_bearing - original_target_bearing) * RADX100;
-		//radians((target_bearing - original_target_bearing) / 100)
-		crosstrack_error = sin(temp) * wp_distance;	 // Meters we are off track line
-
-		crosstrack_error = constrain(crosstrack_error * g.crosstrack_gain, -1200, 1200);
-	}
-}
-
-static int32_t cross_track_test()
-{
-	int32_t temp 	= target_bearing - original_target_bearing;
-	temp 		= wrap_180(temp);
-	return abs(temp);
 }
 
 
 // nav_roll, nav_pitch
 static void calc_nav_pitch_roll()
 {
-	float temp	 = (9000l - (dcm.yaw_sensor - target_bearing)) * RADX100;
+	float temp	 = (9000l - (dcm.yaw_sensor() - target_bearing)) * RADX100;
 	//t: 1.5465, t1: -10.9451, t2: 1.5359, t3: 1.5465
 
-	float _cos_yaw_x = cos(temp);
-	float _sin_yaw_y = sin(temp);
+	float _cos_yaw_x = fast_cos(temp);
+	float _sin_yaw_y = fast_sin(temp);
 
 	// rotate the vector
-	nav_roll 	=  (float)nav_lon * _sin_yaw_y - (float)nav_lat * _cos_yaw_x;
-	nav_pitch 	=  (float)nav_lon * _cos_yaw_x + (float)nav_lat * _sin_yaw_y;
+	nav_roll 	=  (float)wp_nav.nav_lon * _sin_yaw_y - (float)wp_nav.nav_lat * _cos_yaw_x;
+	nav_pitch 	=  (float)wp_nav.nav_lon * _cos_yaw_x + (float)wp_nav.nav_lat * _sin_yaw_y;
 
 	// flip pitch because forward is negative
 	nav_pitch = -nav_pitch;
@@ -331,9 +229,7 @@ static int32_t get_distance(struct Location *loc1, struct Location *loc2)
 	//	return -1;
 	//if(loc2->lat == 0 || loc2->lng == 0)
 	//	return -1;
-	float dlat 		= (float)(loc2->lat - loc1->lat);
-	float dlong		= ((float)(loc2->lng - loc1->lng)) * scaleLongDown;
-	return sqrt(sq(dlat) + sq(dlong)) * .01113195;
+	return local_frame.distance(loc1, loc2);
 }
 /*
 static int32_t get_alt_distance(struct Location *loc1, struct Location *loc2)
@@ -343,9 +239,5 @@ static int32_t get_alt_distance(struct Location *loc1, struct Location *loc2)
 */
 static int32_t get_bearing(struct Location *loc1, struct Location *loc2)
 {
-	int32_t off_x = loc2->lng - loc1->lng;
-	int32_t off_y = (loc2->lat - loc1->lat) * scaleLongUp;
-	int32_t bearing =	9000 + atan2(-off_y, off_x) * 5729.57795;
-	if (bearing < 0) bearing += 36000;
-	return bearing;
+	return local_frame.bearing(loc1, loc2);
 }
@@ -1003,6 +1003,10 @@ static void zero_eeprom(void)
 
 	Serial.printf_P(PSTR("\nErasing EEPROM\n"));
 
+	// don't let queued mission writes land after the erase
+	mission_write_flush();
+	invalidate_cmd_cache();
+
 	for (int i = 0; i < EEPROM_MAX_ADDR; i++) {
 		eeprom_write_byte((uint8_t *) i, b);
 	}
@@ -270,8 +270,14 @@ static void init_ardupilot()
 #endif
 
 	#if LOGGING_ENABLED == ENABLED
+	// the timer writes the log to the chip, unless there is no timer
+	// (HIL) or the APM1 flow sensor needs the SPI bus in the main loop
+	#if HIL_MODE == HIL_MODE_DISABLED && !(defined(OPTFLOW_ENABLED) && CONFIG_APM_HARDWARE == APM_HARDWARE_APM1)
+	DataFlash.Init(&timer_scheduler);
+	#else
 	DataFlash.Init();
 	#endif
+	#endif
 
 #if CLI_ENABLED == ENABLED && CLI_SLIDER_ENABLED == ENABLED
 	// If the switch is in 'menu' mode, run the main menu.
@@ -578,7 +584,7 @@ init_optflow()
 static void
 init_simple_bearing()
 {
-	initial_simple_bearing = dcm.yaw_sensor;
+	initial_simple_bearing = dcm.yaw_sensor();
 }
 
 static void
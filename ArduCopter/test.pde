@@ -344,7 +344,7 @@ static int8_t
 				medium_loopCounter++;
 				if(medium_loopCounter == 5){
 					compass.read();		 				// Read magnetometer
-					compass.calculate(dcm.roll, dcm.pitch);		// Calculate heading
+					compass.calculate(dcm.roll(), dcm.pitch());		// Calculate heading
 					compass.null_offsets(dcm.get_dcm_matrix());
 					medium_loopCounter = 0;
 				}
@@ -363,7 +363,7 @@ static int8_t
 
 			// allow us to zero out sensors with control switches
 			if(g.rc_5.control_in < 600){
-				dcm.roll_sensor = dcm.pitch_sensor = 0;
+				dcm.zero_roll_pitch();
 			}
 
 			// custom code/exceptions for flight modes
@@ -378,16 +378,16 @@ static int8_t
 			if (ts_num > 10){
 				ts_num = 0;
 				Serial.printf_P(PSTR("r: %d, p:%d, rc1:%d, "),
-					(int)(dcm.roll_sensor/100),
-					(int)(dcm.pitch_sensor/100),
+					(int)(dcm.roll_sensor()/100),
+					(int)(dcm.pitch_sensor()/100),
 					g.rc_1.pwm_out);
 
 				print_motor_out();
 			}
 			// R: 1417,  L: 1453  F: 1453  B: 1417
 
-			//Serial.printf_P(PSTR("timer: %d, r: %d\tp: %d\t y: %d\n"), (int)delta_ms_fast_loop, ((int)dcm.roll_sensor/100), ((int)dcm.pitch_sensor/100), ((uint16_t)dcm.yaw_sensor/100));
-			//Serial.printf_P(PSTR("timer: %d, r: %d\tp: %d\t y: %d\n"), (int)delta_ms_fast_loop, ((int)dcm.roll_sensor/100), ((int)dcm.pitch_sensor/100), ((uint16_t)dcm.yaw_sensor/100));
+			//Serial.printf_P(PSTR("timer: %d, r: %d\tp: %d\t y: %d\n"), (int)delta_ms_fast_loop, ((int)dcm.roll_sensor()/100), ((int)dcm.pitch_sensor()/100), ((uint16_t)dcm.yaw_sensor()/100));
+			//Serial.printf_P(PSTR("timer: %d, r: %d\tp: %d\t y: %d\n"), (int)delta_ms_fast_loop, ((int)dcm.roll_sensor()/100), ((int)dcm.pitch_sensor()/100), ((uint16_t)dcm.yaw_sensor()/100));
 
 			if(Serial.available() > 0){
 				if(g.compass_enabled){
@@ -546,16 +546,12 @@ test_dcm_eulers(uint8_t argc, const Menu::arg *argv)
 
 			medium_loopCounter++;
 
-			if(medium_loopCounter == 4){
-				update_trig();
-			}
-
 			if(medium_loopCounter == 1){
 				medium_loopCounter = 0;
 				Serial.printf_P(PSTR("dcm: %6.1f, %6.1f, %6.1f   omega: %6.1f, %6.1f, %6.1f\n"),
-								dcm.roll_sensor/100.0,
-								dcm.pitch_sensor/100.0,
-								dcm.yaw_sensor/100.0,
+								dcm.roll_sensor()/100.0,
+								dcm.pitch_sensor()/100.0,
+								dcm.yaw_sensor()/100.0,
 								degrees(omega.x),
 								degrees(omega.y),
 								degrees(omega.z));
@@ -699,15 +695,15 @@ test_omega(uint8_t argc, const Menu::arg *argv)
 		// ---
 		read_AHRS();
 
-		float my_oz = (dcm.yaw - old_yaw) * 50;
+		float my_oz = (dcm.yaw() - old_yaw) * 50;
 
-		old_yaw = dcm.yaw;
+		old_yaw = dcm.yaw();
 
 		ts_num++;
 		if (ts_num > 2){
 			ts_num = 0;
 			//Serial.printf_P(PSTR("R: %4.4f\tP: %4.4f\tY: %4.4f\tY: %4.4f\n"), omega.x, omega.y, omega.z, my_oz);
-			Serial.printf_P(PSTR(" Yaw: %ld\tY: %4.4f\tY: %4.4f\n"), dcm.yaw_sensor, omega.z, my_oz);
+			Serial.printf_P(PSTR(" Yaw: %ld\tY: %4.4f\tY: %4.4f\n"), dcm.yaw_sensor(), omega.z, my_oz);
 		}
 
 		if(Serial.available() > 0){
@@ -48,6 +48,7 @@ version 2.1 of the License, or (at your option) any later version.
 #include <AP_Relay.h>       // APM relay
 #include <AP_Mount.h>		// Camera/Antenna mount
 #include <GCS_MAVLink.h>    // MAVLink GCS definitions
+#include <AP_Scheduler.h>   // main loop task scheduler
 #include <memcheck.h>
 
 // Configuration
@@ -240,8 +241,6 @@ bool    inverted_flight     = false;
 static bool usb_connected;
 #endif
 
-static const char *comma = ",";
-
 static const char* flight_mode_strings[] = {
 	"Manual",
 	"Circle",
@@ -300,8 +299,7 @@ static bool GPS_light;							// status of the GPS light
 // GPS variables GPS
 // -------------
 static const 	float t7			= 10000000.0;	// used to scale GPS values for EEPROM storage
-static float 	scaleLongUp			= 1;			// used to reverse longitude scaling
-static float 	scaleLongDown 		= 1;			// used to reverse longitude scaling
+static LocalFrame	local_frame;					// meters north and east of home
 static byte 	ground_start_count	= 5;			// have we achieved first lock and set Home?
 static int     ground_start_avg;					// 5 samples to avg speed for ground start
 static bool	GPS_enabled 	= false;			// used to quit "looking" for gps with auto-detect if none present
@@ -313,6 +311,8 @@ const	float gravity 			= 9.81;		// meters/ sec^2
 static long	nav_bearing;						// deg * 100 : 0 to 360 current desired bearing to navigate
 static long	target_bearing;						// deg * 100 : 0 to 360 location of the plane to the target
 static long	crosstrack_bearing;					// deg * 100 : 0 to 360 desired angle of plane to target
+static float	leg_north;							// unit vector along the leg from prev_WP to next_WP
+static float	leg_east;
 static float	nav_gain_scaler 		= 1;		// Gain scaling for headwind/tailwind TODO: why does this variable need to be initialized to 1?
 static long    hold_course       	 	= -1;		// deg * 100 dir of plane
 
@@ -440,12 +440,10 @@ static uint8_t 		delta_ms_fast_loop; 		// Delta Time in miliseconds
 static int 			mainLoop_count;
 
 static unsigned long 	medium_loopTimer;			// Time in miliseconds of medium loop
-static byte 			medium_loopCounter;			// Counters for branching from main control loop to slower loops
+static byte 			medium_loopCounter;			// Counters for branching from main control loop to slower loops (test only)
 static uint8_t			delta_ms_medium_loop;
 
-static byte 			slow_loopCounter;
 static byte 			superslow_loopCounter;
-static byte			counter_one_herz;
 
 static unsigned long 	nav_loopTimer;				// used to track the elapsed time for GPS nav
 
@@ -454,6 +452,9 @@ static float 			load;						// % MCU cycles used
 
 AP_Relay relay;
 
+// Runs everything apart from the fast loop
+static AP_Scheduler scheduler;
+
 // Camera/Antenna mount tracking and stabilisation stuff /߼ܸٺȶ
 // --------------------------------------
 #if MOUNT == ENABLED
@@ -465,16 +466,48 @@ AP_Mount camera_mount(g_gps, &dcm);
 // Top-level logic ߼
 ////////////////////////////////////////////////////////////////////////////////
 
+/*
+  scheduler table - all regular tasks apart from the fast_loop()
+  should be listed here, along with how often they should be called
+  (in 20ms ticks) and the maximum time they are expected to take (in
+  microseconds). Tasks run in the order listed whenever they are due
+  and fit in what is left of the current tick.
+ */
+static const AP_Scheduler::Task scheduler_tasks[] PROGMEM = {
+#if MOUNT == ENABLED
+	{ update_mount,			  1,	 500 },
+#endif
+	{ gps_compass_loop,		 10,	2000 },
+	{ navigation_loop,		 10,	1500 },
+	{ altitude_loop,		 10,	1500 },
+	{ telemetry_loop,		 10,	2500 },
+	{ medium_loop,			 10,	 600 },
+	{ failsafe_loop,		 30,	 300 },
+	{ control_switch_loop,	 30,	 800 },
+	{ slow_loop,			 30,	1500 },
+	{ one_second_loop,		 50,	2000 },
+	{ perf_update,			 50,	 500 },
+};
+
+// what the scheduler keeps for each task in the table
+static AP_Scheduler::Task_State scheduler_state[sizeof(scheduler_tasks) / sizeof(scheduler_tasks[0])];
+
 void setup() {
 	memcheck_init();
 	init_ardupilot();
+
+	scheduler.init(scheduler_tasks, scheduler_state);
 }
 
 void loop()
 {
+	uint32_t timer;
+	uint32_t time_used;
+
 	// We want this to execute at 50Hz if possible ϣⲿ50Hzٶ
 	// -------------------------------------------
 	if (millis()-fast_loopTimer > 19) {
+		timer				= micros();
 		delta_ms_fast_loop	= millis() - fast_loopTimer;
 		load                = (float)(fast_loopTimeStamp - fast_loopTimer)/delta_ms_fast_loop;
 		G_Dt                = (float)delta_ms_fast_loop / 1000.f;
@@ -486,26 +519,11 @@ void loop()
 		// ---------------------
 		fast_loop();
 
-		// Execute the medium loop ִѭ
-		// -----------------------
-		medium_loop();
-
-		counter_one_herz++;
-		if(counter_one_herz == 50){
-			one_second_loop();
-			counter_one_herz = 0;
-		}
-
-		if (millis() - perf_mon_timer > 20000) {
-			if (mainLoop_count != 0) {
-				if (g.log_bitmask & MASK_LOG_PM)
-					#if HIL_MODE != HIL_MODE_ATTITUDE
-					Log_Write_Performance();
-					#endif
-
-				resetPerfData();
-			}
-		}
+		// Run the slower tasks in whatever is left of the 20ms slot
+		// ---------------------------------------------------------
+		scheduler.tick();
+		time_used = micros() - timer;
+		scheduler.run(time_used < 20000 ? 20000 - time_used : 0);
 
 		fast_loopTimeStamp = millis();
 	}
@@ -553,7 +571,7 @@ static void fast_loop()
 
 	# if HIL_MODE == HIL_MODE_DISABLED
 		if (g.log_bitmask & MASK_LOG_ATTITUDE_FAST)
-			Log_Write_Attitude((int)dcm.roll_sensor, (int)dcm.pitch_sensor, (uint16_t)dcm.yaw_sensor);
+			Log_Write_Attitude((int)dcm.roll_sensor(), (int)dcm.pitch_sensor(), (uint16_t)dcm.yaw_sensor());
 
 		if (g.log_bitmask & MASK_LOG_RAW)
 			Log_Write_Raw();
@@ -586,170 +604,142 @@ static void fast_loop()
     gcs_data_stream_send(45,1000);
 }
 
-static void medium_loop()
-{
 #if MOUNT == ENABLED
+static void update_mount()
+{
 	camera_mount.update_mount_position();
+}
+#else
+// the sketch prototypes ignore #if, so update_mount() has to exist
+static void update_mount() {}
 #endif
 
-	// This is the start of the medium (10 Hz) loop pieces ѭΪ10Hz
-	// -----------------------------------------
-	switch(medium_loopCounter) {
-
-		// This case deals with the GPS
-		//-------------------------------
-		case 0:
-			medium_loopCounter++;
-			if(GPS_enabled)		update_GPS();
-
-			#if HIL_MODE != HIL_MODE_ATTITUDE
-				if(g.compass_enabled){
-					compass.read();     // Read magnetometer
-					compass.calculate(dcm.get_dcm_matrix());  // Calculate heading
-					compass.null_offsets(dcm.get_dcm_matrix());
-				}
-			#endif
-/*{
-Serial.print(dcm.roll_sensor, DEC);	Serial.printf_P(PSTR("\t"));
-Serial.print(dcm.pitch_sensor, DEC);	Serial.printf_P(PSTR("\t"));
-Serial.print(dcm.yaw_sensor, DEC);	Serial.printf_P(PSTR("\t"));
-Vector3f tempaccel = imu.get_accel();
-Serial.print(tempaccel.x, DEC);	Serial.printf_P(PSTR("\t"));
-Serial.print(tempaccel.y, DEC);	Serial.printf_P(PSTR("\t"));
-Serial.println(tempaccel.z, DEC);
-}*/
-
-			break;
-
-		// This case performs some navigation computations
-		//------------------------------------------------
-		case 1:
-			medium_loopCounter++;
-
-
-			if(g_gps->new_data){
-				g_gps->new_data 	= false;
-				dTnav 				= millis() - nav_loopTimer;
-				nav_loopTimer 		= millis();
-
-				// calculate the plane's desired bearing
-				// -------------------------------------
-				navigate();
-			}
+// This deals with the GPS
+//-------------------------------
+static void gps_compass_loop()
+{
+	if(GPS_enabled)		update_GPS();
 
-			break;
-
-		// command processing
-		//------------------------------
-		case 2:
-			medium_loopCounter++;
-
-			// Read altitude from sensors
-			// ------------------
-			update_alt();
-			if(g.sonar_enabled) sonar_alt = sonar.read();
-
-			// altitude smoothing
-			// ------------------
-			if (control_mode != FLY_BY_WIRE_B)
-				calc_altitude_error();
-
-			// perform next command
-			// --------------------
-			update_commands();
-			break;
-
-		// This case deals with sending high rate telemetry
-		//-------------------------------------------------
-		case 3:
-			medium_loopCounter++;
-
-			#if HIL_MODE != HIL_MODE_ATTITUDE
-				if ((g.log_bitmask & MASK_LOG_ATTITUDE_MED) && !(g.log_bitmask & MASK_LOG_ATTITUDE_FAST))
-					Log_Write_Attitude((int)dcm.roll_sensor, (int)dcm.pitch_sensor, (uint16_t)dcm.yaw_sensor);
-
-				if (g.log_bitmask & MASK_LOG_CTUN)
-					Log_Write_Control_Tuning();
-			#endif
-
-			if (g.log_bitmask & MASK_LOG_NTUN)
-				Log_Write_Nav_Tuning();
-
-			if (g.log_bitmask & MASK_LOG_GPS)
-				Log_Write_GPS(g_gps->time, current_loc.lat, current_loc.lng, g_gps->altitude, current_loc.alt, (long) g_gps->ground_speed, g_gps->ground_course, g_gps->fix, g_gps->num_sats);
-
-            // send all requested output streams with rates requested
-            // between 5 and 45 Hz
-            gcs_data_stream_send(5,45);
-			break;
-
-		// This case controls the slow loop
-		//---------------------------------
-		case 4:
-			medium_loopCounter = 0;
-			delta_ms_medium_loop	= millis() - medium_loopTimer;
-			medium_loopTimer      	= millis();
-
-			if (g.battery_monitoring != 0){
-				read_battery();
-			}
+	#if HIL_MODE != HIL_MODE_ATTITUDE
+		if(g.compass_enabled){
+			compass.read();     // Read magnetometer
+			compass.calculate(dcm.get_dcm_matrix());  // Calculate heading
+			compass.null_offsets(dcm.get_dcm_matrix());
+		}
+	#endif
+}
 
-			slow_loop();
-			break;
+// This performs some navigation computations
+//------------------------------------------------
+static void navigation_loop()
+{
+	if(g_gps->new_data){
+		g_gps->new_data 	= false;
+		dTnav 				= millis() - nav_loopTimer;
+		nav_loopTimer 		= millis();
+
+		// calculate the plane's desired bearing
+		// -------------------------------------
+		navigate();
 	}
 }
 
-static void slow_loop()
+// command processing
+//------------------------------
+static void altitude_loop()
 {
-	// This is the slow (3 1/3 Hz) loop pieces ѭΪ33֮1
-	//----------------------------------------
-	switch (slow_loopCounter){
-		case 0:
-			slow_loopCounter++;
-			check_long_failsafe();
-			superslow_loopCounter++;
-			if(superslow_loopCounter >=200) {				//	200 = Execute every minute
-				#if HIL_MODE != HIL_MODE_ATTITUDE
-					if(g.compass_enabled) {
-						compass.save_offsets();
-					}
-				#endif
+	// Read altitude from sensors
+	// ------------------
+	update_alt();
+	if(g.sonar_enabled) sonar_alt = sonar.read();
+
+	// altitude smoothing
+	// ------------------
+	if (control_mode != FLY_BY_WIRE_B)
+		calc_altitude_error();
 
-				superslow_loopCounter = 0;
+	// perform next command
+	// --------------------
+	update_commands();
+}
+
+// This deals with sending high rate telemetry
+//-------------------------------------------------
+static void telemetry_loop()
+{
+	#if HIL_MODE != HIL_MODE_ATTITUDE
+		if ((g.log_bitmask & MASK_LOG_ATTITUDE_MED) && !(g.log_bitmask & MASK_LOG_ATTITUDE_FAST))
+			Log_Write_Attitude((int)dcm.roll_sensor(), (int)dcm.pitch_sensor(), (uint16_t)dcm.yaw_sensor());
+
+		if (g.log_bitmask & MASK_LOG_CTUN)
+			Log_Write_Control_Tuning();
+	#endif
+
+	if (g.log_bitmask & MASK_LOG_NTUN)
+		Log_Write_Nav_Tuning();
+
+	if (g.log_bitmask & MASK_LOG_GPS)
+		Log_Write_GPS(g_gps->time, current_loc.lat, current_loc.lng, g_gps->altitude, current_loc.alt, (long) g_gps->ground_speed, g_gps->ground_course, g_gps->fix, g_gps->num_sats);
+
+    // send all requested output streams with rates requested
+    // between 5 and 45 Hz
+    gcs_data_stream_send(5,45);
+}
+
+static void medium_loop()
+{
+	delta_ms_medium_loop	= millis() - medium_loopTimer;
+	medium_loopTimer      	= millis();
+
+	if (g.battery_monitoring != 0){
+		read_battery();
+	}
+}
+
+// This is the slow (3 1/3 Hz) loop pieces ѭΪ33֮1
+//----------------------------------------
+static void failsafe_loop()
+{
+	check_long_failsafe();
+	superslow_loopCounter++;
+	if(superslow_loopCounter >=200) {				//	200 = Execute every minute
+		#if HIL_MODE != HIL_MODE_ATTITUDE
+			if(g.compass_enabled) {
+				compass.save_offsets();
 			}
-			break;
+		#endif
 
-		case 1:
-			slow_loopCounter++;
+		superslow_loopCounter = 0;
+	}
+}
 
-			// Read 3-position switch on radio
-			// -------------------------------
-			read_control_switch();
+static void control_switch_loop()
+{
+	// Read 3-position switch on radio
+	// -------------------------------
+	read_control_switch();
 
-			// Read Control Surfaces/Mix switches
-			// ----------------------------------
-			update_servo_switches();
+	// Read Control Surfaces/Mix switches
+	// ----------------------------------
+	update_servo_switches();
 
-			update_aux_servo_function(&g.rc_5, &g.rc_6, &g.rc_7, &g.rc_8);
+	update_aux_servo_function(&g.rc_5, &g.rc_6, &g.rc_7, &g.rc_8);
 
 #if MOUNT == ENABLED
-			camera_mount.update_mount_type();
+	camera_mount.update_mount_type();
 #endif
-			break;
+}
 
-		case 2:
-			slow_loopCounter = 0;
-			update_events();
+static void slow_loop()
+{
+	update_events();
 
-            mavlink_system.sysid = g.sysid_this_mav;		// This is just an ugly hack to keep mavlink_system.sysid sync'd with our parameter
-            gcs_data_stream_send(3,5);
+    mavlink_system.sysid = g.sysid_this_mav;		// This is just an ugly hack to keep mavlink_system.sysid sync'd with our parameter
+    gcs_data_stream_send(3,5);
 
 #if USB_MUX_PIN > 0
-            check_usb_mux();
+    check_usb_mux();
 #endif
-
-			break;
-	}
 }
 
 static void one_second_loop()
@@ -762,6 +752,20 @@ static void one_second_loop()
     gcs_data_stream_send(1,3);
 }
 
+static void perf_update()
+{
+	if (millis() - perf_mon_timer > 20000) {
+		if (mainLoop_count != 0) {
+			if (g.log_bitmask & MASK_LOG_PM)
+				#if HIL_MODE != HIL_MODE_ATTITUDE
+				Log_Write_Performance();
+				#endif
+
+			resetPerfData();
+		}
+	}
+}
+
 static void update_GPS(void)
 {
 	g_gps->update();
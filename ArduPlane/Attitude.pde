@@ -38,7 +38,7 @@ static void stabilize()
         // handle this is to ensure both go in the same direction from
         // zero
         nav_roll += 18000;
-        if (dcm.roll_sensor < 0) nav_roll -= 36000;
+        if (dcm.roll_sensor() < 0) nav_roll -= 36000;
     }
 
 	// For Testing Only
@@ -48,11 +48,11 @@ static void stabilize()
 
 	// Calculate dersired servo output for the roll
 	// ---------------------------------------------
-	g.channel_roll.servo_out = g.pidServoRoll.get_pid((nav_roll - dcm.roll_sensor), delta_ms_fast_loop, speed_scaler);
+	g.channel_roll.servo_out = g.pidServoRoll.get_pid((nav_roll - dcm.roll_sensor()), delta_ms_fast_loop, speed_scaler);
 	long tempcalc = nav_pitch +
-	        fabs(dcm.roll_sensor * g.kff_pitch_compensation) +
+	        fabs(dcm.roll_sensor() * g.kff_pitch_compensation) +
 	        (g.channel_throttle.servo_out * g.kff_throttle_to_pitch) -
-	        (dcm.pitch_sensor - g.pitch_trim);
+	        (dcm.pitch_sensor() - g.pitch_trim);
     if (inverted_flight) {
         // when flying upside down the elevator control is inverted
         tempcalc = -tempcalc;
@@ -114,7 +114,7 @@ static void stabilize()
 
 static void crash_checker()
 {
-	if(dcm.pitch_sensor < -4500){
+	if(dcm.pitch_sensor() < -4500){
 		crash_timer = 255;
 	}
 	if(crash_timer > 0)
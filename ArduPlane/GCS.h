@@ -121,6 +121,20 @@ public:
 private:
 	void 	handleMessage(mavlink_message_t * msg);
 
+	/// Parse a block of received bytes, handling each message in it
+	void	receive_bytes(const uint8_t *buf, uint16_t len);
+
+	/// mavlink_parse_buffer() callback, gcs is the GCS_MAVLINK
+	static uint8_t _handle_message(void *gcs, mavlink_message_t *msg, uint16_t used);
+
+	/// A block of the receive buffer is being parsed in place, and
+	/// _rx_used bytes of it have been handled. A nested ::update from
+	/// mavlink_delay() releases those bytes and parses the rest itself,
+	/// setting _rx_released to stop the outer parse
+	bool		_rx_in_block;
+	bool		_rx_released;
+	uint16_t	_rx_used;
+
 	/// Perform queued sending operations
 	///
 
@@ -112,9 +112,9 @@ static NOINLINE void send_attitude(mavlink_channel_t chan)
     mavlink_msg_attitude_send(
         chan,
         micros(),
-        dcm.roll,
-        dcm.pitch,
-        dcm.yaw,
+        dcm.roll(),
+        dcm.pitch(),
+        dcm.yaw(),
         omega.x,
         omega.y,
         omega.z);
@@ -281,7 +281,7 @@ static void NOINLINE send_meminfo(mavlink_channel_t chan)
 
 static void NOINLINE send_location(mavlink_channel_t chan)
 {
-    Matrix3f rot = dcm.get_dcm_matrix(); // neglecting angle of attack for now
+    const Matrix3f &rot = dcm.get_dcm_matrix(); // neglecting angle of attack for now
     mavlink_msg_global_position_int_send(
         chan,
         millis(),
@@ -408,7 +408,7 @@ static void NOINLINE send_vfr_hud(mavlink_channel_t chan)
         chan,
         (float)airspeed / 100.0,
         (float)g_gps->ground_speed / 100.0,
-        (dcm.yaw_sensor / 100) % 360,
+        (dcm.yaw_sensor() / 100) % 360,
         (uint16_t)(100 * g.channel_throttle.norm_output()),
         current_loc.alt / 100.0,
         0);
@@ -618,6 +618,267 @@ static bool mavlink_try_send_message(mavlink_channel_t chan, enum ap_message id,
 }
 
 
+#if LOGGING_ENABLED == ENABLED
+/*
+  log download. LOG_REQUEST_LIST and LOG_REQUEST_DATA set up a
+  transfer, which mavlink_send_message() then feeds with whatever tx
+  space the link has left once the deferred messages have gone, so a
+  download runs at the full link rate without holding up anything
+  else. LOG_DATA carries the raw DataFlash pages of a log,
+  page headers included, so the downloaded file is a page image that
+  Tools/LogDecode reads as is. A new LOG_REQUEST_DATA replaces the one
+  being served, which is how a GCS fills in anything it missed.
+
+  Reading the chip shares its buffers and file number with the writer,
+  so logging stops for the transfer, and a new log is started when the
+  GCS sends LOG_REQUEST_END or goes quiet.
+ */
+#define LOG_READ_NONE 0xFFFFFFFFUL
+
+static struct log_transfer {
+    bool        active;         // logging is stopped for a transfer
+    uint8_t     chan;           // channel being served
+    bool        listing;        // sending LOG_ENTRYs
+    bool        sending;        // sending LOG_DATA
+    uint16_t    num_logs;
+    uint16_t    list_next;      // next LOG_ENTRY to send
+    uint16_t    list_last;      // last LOG_ENTRY to send
+    uint16_t    log_id;         // log the fields below are for, 0 for none
+    uint16_t    start_page;     // its first page
+    uint32_t    size;           // its size in bytes
+    uint32_t    ofs;            // offset of the next LOG_DATA
+    uint32_t    end;            // offset the request ends at
+    uint32_t    read_ofs;       // offset of the next DataFlash.ReadByte()
+    uint32_t    last_ms;        // time of the last request or packet
+} log_transfer;
+
+// first page and size in bytes of a log
+static uint32_t mavlink_log_size(uint16_t log_num, uint16_t *start)
+{
+    int start_page, end_page;
+    uint16_t pages;
+
+    get_log_boundaries(log_num, start_page, end_page);
+    if (end_page >= start_page) {
+        pages = end_page - start_page + 1;
+    } else {
+        // the log wraps around the end of the chip
+        pages = DF_LAST_PAGE - start_page + 1 + end_page;
+    }
+    *start = start_page;
+    return (uint32_t)pages * DataFlash.df_PageSize;
+}
+
+// the plane has no arming, so take it to be flying when the throttle
+// is up or it is moving faster than a ground start allows
+static bool mavlink_log_flying(void)
+{
+    return g.channel_throttle.servo_out > 0 || g_gps->ground_speed > SPEEDFILT;
+}
+
+// start serving log requests on chan, stopping logging while we do
+static bool mavlink_log_begin(mavlink_channel_t chan)
+{
+    if (mavlink_log_flying()) {
+        // never turn logging off in flight
+        return false;
+    }
+    if (!log_transfer.active) {
+        DataFlash.StopWrite();
+        log_transfer.num_logs = get_num_logs();
+        log_transfer.log_id = 0;
+    }
+    log_transfer.active = true;
+    log_transfer.chan = chan;
+    log_transfer.listing = false;
+    log_transfer.sending = false;
+    log_transfer.read_ofs = LOG_READ_NONE;
+    log_transfer.last_ms = millis();
+    return true;
+}
+
+// the GCS is done with the logs: go back to logging
+static void mavlink_log_end(void)
+{
+    if (!log_transfer.active) {
+        return;
+    }
+    log_transfer.active = false;
+    log_transfer.listing = false;
+    log_transfer.sending = false;
+    if (g.log_bitmask != 0) {
+        start_new_log();
+    }
+}
+
+static void mavlink_log_request_list(mavlink_channel_t chan, uint16_t start, uint16_t end)
+{
+    uint16_t first;
+
+    if (!mavlink_log_begin(chan)) {
+        return;
+    }
+    // num_logs is only known once the transfer has begun
+    first = g.log_last_filenumber - log_transfer.num_logs + 1;
+    if (log_transfer.num_logs == 0) {
+        // a single empty entry says there are no logs
+        start = end = 0;
+    } else {
+        if (start < first) {
+            start = first;
+        }
+        if (end > g.log_last_filenumber) {
+            end = g.log_last_filenumber;
+        }
+        if (start > end) {
+            return;
+        }
+    }
+    log_transfer.list_next = start;
+    log_transfer.list_last = end;
+    log_transfer.listing = true;
+}
+
+static void mavlink_log_request_data(mavlink_channel_t chan, uint16_t id, uint32_t ofs, uint32_t count)
+{
+    if (!mavlink_log_begin(chan)) {
+        return;
+    }
+    if (id > g.log_last_filenumber || id <= g.log_last_filenumber - log_transfer.num_logs) {
+        return;
+    }
+    if (id != log_transfer.log_id) {
+        log_transfer.size = mavlink_log_size(id, &log_transfer.start_page);
+        log_transfer.log_id = id;
+    }
+    log_transfer.ofs = ofs;
+    log_transfer.end = log_transfer.size;
+    if (ofs < log_transfer.size && count < log_transfer.size - ofs) {
+        log_transfer.end = ofs + count;
+    }
+    log_transfer.sending = true;
+}
+
+/*
+  the byte at offset ofs of the log being sent. Reads carry on from
+  the last one where they can, as starting a read costs a page
+  transfer. The first four bytes of each page are its file number and
+  file page, which the library reads for us when it loads the page.
+ */
+static uint8_t mavlink_log_byte(uint32_t ofs)
+{
+    uint16_t page_size = DataFlash.df_PageSize;
+    uint16_t idx = ofs % page_size;
+    uint32_t page_ofs = ofs - idx;
+    uint16_t page = log_transfer.start_page + ofs / page_size;
+    uint8_t b;
+
+    if (page > DF_LAST_PAGE) {
+        page -= DF_LAST_PAGE;
+    }
+    if (DataFlash.GetPage() != page || log_transfer.read_ofs != max(ofs, page_ofs + 4)) {
+        DataFlash.StartRead(page);
+        log_transfer.read_ofs = page_ofs + 4;
+    }
+    if (idx < 4) {
+        uint16_t v = idx < 2 ? DataFlash.GetFileNumber() : DataFlash.GetFilePage();
+        return (idx & 1) ? (v & 0xFF) : (v >> 8);
+    }
+    while (log_transfer.read_ofs < ofs) {
+        DataFlash.ReadByte();
+        log_transfer.read_ofs++;
+    }
+    b = DataFlash.ReadByte();
+    log_transfer.read_ofs++;
+    if (idx == page_size - 1) {
+        // ReadByte() has moved on to the next page, past its header
+        log_transfer.read_ofs += 4;
+    }
+    return b;
+}
+
+static void NOINLINE send_log_entry(mavlink_channel_t chan)
+{
+    uint16_t id = log_transfer.list_next;
+    uint16_t start;
+    uint32_t size = 0;
+
+    if (id != 0) {
+        size = mavlink_log_size(id, &start);
+        // the boundary search moved the read
+        log_transfer.read_ofs = LOG_READ_NONE;
+    }
+    mavlink_msg_log_entry_send(
+        chan,
+        id,
+        log_transfer.num_logs,
+        g.log_last_filenumber,
+        size);
+}
+
+static void NOINLINE send_log_data(mavlink_channel_t chan, uint8_t count)
+{
+    uint8_t data[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN];
+
+    for (uint8_t i = 0; i < count; i++) {
+        data[i] = mavlink_log_byte(log_transfer.ofs + i);
+    }
+    memset(&data[count], 0, sizeof(data) - count);
+    mavlink_msg_log_data_send(
+        chan,
+        log_transfer.log_id,
+        log_transfer.ofs,
+        count,
+        data);
+}
+
+// send as much of the log transfer on chan as the serial tx buffer takes
+static void mavlink_log_send(mavlink_channel_t chan)
+{
+    uint16_t length;
+
+    if (!log_transfer.active || log_transfer.chan != chan) {
+        return;
+    }
+
+    if (log_transfer.listing) {
+        // one entry at a time, as finding the boundaries of a log
+        // takes a few dozen page reads
+        length = MAVLINK_MSG_ID_LOG_ENTRY_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        if (comm_get_txspace(chan) < (int)length) {
+            return;
+        }
+        send_log_entry(chan);
+        log_transfer.last_ms = millis();
+        if (log_transfer.list_next++ == log_transfer.list_last) {
+            log_transfer.listing = false;
+        }
+        return;
+    }
+
+    length = MAVLINK_MSG_ID_LOG_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    while (log_transfer.sending && comm_get_txspace(chan) >= (int)length) {
+        uint8_t count = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+
+        if (log_transfer.ofs >= log_transfer.end) {
+            // a zero length packet marks the end of the log, the end of
+            // a shorter request needs nothing
+            count = 0;
+            log_transfer.sending = false;
+            if (log_transfer.end < log_transfer.size) {
+                break;
+            }
+        } else if (log_transfer.end - log_transfer.ofs < count) {
+            count = log_transfer.end - log_transfer.ofs;
+        }
+        send_log_data(chan, count);
+        log_transfer.ofs += count;
+        log_transfer.last_ms = millis();
+    }
+}
+#endif // LOGGING_ENABLED
+
+
 #define MAX_DEFERRED_MESSAGES MSG_RETRY_DEFERRED
 static struct mavlink_queue {
     enum ap_message deferred_messages[MAX_DEFERRED_MESSAGES];
@@ -646,6 +907,12 @@ static void mavlink_send_message(mavlink_channel_t chan, enum ap_message id, uin
     }
 
     if (id == MSG_RETRY_DEFERRED) {
+#if LOGGING_ENABLED == ENABLED
+        // a log download gets whatever is left over
+        if (q->num_deferred_messages == 0) {
+            mavlink_log_send(chan);
+        }
+#endif
         return;
     }
 
@@ -734,24 +1001,30 @@ GCS_MAVLINK::init(FastSerial * port)
 	_queued_parameter = NULL;
 }
 
+uint8_t
+GCS_MAVLINK::_handle_message(void *gcs, mavlink_message_t *msg, uint16_t used)
+{
+    GCS_MAVLINK *g = (GCS_MAVLINK *)gcs;
+
+    mavlink_active = 1;
+    g->_rx_used = used;
+    g->handleMessage(msg);
+
+    // stop if a nested update has taken over the rest of the block
+    return !g->_rx_released;
+}
+
 void
-GCS_MAVLINK::update(void)
+GCS_MAVLINK::receive_bytes(const uint8_t *buf, uint16_t len)
 {
-    // receive new packets
-    mavlink_message_t msg;
     mavlink_status_t status;
-	status.packet_rx_drop_count = 0;
-
-    // process received bytes
-    while (comm_get_available(chan))
-    {
-        uint8_t c = comm_receive_ch(chan);
 
 #if CLI_ENABLED == ENABLED
-        /* allow CLI to be started by hitting enter 3 times, if no
-           heartbeat packets have been received */
-        if (mavlink_active == 0) {
-            if (c == '\n' || c == '\r') {
+    /* allow CLI to be started by hitting enter 3 times, if no
+       heartbeat packets have been received */
+    if (mavlink_active == 0) {
+        for (uint16_t i = 0; i < len; i++) {
+            if (buf[i] == '\n' || buf[i] == '\r') {
                 crlf_count++;
             } else {
                 crlf_count = 0;
@@ -760,23 +1033,74 @@ GCS_MAVLINK::update(void)
                 run_cli();
             }
         }
+    }
 #endif
 
-        // Try to get a new message
-        if (mavlink_parse_char(chan, c, &msg, &status)) {
-            mavlink_active = 1;
-            handleMessage(&msg);
-        }
-    }
+    // Try to get new messages
+    status.packet_rx_drop_count = 0;
+    mavlink_parse_buffer(chan, buf, len, &status, _handle_message, this);
 
     // Update packet drops counter
     packet_drops += status.packet_rx_drop_count;
+}
+
+void
+GCS_MAVLINK::update(void)
+{
+    const uint8_t *buf;
+    uint16_t nbytes;
+    bool released = _rx_released;
+
+    if (_rx_in_block) {
+        // called from mavlink_delay() while a message in the middle of
+        // a block is handled. Release the block up to the end of that
+        // message, so that what follows it is parsed here and the outer
+        // update stops
+        comm_receive_done(chan, _rx_used);
+        _rx_in_block = false;
+        released = true;
+    }
+
+    // process received bytes a block at a time, straight out of the
+    // serial receive buffer
+    while ((buf = comm_receive_block(chan, &nbytes)) != NULL && nbytes != 0) {
+        _rx_in_block = true;
+        _rx_released = false;
+        receive_bytes(buf, nbytes);
+        if (_rx_in_block) {
+            _rx_in_block = false;
+            comm_receive_done(chan, nbytes);
+        }
+    }
+    _rx_released = released;
+
+    // ports that can't lend out their buffer go a byte at a time
+    if (buf == NULL) {
+        while (comm_get_available(chan)) {
+            uint8_t c = comm_receive_ch(chan);
+            receive_bytes(&c, 1);
+        }
+    }
 
     // send out queued params/ waypoints
     if (NULL != _queued_parameter) {
         send_message(MSG_NEXT_PARAM);
     }
 
+#if LOGGING_ENABLED == ENABLED
+    // keep a log download going, or end it if the GCS has gone away
+    // or the plane has started flying
+    if (log_transfer.active && log_transfer.chan == chan) {
+        if (mavlink_log_flying() ||
+            (!log_transfer.listing && !log_transfer.sending &&
+             millis() - log_transfer.last_ms > LOG_TRANSFER_TIMEOUT)) {
+            mavlink_log_end();
+        } else {
+            send_message(MSG_RETRY_DEFERRED);
+        }
+    }
+#endif
+
     if (!waypoint_receiving && !waypoint_sending) {
         return;
     }
@@ -1431,6 +1755,35 @@ void GCS_MAVLINK::handleMessage(mavlink_message_t* msg)
             break;
         }
 
+#if LOGGING_ENABLED == ENABLED
+    case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+    {
+        mavlink_log_request_list_t packet;
+        mavlink_msg_log_request_list_decode(msg, &packet);
+        if (mavlink_check_target(packet.target_system,packet.target_component)) break;
+        mavlink_log_request_list(chan, packet.start, packet.end);
+        break;
+    }
+
+    case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+    {
+        mavlink_log_request_data_t packet;
+        mavlink_msg_log_request_data_decode(msg, &packet);
+        if (mavlink_check_target(packet.target_system,packet.target_component)) break;
+        mavlink_log_request_data(chan, packet.id, packet.ofs, packet.count);
+        break;
+    }
+
+    case MAVLINK_MSG_ID_LOG_REQUEST_END:
+    {
+        mavlink_log_request_end_t packet;
+        mavlink_msg_log_request_end_decode(msg, &packet);
+        if (mavlink_check_target(packet.target_system,packet.target_component)) break;
+        mavlink_log_end();
+        break;
+    }
+#endif
+
 #ifdef MAVLINK_MSG_ID_SET_MAG_OFFSETS
     case MAVLINK_MSG_ID_SET_MAG_OFFSETS:
     {
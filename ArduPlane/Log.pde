@@ -9,6 +9,33 @@
 #define HEAD_BYTE2 	0x95	// Decimal 149
 #define END_BYTE	0xBA	// Decimal 186
 
+// The format of each message the Log_Write_ functions below write, see
+// struct Log_Format in DataFlash.h. The lengths and formats must match
+// what the functions write. The table is written at the start of every
+// log, and is what the CLI dump uses to print the packets.
+static const struct Log_Format log_formats[] PROGMEM = {
+	{ LOG_ATTITUDE_MSG,			6,	"ATT",	"hhH",
+	  "Roll,Pitch,Yaw" },
+	{ LOG_GPS_MSG,				32,	"GPS",	"IBBLLheeee",
+	  "Time,Fix,NSats,Lat,Lng,Sonar,Alt,GPSAlt,Spd,Crs" },
+	{ LOG_MODE_MSG,				1,	"MODE",	"M",
+	  "Mode" },
+	{ LOG_CONTROL_TUNING_MSG,	18,	"CTUN",	"ccccccchh",
+	  "SRoll,NRoll,Roll,SPitch,NPitch,Pitch,SThr,SRud,AccY" },
+	{ LOG_NAV_TUNING_MSG,		14,	"NTUN",	"ChCCcch",
+	  "Yaw,WpDist,TBrg,NBrg,AltErr,Arspd,NGain" },
+	{ LOG_PERFORMANCE_MSG,		25,	"PM",	"IHHBBBBBhhhhhH",
+	  "Time,Loop,DtMx,GSat,ADC,RSqt,RBlw,GFix,Hlth,IntX,IntY,IntZ,PM1,SchOvr" },
+	{ LOG_RAW_MSG,				24,	"RAW",	"LLLLLL",
+	  "GyrX,GyrY,GyrZ,AccX,AccY,AccZ" },
+	{ LOG_CMD_MSG,				15,	"CMD",	"BBBiii",
+	  "Num,Id,P1,Alt,Lat,Lng" },
+	{ LOG_CURRENT_MSG,			8,	"CURR",	"hcch",
+	  "Thr,Volt,Curr,CurrTot" },
+	{ LOG_STARTUP_MSG,			2,	"STRT",	"BB",
+	  "Type,NCmd" }
+};
+
 
 // These are function definitions so the Menu can be constructed before the functions
 // are defined below. Order matters to the compiler.
@@ -45,16 +72,22 @@ static const struct Menu::command log_menu_commands[] PROGMEM = {
 // A Macro to create the Menu
 MENU2(log_menu, "Log", log_menu_commands, print_log_menu);
 
-static void get_log_boundaries(byte log_num, int & start_page, int & end_page);
+static void get_log_boundaries(uint16_t log_num, int & start_page, int & end_page);
+
+// the log directory, see log_dir_load()
+#define LOG_DIR_MAGIC	0x4C44		// "LD"
+#define LOG_DIR_LOGS	32			// the most logs it lists
+
+static bool		log_writing;		// start_new_log() has started the writer
+static uint16_t	log_search_end;		// end of the newest log found by log_end_page(), 0 before the search
 
 static bool
 print_log_menu(void)
 {
-	int log_start;
-	int log_end;
-	int temp;	
-	
-	uint16_t num_logs = get_num_logs();
+	uint16_t log_start[LOG_DIR_LOGS];
+	uint16_t log_end;
+
+	uint8_t num_logs = log_dir_load(log_start, &log_end);
 
 	Serial.printf_P(PSTR("logs enabled: "));
 
@@ -86,15 +119,11 @@ print_log_menu(void)
 	}else{
 		Serial.printf_P(PSTR("\n%d logs\n"), num_logs);
 
-		for(int i=num_logs;i>=1;i--) {
-            int last_log_start = log_start, last_log_end = log_end;
-			temp = g.log_last_filenumber-i+1;
-			get_log_boundaries(temp, log_start, log_end);
-			Serial.printf_P(PSTR("Log %d,    start %d,   end %d\n"), temp, log_start, log_end);
-            if (last_log_start == log_start && last_log_end == log_end) {
-                // we are printing bogus logs
-                break;
-            }
+		for(int i=0;i<num_logs;i++) {
+			Serial.printf_P(PSTR("Log %d,    start %d,   end %d\n"),
+							g.log_last_filenumber-num_logs+i+1,
+							log_start[i],
+							i == num_logs-1 ? log_end : log_prev_page(log_start[i+1]));
 		}
 		Serial.println();
 	}
@@ -107,7 +136,7 @@ dump_log(uint8_t argc, const Menu::arg *argv)
 	int dump_log;
 	int dump_log_start;
 	int dump_log_end;
-	byte last_log_num;
+	int last_log_num;
 
 	// check that the requested log number can be read
 	dump_log = argv[1].i;
@@ -137,15 +166,16 @@ erase_logs(uint8_t argc, const Menu::arg *argv)
 {
 	Serial.printf_P(PSTR("\nErasing log...\n"));
 	DataFlash.SetFileNumber(0xFFFF);
-	for(int j = 1; j <= DF_LAST_PAGE; j++) {
+	for(int j = 1; j < DF_NUM_PAGES; j++) {		// the logs and the log directory
 		DataFlash.PageErase(j);
 		DataFlash.StartWrite(j);		// We need this step to clean FileNumbers
 		if(j%128 == 0) Serial.printf_P(PSTR("+"));
 	}
 	g.log_last_filenumber.set_and_save(0);
+	log_search_end = 0;
 
 	Serial.printf_P(PSTR("\nLog erased.\n"));
-	DataFlash.FinishWrite();
+	DataFlash.StopWrite();
     return 0;
 }
 
@@ -200,102 +230,190 @@ process_logs(uint8_t argc, const Menu::arg *argv)
 }
 
 
-// This function determines the number of whole or partial log files in the DataFlash
-// Wholly overwritten files are (of course) lost.
-static byte get_num_logs(void)
-{
-	uint16_t lastpage;
-	uint16_t last;
-	uint16_t first;
+// The log directory lives in the DF_DIR_PAGES pages after DF_LAST_PAGE.
+// Each copy lists the start pages of the logs on the chip, oldest first,
+// so that finding a log takes a page read instead of searches over the
+// whole chip. start_new_log() writes a new copy for each log, into the
+// page picked by the log's number, which spreads the writes over all of
+// the directory pages.
+//
+// A log ends on the page before the next one starts. The end of the
+// newest log comes from the writer once logging has started, and from a
+// search of that log's own pages before then.
 
-	if(g.log_last_filenumber < 1) return 0;
+// page holding the directory written when log_num was started
+static uint16_t log_dir_page(uint16_t log_num)
+{
+	return DF_DIR_PAGE + log_num % DF_DIR_PAGES;
+}
 
-	DataFlash.StartRead(1);
-	
-	if(DataFlash.GetFileNumber() == 0XFFFF) return 0;
+// the page before page, wrapping around the log pages
+static uint16_t log_prev_page(uint16_t page)
+{
+	return page > 1 ? page - 1 : DF_LAST_PAGE;
+}
 
-	lastpage = find_last();
-	DataFlash.StartRead(lastpage);
-	last = DataFlash.GetFileNumber();
-	DataFlash.StartRead(lastpage + 2);
-	first = DataFlash.GetFileNumber();
-	if(first > last) {
-		DataFlash.StartRead(1);
-		first = DataFlash.GetFileNumber();
+// the number of pages from start to end, wrapping around the log pages
+static uint16_t log_pages(uint16_t start, uint16_t end)
+{
+	if (end >= start) {
+		return end - start + 1;
 	}
-	if(last == first)
-	{
-		return 1;
+	return DF_LAST_PAGE - start + 1 + end;
+}
+
+// This function finds the last page of the newest log, given its first page
+static uint16_t log_end_page(uint16_t start)
+{
+	uint16_t end;
+
+	if (log_writing) {
+		end = log_prev_page(DataFlash.GetWritePage());
 	} else {
-		return (last - first + 1);
+		if (log_search_end == 0) {
+			// the pages of the newest log hold its number and the
+			// count of pages since its start, up to where it ends
+			uint16_t bottom = 0;
+			uint16_t top = DF_LAST_PAGE;
+			uint16_t look;
+
+			while (top - bottom > 1) {
+				look = (top + bottom) / 2;
+				DataFlash.StartRead((start - 1 + look) % DF_LAST_PAGE + 1);
+				if (DataFlash.GetFileNumber() == (uint16_t)g.log_last_filenumber &&
+					DataFlash.GetFilePage() == look + 1) {
+					bottom = look;
+				} else {
+					top = look;
+				}
+			}
+			log_search_end = (start - 1 + bottom) % DF_LAST_PAGE + 1;
+		}
+		end = log_search_end;
+	}
+	if (end == log_prev_page(start)) {
+		// nothing of it has been written out yet
+		end = start;
+	}
+	return end;
+}
+
+// This function reads the log directory into start[], oldest log first,
+// leaving out the logs the newer ones have since written over, and
+// returns the number of logs. end is set to the last page of the newest log.
+static uint8_t log_dir_load(uint16_t *start, uint16_t *end)
+{
+	uint8_t n, first;
+	uint16_t pages;
+
+	if (g.log_last_filenumber < 1) return 0;
+
+	// the directory can't be read while the log is being written
+	if (!DataFlash.StartRead(log_dir_page(g.log_last_filenumber)) ||
+		DataFlash.GetFileNumber() != 0 ||
+		(uint16_t)DataFlash.ReadInt() != LOG_DIR_MAGIC ||
+		DataFlash.ReadInt() != g.log_last_filenumber) {
+		return 0;
+	}
+	pages = DataFlash.ReadInt();
+	if (pages == 0 || pages > LOG_DIR_LOGS) return 0;
+	n = pages;
+	for (uint8_t i = 0; i < n; i++) {
+		start[i] = DataFlash.ReadInt();
+		if (start[i] < 1 || start[i] > DF_LAST_PAGE) return 0;
 	}
+	*end = log_end_page(start[n-1]);
+
+	// go back from the newest log until the logs after one cover the chip
+	first = n - 1;
+	pages = log_pages(start[first], *end);
+	while (first > 0 && pages < DF_LAST_PAGE) {
+		first--;
+		pages += log_pages(start[first], log_prev_page(start[first+1]));
+	}
+	if (pages > DF_LAST_PAGE) {
+		// the oldest log has lost its first pages
+		start[first] = *end % DF_LAST_PAGE + 1;
+	}
+	n -= first;
+	memmove(start, &start[first], n * sizeof(start[0]));
+	return n;
+}
+
+// This function writes a new copy of the log directory, for the newest log
+static void log_dir_write(const uint16_t *start, uint8_t n)
+{
+	DataFlash.SetFileNumber(0);		// not a log, so nothing reads it as one
+	DataFlash.StartWrite(log_dir_page(g.log_last_filenumber));
+	DataFlash.WriteInt(LOG_DIR_MAGIC);
+	DataFlash.WriteInt(g.log_last_filenumber);
+	DataFlash.WriteInt(n);
+	for (uint8_t i = 0; i < n; i++) {
+		DataFlash.WriteInt(start[i]);
+	}
+	DataFlash.StopWrite();
+}
+
+// This function determines the number of whole or partial log files in the DataFlash
+// Wholly overwritten files are (of course) lost.
+static byte get_num_logs(void)
+{
+	uint16_t start[LOG_DIR_LOGS];
+	uint16_t end;
+
+	return log_dir_load(start, &end);
 }
 
 // This function starts a new log file in the DataFlash
 static void start_new_log()
 {
-	uint16_t	last_page = find_last();
-	if(last_page == 1) last_page = 0;
-	
+	uint16_t start[LOG_DIR_LOGS];
+	uint16_t end;
+	uint8_t n;
+
+	n = log_dir_load(start, &end);
+	if (n == 0) {
+		// no directory, as after erasing the logs or loading this
+		// code; start after whatever is on the chip
+		end = find_last();
+		if(end == 1) end = DF_LAST_PAGE;
+	} else if (n == LOG_DIR_LOGS) {
+		// the directory is full, forget the oldest log
+		n--;
+		memmove(start, &start[1], n * sizeof(start[0]));
+	}
+	start[n++] = end % DF_LAST_PAGE + 1;
+
 	g.log_last_filenumber.set_and_save(g.log_last_filenumber+1);
+	log_dir_write(start, n);
+	log_writing = true;
+
 	DataFlash.SetFileNumber(g.log_last_filenumber);
-	DataFlash.StartWrite(last_page + 1);
+	DataFlash.StartWrite(start[n-1]);
+	Log_Write_Formats();
 }
 
 // This function finds the first and last pages of a log file
 // The first page may be greater than the last page if the DataFlash has been filled and partially overwritten.
-static void get_log_boundaries(byte log_num, int & start_page, int & end_page)
-{
-	int num = get_num_logs();
-	int look;
-	
-	if(num == 1)
-	{
-		DataFlash.StartRead(DF_LAST_PAGE);
-		if(DataFlash.GetFileNumber() == 0xFFFF)
-		{
-			start_page = 1;
-			end_page = find_last_log_page((uint16_t)log_num);
-		} else {
-			end_page = find_last_log_page((uint16_t)log_num);
-			start_page = end_page + 1;
-		}
-
+static void get_log_boundaries(uint16_t log_num, int & start_page, int & end_page)
+{
+	uint16_t start[LOG_DIR_LOGS];
+	uint16_t end;
+	uint8_t n;
+	int i;
+
+	n = log_dir_load(start, &end);
+	i = n - 1 - (g.log_last_filenumber - log_num);
+	if (i < 0 || i >= n) {
+		// not a log we have
+		start_page = end_page = 1;
 	} else {
-		if(log_num==1) {
-			DataFlash.StartRead(DF_LAST_PAGE);
-			if(DataFlash.GetFileNumber() == 0xFFFF) {
-				start_page = 1;
-			} else {
-				start_page = find_last() + 1;
-			}
-		 } else {
-			if(log_num == g.log_last_filenumber - num + 1) {
-				start_page = find_last() + 1;
-			} else {
-				look = log_num-1;
-				do {
-				start_page = find_last_log_page(look) + 1;
-				look--;
-				} while (start_page <= 0);
-			}
-		}
+		start_page = start[i];
+		end_page = (i == n - 1) ? end : log_prev_page(start[i+1]);
 	}
-	if(start_page == DF_LAST_PAGE+1 || start_page == 0) start_page=1;
-	end_page = find_last_log_page((uint16_t)log_num);
-	if(end_page <= 0) end_page = start_page;
 }
 
-static bool check_wrapped(void)
-{
-	DataFlash.StartRead(DF_LAST_PAGE);
-	if(DataFlash.GetFileNumber() == 0xFFFF)
-		return 0;
-	else
-		return 1;
-}
-
-// This function finds the last page of the last file
+// This function finds the last page of the last file, for when there is no log directory
 static int find_last(void)
 {
 uint16_t look;
@@ -336,59 +454,6 @@ uint32_t top_hash;
 		}
 }
 
-// This function finds the last page of a particular log file
-static int find_last_log_page(uint16_t log_number)
-{
-
-uint16_t look;
-uint16_t bottom;
-uint16_t top;
-uint32_t look_hash;
-uint32_t check_hash;
-
-	if(check_wrapped())
-	{
-		DataFlash.StartRead(1);
-		bottom = DataFlash.GetFileNumber();
-		if (bottom > log_number)
-		{
-			bottom = find_last();
-			top = DF_LAST_PAGE;
-		} else {
-			bottom = 1;
-			top = find_last();
-		}
-	} else {
-		bottom = 1;
-		top = find_last();
-	}
-
-	check_hash = (long)log_number<<16 | 0xFFFF;
-		
-	while(top-bottom > 1)
-	{
-		look = (top+bottom)/2;
-		DataFlash.StartRead(look);
-		look_hash = (long)DataFlash.GetFileNumber()<<16 | DataFlash.GetFilePage();
-		if (look_hash >= 0xFFFF0000) look_hash = 0;
-		
-		if(look_hash > check_hash) {
-			// move down
-			top = look;
-		} else {
-			// move up
-			bottom = look;
-		}
-	}
-		
-	DataFlash.StartRead(top);
-	if (DataFlash.GetFileNumber() == log_number) return top;
-	
-	DataFlash.StartRead(bottom);
-	if (DataFlash.GetFileNumber() == log_number) return bottom;
-	
-	return -1;
-}
 
 
 // Write an attitude packet. Total length : 10 bytes
@@ -423,6 +488,7 @@ static void Log_Write_Performance()
 	DataFlash.WriteInt((int)(dcm.get_integrator().y * 1000));
 	DataFlash.WriteInt((int)(dcm.get_integrator().z * 1000));
 	DataFlash.WriteInt(pmTest1);
+	DataFlash.WriteInt(scheduler.total_overruns());
 	DataFlash.WriteByte(END_BYTE);
 }
 #endif
@@ -474,10 +540,10 @@ static void Log_Write_Control_Tuning()
 	DataFlash.WriteByte(LOG_CONTROL_TUNING_MSG);
 	DataFlash.WriteInt((int)(g.channel_roll.servo_out));
 	DataFlash.WriteInt((int)nav_roll);
-	DataFlash.WriteInt((int)dcm.roll_sensor);
+	DataFlash.WriteInt((int)dcm.roll_sensor());
 	DataFlash.WriteInt((int)(g.channel_pitch.servo_out));
 	DataFlash.WriteInt((int)nav_pitch);
-	DataFlash.WriteInt((int)dcm.pitch_sensor);
+	DataFlash.WriteInt((int)dcm.pitch_sensor());
 	DataFlash.WriteInt((int)(g.channel_throttle.servo_out));
 	DataFlash.WriteInt((int)(g.channel_rudder.servo_out));
 	DataFlash.WriteInt((int)(accel.y * 10000));
@@ -491,7 +557,7 @@ static void Log_Write_Nav_Tuning()
 	DataFlash.WriteByte(HEAD_BYTE1);
 	DataFlash.WriteByte(HEAD_BYTE2);
 	DataFlash.WriteByte(LOG_NAV_TUNING_MSG);
-	DataFlash.WriteInt((uint16_t)dcm.yaw_sensor);
+	DataFlash.WriteInt((uint16_t)dcm.yaw_sensor());
 	DataFlash.WriteInt((int)wp_distance);
 	DataFlash.WriteInt((uint16_t)target_bearing);
 	DataFlash.WriteInt((uint16_t)nav_bearing);
@@ -566,145 +632,99 @@ static void Log_Write_Current()
 	DataFlash.WriteByte(END_BYTE);
 }
 
-// Read a Current packet
-static void Log_Read_Current()
-{
-	Serial.printf_P(PSTR("CURR: %d, %4.4f, %4.4f, %d\n"),
-			DataFlash.ReadInt(),
-			((float)DataFlash.ReadInt() / 100.f),
-			((float)DataFlash.ReadInt() / 100.f),
-			DataFlash.ReadInt());
-}
+#define LOG_NUM_FORMATS	(sizeof(log_formats) / sizeof(log_formats[0]))
 
-// Read an control tuning packet
-static void Log_Read_Control_Tuning()
+// Write a format record for each message type at the start of the log,
+// so the log can be decoded without this version of the code. There are
+// more of them than the DataFlash ring holds, so they go to the chip
+// directly
+static void Log_Write_Formats()
 {
-	float logvar;
+	DataFlash.SyncWrite(true);
+	for (uint8_t i = 0; i < LOG_NUM_FORMATS; i++) {
+		PGM_P p = (PGM_P)&log_formats[i];
 
-	Serial.printf_P(PSTR("CTUN:"));
-	for (int y = 1; y < 10; y++) {
-		logvar = DataFlash.ReadInt();
-		if(y < 8) logvar 	= logvar/100.f;
-		if(y == 9) logvar 	= logvar/10000.f;
-		Serial.print(logvar);
-		Serial.print(comma);
+		DataFlash.WriteByte(HEAD_BYTE1);
+		DataFlash.WriteByte(HEAD_BYTE2);
+		DataFlash.WriteByte(LOG_FORMAT_MSG);
+		for (uint8_t j = 0; j < sizeof(struct Log_Format); j++) {
+			DataFlash.WriteByte(pgm_read_byte(p + j));
+		}
+		DataFlash.WriteByte(END_BYTE);
 	}
-	Serial.println(" ");
-}
-
-// Read a nav tuning packet
-static void Log_Read_Nav_Tuning()
-{
-	Serial.printf_P(PSTR("NTUN: %4.4f, %d, %4.4f, %4.4f, %4.4f, %4.4f, %4.4f,\n"),		// \n
-				(float)((uint16_t)DataFlash.ReadInt())/100.0,
-				DataFlash.ReadInt(),
-				(float)((uint16_t)DataFlash.ReadInt())/100.0,
-				(float)((uint16_t)DataFlash.ReadInt())/100.0,
-				(float)DataFlash.ReadInt()/100.0,
-				(float)DataFlash.ReadInt()/100.0,
-				(float)DataFlash.ReadInt()/1000.0);
+	DataFlash.SyncWrite(false);
 }
 
-// Read a performance packet
-static void Log_Read_Performance()
+// Find the format of a message type. Returns false for an unknown type
+static bool Log_Find_Format(byte type, struct Log_Format *fmt)
 {
-	long pm_time;
-	int logvar;
-
-	Serial.printf_P(PSTR("PM:"));
-	pm_time = DataFlash.ReadLong();
-	Serial.print(pm_time);
-	Serial.print(comma);
-	for (int y = 1; y <= 12; y++) {
-		if(y < 3 || y > 7){
-			logvar = DataFlash.ReadInt();
-		}else{
-			logvar = DataFlash.ReadByte();
+	for (uint8_t i = 0; i < LOG_NUM_FORMATS; i++) {
+		if (pgm_read_byte((PGM_P)&log_formats[i].type) == type) {
+			memcpy_P(fmt, (PGM_P)&log_formats[i], sizeof(*fmt));
+			return true;
 		}
-		Serial.print(logvar);
-		Serial.print(comma);
 	}
-	Serial.println(" ");
+	return false;
 }
 
-// Read a command processing packet
-static void Log_Read_Cmd()
+// Print a fixed point field with the given number of decimal places
+static void Log_Print_Fixed(int32_t value, uint8_t places)
 {
-	byte logvarb;
-	long logvarl;
+	uint32_t	u = value;
+	uint32_t	scale = 1;
 
-	Serial.printf_P(PSTR("CMD:"));
-	for(int i = 1; i < 4; i++) {
-		logvarb = DataFlash.ReadByte();
-		Serial.print(logvarb, DEC);
-		Serial.print(comma);
+	for (uint8_t i = 0; i < places; i++) {
+		scale *= 10;
 	}
-	for(int i = 1; i < 4; i++) {
-		logvarl = DataFlash.ReadLong();
-		Serial.print(logvarl, DEC);
-		Serial.print(comma);
+	if (value < 0) {
+		u = -u;
+	}
+	Serial.printf_P(PSTR(", %s%lu."), value < 0 ? "-" : "", (unsigned long)(u / scale));
+	u %= scale;
+	for (scale /= 10; scale > 0; scale /= 10) {
+		Serial.print((char)('0' + (u / scale) % 10));
 	}
-	Serial.println(" ");
-}
-
-static void Log_Read_Startup()
-{
-	byte logbyte = DataFlash.ReadByte();
-
-	if (logbyte == TYPE_AIRSTART_MSG)
-		Serial.printf_P(PSTR("AIR START - "));
-	else if (logbyte == TYPE_GROUNDSTART_MSG)
-		Serial.printf_P(PSTR("GROUND START - "));
-	else
-		Serial.printf_P(PSTR("UNKNOWN STARTUP - "));
-
-	Serial.printf_P(PSTR(" %d commands in memory\n"),(int)DataFlash.ReadByte());
-}
-
-// Read an attitude packet
-static void Log_Read_Attitude()
-{
-	Serial.printf_P(PSTR("ATT: %d, %d, %u\n"),
-			DataFlash.ReadInt(),
-			DataFlash.ReadInt(),
-			(uint16_t)DataFlash.ReadInt());
 }
 
-// Read a mode packet
-static void Log_Read_Mode()
-{
-	Serial.printf_P(PSTR("MOD:"));
-	Serial.println(flight_mode_strings[DataFlash.ReadByte()]);
+// Read a packet and print its fields as described by its format
+static void Log_Read_Packet(const struct Log_Format *fmt)
+{
+	Serial.print(fmt->name);
+	for (uint8_t i = 0; i < sizeof(fmt->format) && fmt->format[i]; i++) {
+		switch (fmt->format[i]) {
+			case 'b': Serial.printf_P(PSTR(", %d"), (int8_t)DataFlash.ReadByte());					break;
+			case 'B': Serial.printf_P(PSTR(", %u"), DataFlash.ReadByte());							break;
+			case 'h': Serial.printf_P(PSTR(", %d"), DataFlash.ReadInt());							break;
+			case 'H': Serial.printf_P(PSTR(", %u"), (uint16_t)DataFlash.ReadInt());				break;
+			case 'i': Serial.printf_P(PSTR(", %ld"), (long)DataFlash.ReadLong());					break;
+			case 'I': Serial.printf_P(PSTR(", %lu"), (unsigned long)(uint32_t)DataFlash.ReadLong());	break;
+			case 'c': Log_Print_Fixed(DataFlash.ReadInt(), 2);										break;
+			case 'C': Log_Print_Fixed((uint16_t)DataFlash.ReadInt(), 2);							break;
+			case 'e': Log_Print_Fixed(DataFlash.ReadLong(), 2);									break;
+			case 'L': Log_Print_Fixed(DataFlash.ReadLong(), 7);									break;
+			case 'M':
+				Serial.printf_P(PSTR(", "));
+				Serial.print(flight_mode_strings[DataFlash.ReadByte()]);
+				break;
+		}
+	}
+	Serial.println();
 }
 
-// Read a GPS packet
-static void Log_Read_GPS()
+// Read a format record and print it
+static void Log_Read_Format()
 {
-	Serial.printf_P(PSTR("GPS: %ld, %d, %d, %4.7f, %4.7f, %4.4f, %4.4f, %4.4f, %4.4f, %4.4f\n"),
-			DataFlash.ReadLong(),
-			(int)DataFlash.ReadByte(),
-			(int)DataFlash.ReadByte(),
-			(float)DataFlash.ReadLong() / t7,
-			(float)DataFlash.ReadLong() / t7,
-			(float)DataFlash.ReadInt(),				// This one is just temporary for testing out sonar in fixed wing
-			(float)DataFlash.ReadLong() / 100.0,
-			(float)DataFlash.ReadLong() / 100.0,
-			(float)DataFlash.ReadLong() / 100.0,
-			(float)DataFlash.ReadLong() / 100.0);
+	struct Log_Format	fmt;
+	uint8_t				*p = (uint8_t *)&fmt;
 
-}
-
-// Read a raw accel/gyro packet
-static void Log_Read_Raw()
-{
-	float logvar;
-	Serial.printf_P(PSTR("RAW:"));
-	for (int y = 0; y < 6; y++) {
-		logvar = (float)DataFlash.ReadLong() / t7;
-		Serial.print(logvar);
-		Serial.print(comma);
+	for (uint8_t i = 0; i < sizeof(fmt); i++) {
+		p[i] = DataFlash.ReadByte();
 	}
-	Serial.println(" ");
+	fmt.name[sizeof(fmt.name) - 1] = 0;
+	fmt.format[sizeof(fmt.format) - 1] = 0;
+	fmt.labels[sizeof(fmt.labels) - 1] = 0;
+	Serial.printf_P(PSTR("FMT, %u, %u, %s, %s, %s\n"),
+					fmt.type, fmt.length, fmt.name, fmt.format, fmt.labels);
 }
 
 // Read the DataFlash log memory : Packet Parser
@@ -737,8 +757,12 @@ static int Log_Read_Process(int start_page, int end_page)
 	byte log_step = 0;
 	int page = start_page;
 	int packet_count = 0;
+	struct Log_Format fmt;
 
-	DataFlash.StartRead(start_page);
+	if (!DataFlash.StartRead(start_page)) {
+		// still logging
+		return 0;
+	}
 	while (page < end_page && page != -1){
 		data = DataFlash.ReadByte();
 
@@ -755,49 +779,15 @@ static int Log_Read_Process(int start_page, int end_page)
 					log_step = 0;
 				break;
 			case 2:
-				if(data == LOG_ATTITUDE_MSG){
-					Log_Read_Attitude();
+				if(data == LOG_FORMAT_MSG){
+					Log_Read_Format();
 					log_step++;
-
-				}else if(data == LOG_MODE_MSG){
-					Log_Read_Mode();
+				}else if(Log_Find_Format(data, &fmt)){
+					Log_Read_Packet(&fmt);
 					log_step++;
-
-				}else if(data == LOG_CONTROL_TUNING_MSG){
-					Log_Read_Control_Tuning();
-					log_step++;
-
-				}else if(data == LOG_NAV_TUNING_MSG){
-					Log_Read_Nav_Tuning();
-					log_step++;
-
-				}else if(data == LOG_PERFORMANCE_MSG){
-					Log_Read_Performance();
-					log_step++;
-
-				}else if(data == LOG_RAW_MSG){
-					Log_Read_Raw();
-					log_step++;
-
-				}else if(data == LOG_CMD_MSG){
-					Log_Read_Cmd();
-					log_step++;
-
-				}else if(data == LOG_CURRENT_MSG){
-					Log_Read_Current();
-					log_step++;
-
-				}else if(data == LOG_STARTUP_MSG){
-					Log_Read_Startup();
-					log_step++;
-				}else {
-					if(data == LOG_GPS_MSG){
-						Log_Read_GPS();
-						log_step++;
-					}else{
-						Serial.printf_P(PSTR("Error Reading Packet: %d\n"),packet_count);
-						log_step = 0;	 // Restart, we have a problem...
-					}
+				}else{
+					Serial.printf_P(PSTR("Error Reading Packet: %d\n"),packet_count);
+					log_step = 0;	 // Restart, we have a problem...
 				}
 				break;
 			case 3:
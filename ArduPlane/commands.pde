@@ -176,10 +176,10 @@ static void set_next_WP(struct Location *wp)
 	loiter_sum 			= 0;
 	loiter_total 		= 0;
 
-	// this is used to offset the shrinking longitude as we go towards the poles
-	float rads 			= (fabs((float)next_WP.lat)/t7) * 0.0174532925;
-	scaleLongDown 		= cos(rads);
-	scaleLongUp 		= 1.0f/cos(rads);	
+	// until there is a home, measure from the WP
+	if (!home_is_set)
+		local_frame.set_origin(&next_WP);
+
 	// this is handy for the groundstation
 	wp_totalDistance 	= get_distance(&current_loc, &next_WP);
 	wp_distance 		= wp_totalDistance;
@@ -210,10 +210,9 @@ static void set_guided_WP(void)
 	target_altitude = current_loc.alt;
 	offset_altitude = next_WP.alt - prev_WP.alt;
 
-	// this is used to offset the shrinking longitude as we go towards the poles
-	float rads 			= (abs(next_WP.lat)/t7) * 0.0174532925;
-	scaleLongDown 		= cos(rads);
-	scaleLongUp 		= 1.0f/cos(rads);
+	// until there is a home, measure from the WP
+	if (!home_is_set)
+		local_frame.set_origin(&next_WP);
 
 	// this is handy for the groundstation
 	wp_totalDistance 	= get_distance(&current_loc, &next_WP);
@@ -246,6 +245,7 @@ void init_home()
 	home.lat 	= g_gps->latitude;				// Lat * 10**7
 	home.alt 	= max(g_gps->altitude, 0);
 	home_is_set = true;
+	local_frame.set_origin(&home);
 
     gcs_send_text_fmt(PSTR("gps alt: %lu"), (unsigned long)home.alt);
 
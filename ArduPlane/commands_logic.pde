@@ -293,7 +293,7 @@ static bool verify_takeoff()
 		if(hold_course == -1){
 			// save our current course to take off
 			if(g.compass_enabled) {
-				hold_course = dcm.yaw_sensor;
+				hold_course = dcm.yaw_sensor();
 			} else {
 				hold_course = g_gps->ground_course;
 			}
@@ -516,6 +516,7 @@ static void do_set_home()
 		home.lat 	= next_nonnav_command.lat;				// Lat * 10**7
 		home.alt 	= max(next_nonnav_command.alt, 0);
 		home_is_set = true;
+		local_frame.set_origin(&home);
 	}
 }
 
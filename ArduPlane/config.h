@@ -770,3 +770,9 @@
 #ifndef MAVLINK_TELEMETRY_PORT_DELAY
 # define MAVLINK_TELEMETRY_PORT_DELAY 2000
 #endif
+
+// a log download the GCS has gone quiet on is ended after this many
+// milliseconds, so that logging can't be left off
+#ifndef LOG_TRANSFER_TIMEOUT
+# define LOG_TRANSFER_TIMEOUT 10000
+#endif
@@ -77,7 +77,7 @@ static void calc_airspeed_errors()
 static void calc_bearing_error()
 {
 	if(takeoff_complete == true  || g.compass_enabled == true) {
-		bearing_error = nav_bearing - dcm.yaw_sensor;
+		bearing_error = nav_bearing - dcm.yaw_sensor();
 	} else {
 
 		// TODO: we need to use the Yaw gyro for in between GPS reads,
@@ -175,15 +175,32 @@ static void update_crosstrack(void)
 	// Crosstrack Error
 	// ----------------
 	if (abs(wrap_180(target_bearing - crosstrack_bearing)) < 4500) {	 // If we are too far off or too close we don't do track following
-		crosstrack_error = sin(radians((target_bearing - crosstrack_bearing) / (float)100)) * (float)wp_distance;	 // Meters we are off track line
+		// the sin of the angle between us and the leg, times the
+		// distance to go, is the cross product of the leg with the
+		// vector to the WP
+		Vector2f to_wp = local_frame.offset(&current_loc, &next_WP);
+		crosstrack_error = to_wp.y * leg_north - to_wp.x * leg_east;	 // Meters we are off track line
 		nav_bearing += constrain(crosstrack_error * g.crosstrack_gain, -g.crosstrack_entry_angle.get(), g.crosstrack_entry_angle.get());
 		nav_bearing = wrap_360(nav_bearing);
 	}
 }
 
+// work out the direction of the leg from prev_WP to next_WP once, when
+// it is set, so update_crosstrack() doesn't need any trig
 static void reset_crosstrack()
 {
 	crosstrack_bearing 	= get_bearing(&prev_WP, &next_WP);	// Used for track following
+
+	Vector2f leg 	= local_frame.offset(&prev_WP, &next_WP);
+	float length 	= leg.length();
+	if (length < 1) {
+		// no track to follow
+		leg_north 	= 0;
+		leg_east 	= 0;
+	} else {
+		leg_north 	= leg.x / length;
+		leg_east 	= leg.y / length;
+	}
 }
 
 static long get_distance(struct Location *loc1, struct Location *loc2)
@@ -192,16 +209,10 @@ static long get_distance(struct Location *loc1, struct Location *loc2)
 		return -1;
 	if(loc2->lat == 0 || loc2->lng == 0)
 		return -1;
-	float dlat 		= (float)(loc2->lat - loc1->lat);
-	float dlong		= ((float)(loc2->lng - loc1->lng)) * scaleLongDown;
-	return sqrt(sq(dlat) + sq(dlong)) * .01113195;
+	return local_frame.distance(loc1, loc2);
 }
 
 static long get_bearing(struct Location *loc1, struct Location *loc2)
 {
-	long off_x = loc2->lng - loc1->lng;
-	long off_y = (loc2->lat - loc1->lat) * scaleLongUp;
-	long bearing =	9000 + atan2(-off_y, off_x) * 5729.57795;
-	if (bearing < 0) bearing += 36000;
-	return bearing;
+	return local_frame.bearing(loc1, loc2);
 }
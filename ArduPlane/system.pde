@@ -190,7 +190,11 @@ static void init_ardupilot()
 #endif
 
 #if LOGGING_ENABLED == ENABLED
+#if HIL_MODE != HIL_MODE_ATTITUDE
+	DataFlash.Init(&timer_scheduler); 	// DataFlash log initialization, written by the timer
+#else
 	DataFlash.Init(); 	// DataFlash log initialization
+#endif
 #endif
 
 	// Do GPS init
@@ -536,9 +536,9 @@ test_imu(uint8_t argc, const Menu::arg *argv)
 			// We are using the IMU
 			// ---------------------
 			Serial.printf_P(PSTR("r: %d\tp: %d\t y: %d\n"),
-								(int)dcm.roll_sensor / 100,
-								(int)dcm.pitch_sensor / 100,
-								(uint16_t)dcm.yaw_sensor / 100);
+								(int)dcm.roll_sensor() / 100,
+								(int)dcm.pitch_sensor() / 100,
+								(uint16_t)dcm.yaw_sensor() / 100);
 		}
 		if(Serial.available() > 0){
 			return (0);
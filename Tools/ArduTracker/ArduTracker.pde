@@ -471,7 +471,7 @@ void fast_loop()
 
 # if HIL_MODE == HIL_MODE_DISABLED
 		//if (get(PARAM_LOG_BITMASK) & MASK_LOG_ATTITUDE_FAST)
-			//Log_Write_Attitude((int)dcm.roll_sensor, (int)dcm.pitch_sensor, (uint16_t)dcm.yaw_sensor);
+			//Log_Write_Attitude((int)dcm.roll_sensor(), (int)dcm.pitch_sensor(), (uint16_t)dcm.yaw_sensor());
 
 		//if (get(PARAM_LOG_BITMASK) & MASK_LOG_RAW)
 			//Log_Write_Raw();
@@ -538,7 +538,7 @@ void medium_loop()
 
 			#if HIL_MODE != HIL_MODE_ATTITUDE && MAGNETOMETER == 1
 				//compass.read();     // Read magnetometer
-				//compass.calculate(dcm.roll,dcm.pitch);  // Calculate heading
+				//compass.calculate(dcm.roll(),dcm.pitch());  // Calculate heading
 			#endif
 
 			break;
@@ -575,7 +575,7 @@ void medium_loop()
 			medium_loopCounter++;
 
 			//if ((get(PARAM_LOG_BITMASK) & MASK_LOG_ATTITUDE_MED) && !(get(PARAM_LOG_BITMASK) & MASK_LOG_ATTITUDE_FAST))
-				//Log_Write_Attitude((int)dcm.roll_sensor, (int)dcm.pitch_sensor, (uint16_t)dcm.yaw_sensor);
+				//Log_Write_Attitude((int)dcm.roll_sensor(), (int)dcm.pitch_sensor(), (uint16_t)dcm.yaw_sensor());
 
 #if HIL_MODE != HIL_MODE_ATTITUDE
 			//if (get(PARAM_LOG_BITMASK) & MASK_LOG_CTUN)
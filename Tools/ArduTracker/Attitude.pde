@@ -35,8 +35,8 @@ void stabilize()
 
 	// Calculate dersired servo output for the roll 
 	// ---------------------------------------------
-	servo_out[CH_ROLL]	= pidServoRoll.get_pid((nav_roll - dcm.roll_sensor), deltaMiliSeconds, speed_scaler);
-	servo_out[CH_PITCH] = pidServoPitch.get_pid((nav_pitch + fabs(dcm.roll_sensor * get(PARAM_KFF_PTCHCOMP)) - (dcm.pitch_sensor - get(PARAM_TRIM_PITCH))), deltaMiliSeconds, speed_scaler);
+	servo_out[CH_ROLL]	= pidServoRoll.get_pid((nav_roll - dcm.roll_sensor()), deltaMiliSeconds, speed_scaler);
+	servo_out[CH_PITCH] = pidServoPitch.get_pid((nav_pitch + fabs(dcm.roll_sensor() * get(PARAM_KFF_PTCHCOMP)) - (dcm.pitch_sensor() - get(PARAM_TRIM_PITCH))), deltaMiliSeconds, speed_scaler);
 	//Serial.print(" servo_out[CH_ROLL] ");
 	//Serial.print(servo_out[CH_ROLL],DEC);
 
@@ -93,7 +93,7 @@ void stabilize()
 
 void crash_checker()
 {
-	if(dcm.pitch_sensor < -4500){
+	if(dcm.pitch_sensor() < -4500){
 		crash_timer = 255;
 	}
 	if(crash_timer > 0)
@@ -780,9 +780,9 @@ GCS_DEBUGTERMINAL::run_debugt_command(char *buf)
 #endif
 			port->printf_P(PSTR("nav_pitch (%.2f) - pitch_sensor (%.2f) + pitch_comp (%.2f) = %.2f\n"),
 						   (float)nav_pitch / 100,
-						   (float)dcm.pitch_sensor / 100,
-						   fabs(dcm.roll_sensor * get(PARAM_KFF_PTCHCOMP)) / 100,
-						   (float)(nav_pitch-dcm.pitch_sensor + fabs(dcm.roll_sensor * get(PARAM_KFF_PTCHCOMP))) / 100);
+						   (float)dcm.pitch_sensor() / 100,
+						   fabs(dcm.roll_sensor() * get(PARAM_KFF_PTCHCOMP)) / 100,
+						   (float)(nav_pitch-dcm.pitch_sensor() + fabs(dcm.roll_sensor() * get(PARAM_KFF_PTCHCOMP))) / 100);
 			port->printf_P(PSTR("servo_out[CH_PITCH] (%.2f) = PID[nav_pitch + pitch_comp - pitch_sensor]"),
 						   (float)servo_out[CH_PITCH] / 100);
 
@@ -792,8 +792,8 @@ GCS_DEBUGTERMINAL::run_debugt_command(char *buf)
 			port->printf_P(PSTR("bearing_error (%ld) = nav_bearing (%ld) - yaw_sensor (%ld)\n"
 								"nav_roll (%ld) - roll_sensor (%ld) = %ld\n"
 								"servo_out[CH_ROLL] = %d\n"),
-						   bearing_error, nav_bearing, dcm.yaw_sensor,
-						   nav_roll, dcm.roll_sensor, nav_roll - dcm.roll_sensor,
+						   bearing_error, nav_bearing, dcm.yaw_sensor(),
+						   nav_roll, dcm.roll_sensor(), nav_roll - dcm.roll_sensor(),
 						   servo_out[CH_ROLL]);
 
 		//------- status pid {servoroll|servopitch|servorudder|navroll|navpitchasp|navpitchalt|throttlete|throttlealt} -------
@@ -1388,7 +1388,7 @@ GCS_DEBUGTERMINAL::print_attitude(void)
 						 "%ld nav_roll, %d loiter_sum, "
 						 "%d roll servo_out, %d pitch_servo_out\n"),
 					radio_in[CH_ROLL], radio_in[CH_PITCH], radio_in[CH_THROTTLE],
-					dcm.roll_sensor, dcm.pitch_sensor,
+					dcm.roll_sensor(), dcm.pitch_sensor(),
 					gps.ground_course, target_bearing,
 					nav_roll, loiter_sum,
 					servo_out[CH_ROLL], servo_out[CH_PITCH]);
@@ -1448,8 +1448,8 @@ void
 GCS_DEBUGTERMINAL::print_tuning(void) 
 {
 	_port->printf_P(PSTR("TUN:%d,    %ld,     %ld,    %d,    %ld,    %ld\n"),
-					servo_out[CH_ROLL],  nav_roll  / 100, dcm.roll_sensor  / 100,
-					servo_out[CH_PITCH], nav_pitch / 100, dcm.pitch_sensor / 100);					
+					servo_out[CH_ROLL],  nav_roll  / 100, dcm.roll_sensor()  / 100,
+					servo_out[CH_PITCH], nav_pitch / 100, dcm.pitch_sensor() / 100);					
 }
 
 void
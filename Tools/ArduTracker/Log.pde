@@ -259,10 +259,10 @@ void Log_Write_Control_Tuning()
 	DataFlash.WriteByte(LOG_CONTROL_TUNING_MSG);
 	DataFlash.WriteInt((int)(servo_out[CH_ROLL]));
 	DataFlash.WriteInt((int)nav_roll);
-	DataFlash.WriteInt((int)dcm.roll_sensor);
+	DataFlash.WriteInt((int)dcm.roll_sensor());
 	DataFlash.WriteInt((int)(servo_out[CH_PITCH]));
 	DataFlash.WriteInt((int)nav_pitch);
-	DataFlash.WriteInt((int)dcm.pitch_sensor);
+	DataFlash.WriteInt((int)dcm.pitch_sensor());
 	DataFlash.WriteInt((int)(servo_out[CH_THROTTLE]));
 	DataFlash.WriteInt((int)(servo_out[CH_RUDDER]));
 	DataFlash.WriteInt((int)(accel.y*10000));  
@@ -276,7 +276,7 @@ void Log_Write_Nav_Tuning()
 	DataFlash.WriteByte(HEAD_BYTE1);
 	DataFlash.WriteByte(HEAD_BYTE2);
 	DataFlash.WriteByte(LOG_NAV_TUNING_MSG);
-	DataFlash.WriteInt((uint16_t)dcm.yaw_sensor);
+	DataFlash.WriteInt((uint16_t)dcm.yaw_sensor());
 	DataFlash.WriteInt((int)wp_distance);
 	DataFlash.WriteInt((uint16_t)target_bearing);
 	DataFlash.WriteInt((uint16_t)nav_bearing);
@@ -112,14 +112,14 @@ void mavlink_send_message(mavlink_channel_t chan, uint8_t id, uint32_t param, ui
     case MSG_ATTITUDE:
     {
 		Vector3f omega = dcm.get_gyro();
-        mavlink_msg_attitude_send(chan,timeStamp,dcm.roll,dcm.pitch,dcm.yaw,
+        mavlink_msg_attitude_send(chan,timeStamp,dcm.roll(),dcm.pitch(),dcm.yaw(),
 		omega.x,omega.y,omega.z);
         break;
     }
     case MSG_LOCATION:
     {
-        float gamma = dcm.pitch; // neglecting angle of attack for now
-		float yaw = dcm.yaw;
+        float gamma = dcm.pitch(); // neglecting angle of attack for now
+		float yaw = dcm.yaw();
         mavlink_msg_global_position_send(chan,timeStamp,current_loc.lat/1.0e7,
 			current_loc.lng/1.0e7,current_loc.alt/1.0e2,gps.ground_speed/1.0e2*cos(gamma)*cos(yaw),
 			gps.ground_speed/1.0e2*cos(gamma)*sin(yaw),gps.ground_speed/1.0e2*sin(gamma));
@@ -127,8 +127,8 @@ void mavlink_send_message(mavlink_channel_t chan, uint8_t id, uint32_t param, ui
     }
     case MSG_LOCAL_LOCATION:
     {
-        float gamma = dcm.pitch; // neglecting angle of attack for now
-		float yaw = dcm.yaw;
+        float gamma = dcm.pitch(); // neglecting angle of attack for now
+		float yaw = dcm.yaw();
         mavlink_msg_local_position_send(chan,timeStamp,ToRad((current_loc.lat-home.lat)/1.0e7)*radius_of_earth,
 			ToRad((current_loc.lng-home.lng)/1.0e7)*radius_of_earth*cos(ToRad(home.lat/1.0e7)),
 			(current_loc.alt-home.alt)/1.0e2, gps.ground_speed/1.0e2*cos(gamma)*cos(yaw),
@@ -346,7 +346,7 @@ void verify_must()
 				if(hold_course == -1){
 					// save our current course to take off
 					#if MAGNETOMETER == ENABLED
-					hold_course = dcm.yaw_sensor;
+					hold_course = dcm.yaw_sensor();
 					#else
 						hold_course = gps.ground_course;
 					#endif
@@ -111,7 +111,7 @@ void calc_airspeed_errors()
 void calc_bearing_error()
 {
 	if(takeoff_complete == true  || MAGNETOMETER == ENABLED) {
-	bearing_error = nav_bearing - dcm.yaw_sensor;
+	bearing_error = nav_bearing - dcm.yaw_sensor();
 	} else {
 		bearing_error = nav_bearing - gps.ground_course;
 	}
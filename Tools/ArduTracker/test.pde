@@ -370,14 +370,14 @@ test_imu(uint8_t argc, const Menu::arg *argv)
 				medium_loopCounter++;
 				if(medium_loopCounter == 5){
 					compass.read();		 				// Read magnetometer
-					compass.calculate(dcm.roll, dcm.pitch);		// Calculate heading
+					compass.calculate(dcm.roll(), dcm.pitch());		// Calculate heading
 					medium_loopCounter = 0;
 				}
 			#endif
 			
 			// We are using the IMU
 			// ---------------------
-			Serial.printf_P(PSTR("r: %d\tp: %d\t y: %d\n"), ((int)dcm.roll_sensor/100), ((int)dcm.pitch_sensor/100), ((uint16_t)dcm.yaw_sensor/100));
+			Serial.printf_P(PSTR("r: %d\tp: %d\t y: %d\n"), ((int)dcm.roll_sensor()/100), ((int)dcm.pitch_sensor()/100), ((uint16_t)dcm.yaw_sensor()/100));
 	
 		}
 		if(Serial.available() > 0){
@@ -0,0 +1,174 @@
+/*
+  LogDecode - decode a DataFlash log image on the host
+
+  Reads a dataflash.bin from the desktop build, or an image of the
+  DataFlash read off a board, and writes the packets of the logs in it
+  as CSV. Each log starts with the FMT records the firmware wrote (see
+  struct Log_Format in libraries/DataFlash/DataFlash.h), so the decoder
+  needs no knowledge of the messages of any particular firmware.
+
+  usage: LogDecode [options] IMAGE
+	-l		list the logs in the image and exit
+	-n LOG	only decode log number LOG
+	-p SIZE	page size of the image, default 512
+	-r		IMAGE is a plain stream of packets, without page headers
+	-d DIR	write one CSV file per log and message type into DIR,
+			with a header line of field names, instead of writing
+			all packets to stdout as NAME,field,field...
+
+  Each page of the image starts with the big-endian file number and
+  file page of the log it belongs to. The pages of each log are put
+  back in file page order, so logs that wrapped around the end of the
+  DataFlash decode in order.
+
+  Delta records (see LOG_DELTA_FLAG) are added to the last record of
+  their type and written out as ordinary packets of it. Those that come
+  before the first keyframe of their type, or straight after a missing
+  page, can't be decoded and are counted as skipped.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "LogReader.h"
+
+static const char			*out_dir;
+static bool					list;
+static int					only_log = -1;
+
+// the CSV files of -d
+static FILE					*csv_files[256];
+
+static void close_csv_files(void)
+{
+	for (int i=0; i<256; i++) {
+		if (csv_files[i] != NULL) {
+			fclose(csv_files[i]);
+			csv_files[i] = NULL;
+		}
+	}
+}
+
+static bool start_log(uint16_t log_number, uint16_t pages)
+{
+	if (list) {
+		printf("log %u: %u pages\n", log_number, pages);
+		return false;
+	}
+	if (only_log != -1 && only_log != log_number) {
+		return false;
+	}
+	close_csv_files();
+	return true;
+}
+
+static void print_format(const struct Log_Format *fmt, uint16_t)
+{
+	if (out_dir == NULL) {
+		printf("FMT,%u,%u,%s,%s,%s\n", fmt->type, fmt->length, fmt->name, fmt->format, fmt->labels);
+	}
+}
+
+static FILE *csv_file(const struct Log_Format *fmt, uint16_t log_number)
+{
+	if (csv_files[fmt->type] == NULL) {
+		char path[1024];
+
+		snprintf(path, sizeof(path), "%s/log%u_%s.csv", out_dir, log_number, fmt->name);
+		csv_files[fmt->type] = fopen(path, "w");
+		if (csv_files[fmt->type] == NULL) {
+			perror(path);
+			exit(1);
+		}
+		fprintf(csv_files[fmt->type], "%s\n", fmt->labels);
+	}
+	return csv_files[fmt->type];
+}
+
+// print a fixed point field
+static void print_fixed(FILE *f, int32_t value, uint32_t scale, int places)
+{
+	uint32_t	u = value < 0 ? -(uint32_t)value : value;
+
+	fprintf(f, "%s%u.%0*u", value < 0 ? "-" : "", u / scale, places, u % scale);
+}
+
+static void print_packet(const struct Log_Format *fmt, const int32_t *v, uint16_t log_number)
+{
+	FILE *f = stdout;
+
+	if (out_dir != NULL) {
+		f = csv_file(fmt, log_number);
+	} else {
+		fputs(fmt->name, f);
+	}
+
+	for (const char *c = fmt->format; *c; c++, v++) {
+		if (c != fmt->format || out_dir == NULL) {
+			putc(',', f);
+		}
+		switch (*c) {
+		case 'b': case 'h':		fprintf(f, "%d", *v);						break;
+		case 'B': case 'H':
+		case 'M':				fprintf(f, "%u", (uint32_t)*v);			break;
+		case 'i':				fprintf(f, "%d", *v);						break;
+		case 'I':				fprintf(f, "%u", (uint32_t)*v);			break;
+		case 'c': case 'C':
+		case 'e':				print_fixed(f, *v, 100, 2);				break;
+		case 'L':				print_fixed(f, *v, 10000000, 7);			break;
+		}
+	}
+	putc('\n', f);
+}
+
+static void report(uint16_t log_number, const struct log_stats *stats)
+{
+	fprintf(stderr, "log %u: %u packets", log_number, stats->packets);
+	if (stats->unknown != 0 || stats->bad_end != 0) {
+		fprintf(stderr, ", skipped %u unknown and %u with a bad end byte",
+				stats->unknown, stats->bad_end);
+	}
+	if (stats->no_keyframe != 0) {
+		fprintf(stderr, ", skipped %u delta records without a keyframe", stats->no_keyframe);
+	}
+	fprintf(stderr, "\n");
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: LogDecode [-l] [-n LOG] [-p SIZE] [-r] [-d DIR] IMAGE\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	static const struct log_reader	reader = { start_log, print_format, print_packet, report };
+	bool							raw = false;
+	uint32_t						page_size = 512;
+	int								opt;
+	static char						out_buf[1 << 16];
+
+	while ((opt = getopt(argc, argv, "ln:p:rd:")) != -1) {
+		switch (opt) {
+		case 'l': list = true;						break;
+		case 'n': only_log = atoi(optarg);			break;
+		case 'p': page_size = atoi(optarg);			break;
+		case 'r': raw = true;						break;
+		case 'd': out_dir = optarg;					break;
+		default: usage();
+		}
+	}
+	if (optind != argc - 1 || page_size <= 4) {
+		usage();
+	}
+	setvbuf(stdout, out_buf, _IOFBF, sizeof(out_buf));
+
+	if (!log_read_image(argv[optind], page_size, raw, &reader)) {
+		return 1;
+	}
+	close_csv_files();
+	return 0;
+}
@@ -0,0 +1,335 @@
+/*
+  LogReader - read the logs in a DataFlash image on the host
+
+  See LogReader.h.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "LogReader.h"
+
+#define HEAD_BYTE1		0xA3
+#define HEAD_BYTE2		0x95
+#define END_BYTE		0xBA
+
+#define PAGE_HEADER		4
+#define NO_FILE			0xFFFF
+
+struct page {
+	uint16_t	file_number;
+	uint16_t	file_page;
+	uint32_t	offset;
+
+	bool operator<(const page &p) const {
+		if (file_number != p.file_number) {
+			return file_number < p.file_number;
+		}
+		return file_page < p.file_page;
+	}
+};
+
+static std::vector<uint8_t>		image;
+static const struct log_reader	*reader;
+
+// formats of the log being decoded
+static bool					have_format[256];
+static struct Log_Format	formats[256];
+
+// the last record of each type, for the delta records that follow it
+static struct Log_Delta		deltas[256];
+
+static uint16_t be16(const uint8_t *p)
+{
+	return (p[0] << 8) | p[1];
+}
+
+static uint32_t be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+// size in bytes of a field of the given format character, 0 if unknown
+static uint8_t field_size(char c)
+{
+	switch (c) {
+	case 'b': case 'B': case 'M':
+		return 1;
+	case 'h': case 'H': case 'c': case 'C':
+		return 2;
+	case 'i': case 'I': case 'e': case 'L':
+		return 4;
+	}
+	return 0;
+}
+
+static bool load_image(const char *path)
+{
+	FILE	*f = fopen(path, "rb");
+	long	len;
+
+	if (f == NULL) {
+		perror(path);
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	image.resize(len);
+	if (len > 0 && fread(&image[0], 1, len, f) != (size_t)len) {
+		perror(path);
+		fclose(f);
+		return false;
+	}
+	fclose(f);
+	return true;
+}
+
+// start decoding a new log: forget the formats of the last one
+static bool start_log(uint16_t log_number, uint16_t pages)
+{
+	if (reader->start != NULL && !reader->start(log_number, pages)) {
+		return false;
+	}
+	memset(have_format, 0, sizeof(have_format));
+	memset(deltas, 0, sizeof(deltas));
+	return true;
+}
+
+static void add_format(const uint8_t *payload, uint16_t log_number)
+{
+	struct Log_Format	fmt;
+	uint16_t			len = 0;
+
+	memcpy(&fmt, payload, sizeof(fmt));
+	fmt.name[sizeof(fmt.name) - 1] = 0;
+	fmt.format[sizeof(fmt.format) - 1] = 0;
+	fmt.labels[sizeof(fmt.labels) - 1] = 0;
+
+	for (const char *f = fmt.format; *f; f++) {
+		if (field_size(*f) == 0) {
+			fprintf(stderr, "log %u: %s has unknown field type '%c'\n", log_number, fmt.name, *f);
+			return;
+		}
+		len += field_size(*f);
+	}
+	if (len != fmt.length) {
+		fprintf(stderr, "log %u: %s format is %u bytes, length says %u\n",
+				log_number, fmt.name, len, fmt.length);
+		return;
+	}
+	formats[fmt.type] = fmt;
+	have_format[fmt.type] = true;
+
+	if (reader->format != NULL) {
+		reader->format(&formats[fmt.type], log_number);
+	}
+}
+
+// the value of a field of the given format character
+static int32_t read_field(char c, const uint8_t *p)
+{
+	switch (c) {
+	case 'b':				return (int8_t)p[0];
+	case 'B': case 'M':		return p[0];
+	case 'h': case 'c':		return (int16_t)be16(p);
+	case 'H': case 'C':		return be16(p);
+	}
+	return be32(p);
+}
+
+/*
+  the length of a delta record of fmt starting at data, with its fields
+  in v, or 0 if it carries on past len
+ */
+static uint32_t read_delta(const struct Log_Format *fmt, const uint8_t *data, uint32_t len, uint32_t *v)
+{
+	uint32_t i = 0;
+
+	for (const char *c = fmt->format; *c; c++) {
+		uint32_t	u = 0;
+		uint8_t		shift = 0;
+
+		do {
+			if (i >= len) {
+				return 0;
+			}
+			u |= (uint32_t)(data[i] & 0x7F) << shift;
+			shift += 7;
+		} while ((data[i++] & 0x80) && shift < 35);
+		*v++ = (u >> 1) ^ -(u & 1);
+	}
+	return i;
+}
+
+static void packet(const struct Log_Format *fmt, const int32_t *v, uint16_t log_number)
+{
+	if (reader->packet != NULL) {
+		reader->packet(fmt, v, log_number);
+	}
+}
+
+/*
+  decode the packets in a run of bytes. Returns the number of bytes
+  used; what is left over is the start of a packet that carries on
+  into the next page.
+ */
+static uint32_t decode(const uint8_t *data, uint32_t len, uint16_t log_number, struct log_stats *stats)
+{
+	uint32_t i = 0;
+
+	while (i + 3 <= len) {
+		if (data[i] != HEAD_BYTE1 || data[i+1] != HEAD_BYTE2) {
+			i++;
+			continue;
+		}
+
+		uint8_t		type = data[i+2];
+		uint8_t		base = type & ~LOG_DELTA_FLAG;
+		bool		delta = (type & 0xC0) == LOG_DELTA_FLAG;
+		uint32_t	payload;
+		uint32_t	d[sizeof(formats[0].format)];
+
+		if (type == LOG_FORMAT_MSG) {
+			payload = sizeof(struct Log_Format);
+		} else if (delta && have_format[base] && strlen(formats[base].format) <= LOG_DELTA_FIELDS) {
+			payload = read_delta(&formats[base], &data[i+3], len - (i+3), d);
+			if (payload == 0) {
+				break;
+			}
+		} else if (!delta && have_format[type]) {
+			payload = formats[type].length;
+		} else {
+			// not a packet we know, or a stray pair of head bytes
+			stats->unknown++;
+			i++;
+			continue;
+		}
+		if (i + 3 + payload + 1 > len) {
+			break;
+		}
+		if (data[i+3+payload] != END_BYTE) {
+			stats->bad_end++;
+			i++;
+			continue;
+		}
+
+		if (type == LOG_FORMAT_MSG) {
+			add_format(&data[i+3], log_number);
+		} else if (delta) {
+			struct Log_Delta	*last = &deltas[base];
+			uint8_t				n = strlen(formats[base].format);
+
+			if (last->count == 0) {
+				stats->no_keyframe++;
+				i += 3 + payload + 1;
+				continue;
+			}
+			for (uint8_t f=0; f<n; f++) {
+				last->last[f] = (uint32_t)last->last[f] + d[f];
+			}
+			packet(&formats[base], last->last, log_number);
+		} else {
+			const struct Log_Format	*fmt = &formats[type];
+			const uint8_t			*p = &data[i+3];
+			int32_t					v[sizeof(fmt->format)];
+			uint8_t					n = 0;
+
+			for (const char *c = fmt->format; *c; c++) {
+				v[n++] = read_field(*c, p);
+				p += field_size(*c);
+			}
+			if (n <= LOG_DELTA_FIELDS) {
+				// a keyframe for any delta records that follow
+				memcpy(deltas[type].last, v, n * sizeof(v[0]));
+				deltas[type].count = 1;
+			}
+			packet(fmt, v, log_number);
+		}
+		stats->packets++;
+		i += 3 + payload + 1;
+	}
+	return i;
+}
+
+// decode the pages of one log, in file page order
+static void decode_log(const std::vector<page> &pages, size_t first, size_t last, uint32_t page_size)
+{
+	uint16_t				log_number = pages[first].file_number;
+	struct log_stats		stats = { 0, 0, 0, 0 };
+	std::vector<uint8_t>	buf;
+	uint32_t				used;
+
+	if (!start_log(log_number, last - first)) {
+		return;
+	}
+	for (size_t i=first; i<last; i++) {
+		if (i != first && pages[i].file_page != pages[i-1].file_page + 1) {
+			// a page is missing; a packet can't span the gap, and
+			// delta records have to wait for the next keyframe
+			buf.clear();
+			memset(deltas, 0, sizeof(deltas));
+		}
+		const uint8_t *data = &image[pages[i].offset + PAGE_HEADER];
+		buf.insert(buf.end(), data, data + page_size - PAGE_HEADER);
+		used = decode(&buf[0], buf.size(), log_number, &stats);
+		buf.erase(buf.begin(), buf.begin() + used);
+	}
+	if (reader->finish != NULL) {
+		reader->finish(log_number, &stats);
+	}
+}
+
+bool log_read_image(const char *path, uint32_t page_size, bool raw,
+					const struct log_reader *r)
+{
+	std::vector<page>	pages;
+
+	if (page_size <= PAGE_HEADER) {
+		fprintf(stderr, "page size %u is too small\n", page_size);
+		return false;
+	}
+	if (!load_image(path)) {
+		return false;
+	}
+	reader = r;
+
+	if (raw) {
+		struct log_stats stats = { 0, 0, 0, 0 };
+
+		if (start_log(0, 0)) {
+			if (!image.empty()) {
+				decode(&image[0], image.size(), 0, &stats);
+			}
+			if (reader->finish != NULL) {
+				reader->finish(0, &stats);
+			}
+		}
+		return true;
+	}
+
+	for (uint32_t ofs=0; ofs + page_size <= image.size(); ofs += page_size) {
+		page p;
+
+		p.file_number = be16(&image[ofs]);
+		p.file_page = be16(&image[ofs + 2]);
+		p.offset = ofs;
+		if (p.file_number == NO_FILE || p.file_number == 0 || p.file_page == 0) {
+			// erased, or never written
+			continue;
+		}
+		pages.push_back(p);
+	}
+	std::sort(pages.begin(), pages.end());
+
+	for (size_t first=0, last; first<pages.size(); first=last) {
+		for (last=first; last<pages.size() && pages[last].file_number == pages[first].file_number; last++)
+			;
+		decode_log(pages, first, last, page_size);
+	}
+	return true;
+}
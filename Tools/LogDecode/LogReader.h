@@ -0,0 +1,51 @@
+/*
+  LogReader - read the logs in a DataFlash image on the host
+
+  The page sorting and packet decoding of LogDecode, for the host tools
+  that want the packets of a log rather than CSV. See LogDecode.cpp for
+  the layout of an image. The caller is handed each log in turn, then
+  each FMT record and each packet of it, with delta records already
+  added back up into ordinary packets.
+*/
+
+#ifndef LogReader_h
+#define LogReader_h
+
+#include <stdint.h>
+
+#include "../../libraries/DataFlash/DataFlash.h"
+
+struct log_stats {
+	uint32_t	packets;
+	uint32_t	unknown;
+	uint32_t	bad_end;
+	uint32_t	no_keyframe;
+};
+
+// What to do with the logs of an image. Any of the functions can be
+// NULL.
+struct log_reader {
+	// a log of the given number of pages is next; return false to
+	// skip it. The number and pages of a raw image are 0.
+	bool	(*start)(uint16_t log_number, uint16_t pages);
+
+	// a FMT record, after it has been checked
+	void	(*format)(const struct Log_Format *fmt, uint16_t log_number);
+
+	// a packet, with one value per character of fmt->format. Values
+	// are as written, so an 'L' is degrees * 10^7 and so on.
+	void	(*packet)(const struct Log_Format *fmt, const int32_t *v, uint16_t log_number);
+
+	// the end of a log that was started
+	void	(*finish)(uint16_t log_number, const struct log_stats *stats);
+};
+
+// Read the image at path and pass its logs to reader, in log number
+// order. page_size is the size of a page of the image, header
+// included. A raw image is a plain stream of packets without page
+// headers. Returns false, having said why on stderr, if the image
+// can't be read.
+bool	log_read_image(const char *path, uint32_t page_size, bool raw,
+					   const struct log_reader *reader);
+
+#endif
@@ -0,0 +1,51 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	BenchIMU.h
+/// @brief	An IMU that replays a recorded sensor trace, for the host
+///         benchmarks.
+
+#ifndef BenchIMU_h
+#define BenchIMU_h
+
+#include <AP_IMU.h>
+
+/// One sample of a sensor trace, as seen by the 200Hz fast loop.
+struct bench_sample {
+	Vector3f	gyro;		///< body rates in radians/sec
+	Vector3f	accel;		///< accelerations in m/s/s
+	Vector3f	mag;		///< raw magnetometer counts
+};
+
+class BenchIMU : public IMU
+{
+public:
+	BenchIMU() : _samples(NULL), _count(0), _next(0) {}
+
+	/// Set the trace to replay. Replay wraps around at the end.
+	///
+	void		set_trace(const struct bench_sample *samples, uint16_t count) {
+		_samples = samples;
+		_count = count;
+		_next = 0;
+	}
+
+	/// Step to the next sample of the trace.
+	///
+	virtual bool	update(void) {
+		const struct bench_sample *s = &_samples[_next];
+		_gyro = s->gyro;
+		_accel = s->accel;
+		_sample_time = 5000;
+		if (++_next == _count) {
+			_next = 0;
+		}
+		return true;
+	}
+
+private:
+	const struct bench_sample *_samples;
+	uint16_t	_count;
+	uint16_t	_next;
+};
+
+#endif
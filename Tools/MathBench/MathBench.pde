@@ -0,0 +1,413 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/*
+  Host benchmark of the attitude, navigation and control math
+
+  This only builds with the desktop build. Each kernel is run once per
+  sample of a sensor trace, several times over, and the fastest pass is
+  reported in ns/call together with the heap allocations per call.
+  Before the timings, the AP_Math fast_* functions are swept against
+  libm to check their error bounds (see fast_math.pde).
+
+  Settings come from the environment, as the desktop main() owns the
+  command line:
+
+    BENCH_TRACE      replay this trace file instead of the built-in one
+    BENCH_BASELINE   compare with the results of an earlier run
+    BENCH_SAVE       save the results of this run
+    BENCH_THRESHOLD  allowed slowdown against the baseline in percent,
+                     default 10
+
+  A trace file has one sample per line, in the order
+     gyro x y z (rad/s)  accel x y z (m/s/s)  mag x y z (raw)
+  and lines starting with # are ignored.
+
+  The program exits with status 1 if any kernel is slower than its
+  baseline by more than the threshold, or if a fast_* function is out
+  of its error bound. Run it with -T so the SITL timer
+  signal doesn't land in the middle of the timings.
+*/
+
+#if !DESKTOP_BUILD
+#error MathBench only builds with the desktop build
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include <Arduino_Mega_ISR_Registry.h>
+#include <APM_RC.h>
+#include <AP_GPS.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <DataFlash.h>
+#include <AP_ADC.h>
+#include <AP_AnalogSource.h>
+#include <APM_BMP085.h>
+#include <AP_Compass.h>
+#include <AP_Math.h>
+#include <AP_InertialSensor.h>
+#include <AP_IMU.h>
+#include <AP_PeriodicProcess.h>
+#include <AP_TimerProcess.h>
+#include <AP_TimerAperiodicProcess.h>
+#include <AP_DCM.h>
+#include <PID.h>
+#include <APM_PI.h>
+#include <APM_Nav.h>
+#include "BenchIMU.h"
+
+#define TRACE_MAX		4000	// most samples in a trace, 20s at 200Hz
+#define TRACE_DEFAULT	2000	// samples in the built-in trace
+#define BENCH_PASSES	7		// passes over the trace for each kernel
+#define BENCH_KERNELS	24
+
+FastSerialPort0(Serial);
+
+// needed by the desktop support code
+Arduino_Mega_ISR_Registry	isr_registry;
+AP_TimerProcess				timer_scheduler;
+APM_BMP085_HIL_Class		barometer;
+AP_Compass_HIL				compass;
+
+static BenchIMU		imu;
+static AP_GPS_None	gps_none(NULL);
+static GPS			*g_gps = &gps_none;
+static AP_DCM		dcm(&imu, g_gps, &compass);
+
+static PID			pid_servo(NULL, 0.4, 0.05, 0.01, 3500);
+static APM_PI		pi_rate(NULL, 0.145, 0.0, 1500);
+static APM_PI		pi_nav_lat(NULL, 3.0, 0.05, 2000);
+static APM_PI		pi_nav_lon(NULL, 3.0, 0.05, 2000);
+static APM_PI		pi_loiter_lat(NULL, 1.0, 0.0, 1500);
+static APM_PI		pi_loiter_lon(NULL, 1.0, 0.0, 1500);
+static APM_Nav		wp_nav(pi_nav_lat, pi_nav_lon, pi_loiter_lat, pi_loiter_lon);
+
+// navigation state, as in ArduCopter
+static LocalFrame	local_frame;
+static float	dTnav			= 0.1;
+static int32_t	target_bearing;
+static int32_t	original_target_bearing;
+static int32_t	wp_distance;
+static float	crosstrack_gain	= 4;
+static struct Location	current_loc;
+static struct Location	prev_WP;
+static struct Location	next_WP;
+
+static struct bench_sample	trace[TRACE_MAX];
+static struct Location		trace_loc[TRACE_MAX];
+static struct Location		bench_target;
+static uint16_t				trace_len;
+
+// results go here so the compiler can't drop the work
+static volatile int32_t		bench_sink;
+static volatile float		bench_fsink;
+
+static struct {
+	const char	*name;
+	float		ns;
+	float		allocs;
+	float		baseline;
+} results[BENCH_KERNELS];
+static uint8_t		num_results;
+
+/*
+  fill in a few seconds of gentle flight at 200Hz. The airframe rocks
+  in roll and pitch while yawing slowly and circling a target point.
+  The sensor values are worked out the same way as the SITL ADC and
+  compass code does it.
+ */
+static void trace_generate(void)
+{
+	float last_roll = 0, last_pitch = 0, last_yaw = 0;
+
+	for (uint16_t i=0; i<TRACE_DEFAULT; i++) {
+		struct bench_sample *s = &trace[i];
+		float t = i * 0.005;
+		float roll  = 0.3 * sin(2 * M_PI * 0.5 * t);
+		float pitch = 0.2 * sin(2 * M_PI * 0.3 * t + 1);
+		float yaw   = 0.5 * t;
+		float heading_x, heading_y;
+
+		s->gyro.x = (roll  - last_roll)  / 0.005;
+		s->gyro.y = (pitch - last_pitch) / 0.005;
+		s->gyro.z = (yaw   - last_yaw)   / 0.005;
+		last_roll = roll;
+		last_pitch = pitch;
+		last_yaw = yaw;
+
+		s->accel.x =  9.81 * sin(pitch) * cos(roll);
+		s->accel.y = -9.81 * sin(roll)  * cos(pitch);
+		s->accel.z = -9.81 * cos(roll)  * cos(pitch);
+
+		heading_x = cos(yaw);
+		heading_y = -sin(yaw);
+		s->mag.z = 0;
+		s->mag.y = heading_y / cos(roll);
+		s->mag.x = (heading_x - s->mag.y * sin(roll) * sin(pitch)) / cos(pitch);
+		s->mag *= 665 / s->mag.length();
+
+		// a 40m circle around the target
+		trace_loc[i].lat = bench_target.lat + 3600 * cos(0.1 * t);
+		trace_loc[i].lng = bench_target.lng + 3600 * sin(0.1 * t);
+	}
+	trace_len = TRACE_DEFAULT;
+}
+
+/*
+  load a recorded trace. The positions keep following the built-in
+  circle, as only the sensor values are recorded.
+ */
+static bool trace_load(const char *fname)
+{
+	FILE *f = fopen(fname, "r");
+	char line[200];
+	uint16_t n = 0;
+
+	if (f == NULL) {
+		printf("Unable to open trace %s\n", fname);
+		return false;
+	}
+	while (n < TRACE_MAX && fgets(line, sizeof(line), f)) {
+		struct bench_sample *s = &trace[n];
+		if (line[0] == '#') {
+			continue;
+		}
+		if (sscanf(line, "%f %f %f %f %f %f %f %f %f",
+				   &s->gyro.x, &s->gyro.y, &s->gyro.z,
+				   &s->accel.x, &s->accel.y, &s->accel.z,
+				   &s->mag.x, &s->mag.y, &s->mag.z) == 9) {
+			trace_loc[n] = trace_loc[n % TRACE_DEFAULT];
+			n++;
+		}
+	}
+	fclose(f);
+	if (n == 0) {
+		printf("No samples in trace %s\n", fname);
+		return false;
+	}
+	trace_len = n;
+	return true;
+}
+
+/*
+  the kernels under test, each called once per trace sample
+ */
+static void k_update_DCM(uint16_t i)
+{
+	dcm.update_DCM();
+}
+
+static void k_update_DCM_fast(uint16_t i)
+{
+	dcm.update_DCM_fast();
+}
+
+static void k_compass_calculate(uint16_t i)
+{
+	compass.setHIL(trace[i].mag.x, trace[i].mag.y, trace[i].mag.z);
+	compass.calculate(dcm.get_dcm_matrix());
+}
+
+static void k_pid(uint16_t i)
+{
+	// roll rate in centi-degrees/s as the error
+	bench_sink = pid_servo.get_pid(trace[i].gyro.x * 5729.57795, 20);
+}
+
+static void k_pi(uint16_t i)
+{
+	bench_sink = pi_rate.get_pi(trace[i].gyro.x * 5729.57795, 0.005);
+}
+
+static void k_get_distance(uint16_t i)
+{
+	bench_sink = local_frame.distance(&trace_loc[i], &bench_target);
+}
+
+static void k_get_bearing(uint16_t i)
+{
+	bench_sink = local_frame.bearing(&trace_loc[i], &bench_target);
+}
+
+static void k_calc_nav_rate(uint16_t i)
+{
+	g_gps->ground_speed = 300 + (i & 0xFF);
+	g_gps->ground_course = (i * 7) % 36000;
+	target_bearing = (i * 11) % 36000;
+	wp_distance = 5 + (i & 0x1F);
+	current_loc = trace_loc[i];
+	wp_nav.update_crosstrack(local_frame, &current_loc, &next_WP,
+							 target_bearing, original_target_bearing, crosstrack_gain);
+	wp_nav.calc_nav_rate(400, wp_distance,
+						 target_bearing - g_gps->ground_course, g_gps->ground_speed, dTnav);
+	bench_sink = wp_nav.nav_lat + wp_nav.nav_lon;
+}
+
+static uint64_t bench_nsec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void bench_run(const char *name, void (*kernel)(uint16_t))
+{
+	float best = 0;
+	uint32_t allocs = heap_allocations;
+
+	for (uint8_t pass=0; pass<BENCH_PASSES; pass++) {
+		uint64_t start = bench_nsec();
+		for (uint16_t i=0; i<trace_len; i++) {
+			kernel(i);
+		}
+		float ns = (bench_nsec() - start) / (float)trace_len;
+		if (pass == 0 || ns < best) {
+			best = ns;
+		}
+	}
+
+	if (num_results < BENCH_KERNELS) {
+		results[num_results].name = name;
+		results[num_results].ns = best;
+		results[num_results].allocs = (heap_allocations - allocs) / (float)(trace_len * BENCH_PASSES);
+		results[num_results].baseline = 0;
+		num_results++;
+	}
+}
+
+static void baseline_load(const char *fname)
+{
+	FILE *f = fopen(fname, "r");
+	char name[40];
+	float ns;
+
+	if (f == NULL) {
+		printf("No baseline in %s\n", fname);
+		return;
+	}
+	while (fscanf(f, "%39s %f", name, &ns) == 2) {
+		for (uint8_t i=0; i<num_results; i++) {
+			if (strcmp(results[i].name, name) == 0) {
+				results[i].baseline = ns;
+			}
+		}
+	}
+	fclose(f);
+}
+
+static void baseline_save(const char *fname)
+{
+	FILE *f = fopen(fname, "w");
+
+	if (f == NULL) {
+		printf("Unable to save results to %s\n", fname);
+		return;
+	}
+	for (uint8_t i=0; i<num_results; i++) {
+		fprintf(f, "%s %.1f\n", results[i].name, results[i].ns);
+	}
+	fclose(f);
+	printf("Results saved to %s\n", fname);
+}
+
+/*
+  print the results, returning the number of kernels that regressed
+  by more than threshold percent
+ */
+static uint8_t report(float threshold)
+{
+	uint8_t failed = 0;
+
+	printf("%-20s %10s %12s %10s %8s\n", "kernel", "ns/call", "allocs/call", "baseline", "change");
+	for (uint8_t i=0; i<num_results; i++) {
+		printf("%-20s %10.1f %12.2f", results[i].name, results[i].ns, results[i].allocs);
+		if (results[i].baseline > 0) {
+			float change = 100 * (results[i].ns - results[i].baseline) / results[i].baseline;
+			printf(" %10.1f %+7.1f%%", results[i].baseline, change);
+			if (change > threshold) {
+				printf("  REGRESSED");
+				failed++;
+			}
+		}
+		printf("\n");
+	}
+	return failed;
+}
+
+void setup(void)
+{
+	const char *s;
+	float threshold = 10;
+	uint8_t failed, out_of_bounds;
+
+	bench_target.lat = 343800000;
+	bench_target.lng = -1483400000;
+	trace_generate();
+	if ((s = getenv("BENCH_TRACE")) != NULL && !trace_load(s)) {
+		exit(1);
+	}
+	if ((s = getenv("BENCH_THRESHOLD")) != NULL) {
+		threshold = atof(s);
+	}
+	out_of_bounds = fast_math_check();
+	fast_math_inputs();
+	local_frame.set_origin(&bench_target);
+	prev_WP = trace_loc[0];
+	next_WP = bench_target;
+	wp_nav.start_leg(local_frame, &prev_WP, &next_WP);
+	printf("MathBench: %u samples, best of %u passes\n", trace_len, BENCH_PASSES);
+
+	imu.set_trace(trace, trace_len);
+	dcm.set_centripetal(true);
+	gps_none.ground_speed = 500;
+	compass.setHIL(trace[0].mag.x, trace[0].mag.y, trace[0].mag.z);
+	compass.calculate(dcm.get_dcm_matrix());
+
+	bench_run("update_DCM", k_update_DCM);
+	bench_run("update_DCM_fast", k_update_DCM_fast);
+	bench_run("Compass::calculate", k_compass_calculate);
+	bench_run("PID::get_pid", k_pid);
+	bench_run("APM_PI::get_pi", k_pi);
+	bench_run("get_distance", k_get_distance);
+	bench_run("get_bearing", k_get_bearing);
+	bench_run("calc_nav_rate", k_calc_nav_rate);
+	bench_run("sin", k_sin);
+	bench_run("fast_sin", k_fast_sin);
+	bench_run("cos", k_cos);
+	bench_run("fast_cos", k_fast_cos);
+	bench_run("asin", k_asin);
+	bench_run("fast_asin", k_fast_asin);
+	bench_run("atan2", k_atan2);
+	bench_run("fast_atan2", k_fast_atan2);
+	bench_run("sqrt", k_sqrt);
+	bench_run("fast_sqrt", k_fast_sqrt);
+	bench_run("invsqrt", k_invsqrt);
+	bench_run("fast_invsqrt", k_fast_invsqrt);
+
+	if ((s = getenv("BENCH_BASELINE")) != NULL) {
+		baseline_load(s);
+	}
+	failed = report(threshold);
+	if ((s = getenv("BENCH_SAVE")) != NULL) {
+		baseline_save(s);
+	}
+	if (failed) {
+		printf("%u kernels regressed by more than %.0f%%\n", failed, threshold);
+		exit(1);
+	}
+	if (out_of_bounds) {
+		printf("%u fast_math functions are out of bounds\n", out_of_bounds);
+		exit(1);
+	}
+	exit(0);
+}
+
+void loop(void)
+{
+}
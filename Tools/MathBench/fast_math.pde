@@ -0,0 +1,91 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/*
+  Accuracy sweep and kernels for the AP_Math fast_* functions
+
+  fast_math_check() sweeps each function over its domain against
+  double precision libm and fails if the error is over the bound
+  documented in fast_math.h. The kernels time each function next to
+  the float libm call it replaces.
+*/
+
+#define SWEEP_STEPS		200000
+
+static float	math_in_x[TRACE_MAX];
+static float	math_in_y[TRACE_MAX];
+
+static bool sweep_report(const char *name, double max_err, double bound)
+{
+	bool ok = (max_err <= bound);
+	printf("%-20s max error %.3g, bound %.3g%s\n", name, max_err, bound, ok ? "" : "  FAILED");
+	return ok;
+}
+
+/*
+  sweep each function, returning the number that are out of bounds
+ */
+static uint8_t fast_math_check(void)
+{
+	uint8_t failed = 0;
+	double e_sin = 0, e_cos = 0, e_atan2 = 0, e_asin = 0, e_invsqrt = 0, e_sqrt = 0;
+
+	for (uint32_t i=0; i<=SWEEP_STEPS; i++) {
+		float x = -10000 + 20000.0 * i / SWEEP_STEPS;
+		float a = -M_PI + 2 * M_PI * i / SWEEP_STEPS;
+		float u = -1 + 2.0 * i / SWEEP_STEPS;
+		// positive values across 12 decades
+		float p = pow(10, -6 + 12.0 * i / SWEEP_STEPS);
+
+		e_sin = max(e_sin, fabs(fast_sin(x) - sin((double)x)));
+		e_sin = max(e_sin, fabs(fast_sin(a) - sin((double)a)));
+		e_cos = max(e_cos, fabs(fast_cos(x) - cos((double)x)));
+		e_cos = max(e_cos, fabs(fast_cos(a) - cos((double)a)));
+		e_asin = max(e_asin, fabs(fast_asin(u) - asin((double)u)));
+		e_invsqrt = max(e_invsqrt, fabs(fast_invsqrt(p) * sqrt((double)p) - 1));
+		e_sqrt = max(e_sqrt, fabs(fast_sqrt(p) / sqrt((double)p) - 1));
+
+		// points on circles from very small to very large radius
+		for (float r=1.0e-3; r<1.0e5; r*=100) {
+			float y = r * sin(a);
+			float z = r * cos(a);
+			double err = fabs(fast_atan2(y, z) - atan2((double)y, (double)z));
+			// the two are allowed to differ by 2 pi at +-pi
+			e_atan2 = max(e_atan2, min(err, fabs(err - 2 * M_PI)));
+		}
+	}
+
+	failed += !sweep_report("fast_sin", e_sin, 1.7e-6);
+	failed += !sweep_report("fast_cos", e_cos, 1.7e-6);
+	failed += !sweep_report("fast_atan2", e_atan2, 2.0e-6);
+	failed += !sweep_report("fast_asin", e_asin, 4.0e-6);
+	failed += !sweep_report("fast_invsqrt", e_invsqrt, 5.0e-6);
+	failed += !sweep_report("fast_sqrt", e_sqrt, 5.0e-6);
+	failed += !sweep_report("fast_atan2(0, 0)", fabs(fast_atan2(0, 0)), 0);
+	failed += !sweep_report("fast_sqrt(-1)", fabs(fast_sqrt(-1)), 0);
+	return failed;
+}
+
+/*
+  inputs for the kernels: angles across [-pi, pi], and the accel
+  readings of the trace for the two argument and square root calls
+ */
+static void fast_math_inputs(void)
+{
+	for (uint16_t i=0; i<trace_len; i++) {
+		math_in_x[i] = -M_PI + 2 * M_PI * i / trace_len;
+		math_in_y[i] = trace[i].accel.length_squared();
+	}
+}
+
+static void k_sin(uint16_t i)			{ bench_fsink = sinf(math_in_x[i]); }
+static void k_fast_sin(uint16_t i)		{ bench_fsink = fast_sin(math_in_x[i]); }
+static void k_cos(uint16_t i)			{ bench_fsink = cosf(math_in_x[i]); }
+static void k_fast_cos(uint16_t i)		{ bench_fsink = fast_cos(math_in_x[i]); }
+static void k_asin(uint16_t i)			{ bench_fsink = asinf(math_in_x[i] * 0.3f); }
+static void k_fast_asin(uint16_t i)		{ bench_fsink = fast_asin(math_in_x[i] * 0.3f); }
+static void k_atan2(uint16_t i)			{ bench_fsink = atan2f(trace[i].accel.y, trace[i].accel.x); }
+static void k_fast_atan2(uint16_t i)	{ bench_fsink = fast_atan2(trace[i].accel.y, trace[i].accel.x); }
+static void k_sqrt(uint16_t i)			{ bench_fsink = sqrtf(math_in_y[i]); }
+static void k_fast_sqrt(uint16_t i)		{ bench_fsink = fast_sqrt(math_in_y[i]); }
+static void k_invsqrt(uint16_t i)		{ bench_fsink = 1 / sqrtf(math_in_y[i]); }
+static void k_fast_invsqrt(uint16_t i)	{ bench_fsink = fast_invsqrt(math_in_y[i]); }
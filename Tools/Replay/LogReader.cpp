@@ -0,0 +1,3 @@
+// The log reader of LogDecode, built into the sketch. The desktop build
+// only compiles the sources in the sketch directory.
+#include "../LogDecode/LogReader.cpp"
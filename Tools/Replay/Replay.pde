@@ -0,0 +1,463 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/*
+  Replay of ArduCopter DataFlash logs through the attitude estimate and
+  the navigation controllers
+
+  This only builds with the desktop build. The RAW, MAG and GPS records
+  of each log are fed to AP_DCM and Compass, and the inputs recorded in
+  the NTUN records to the loiter and waypoint controllers, as fast as
+  the image can be read. Nothing waits on a clock or a socket, so a
+  change to the estimator or to the navigation gains can be tried
+  against many flights in the time it takes to read them.
+
+  Settings come from the environment, as the desktop main() owns the
+  command line:
+
+    REPLAY_IMAGE        the DataFlash image to read, default
+                        dataflash.bin
+    REPLAY_LOG          only replay this log of the image
+    REPLAY_PAGE_SIZE    page size of the image, default 512
+    REPLAY_RAW          the image is a plain stream of packets without
+                        page headers, as for LogDecode -r
+    REPLAY_SETTLE       seconds at the start of each log left out of the
+                        summary while the estimate settles, default 10
+    REPLAY_NAV_P, REPLAY_NAV_I, REPLAY_NAV_IMAX,
+    REPLAY_LOITER_P, REPLAY_LOITER_I, REPLAY_LOITER_IMAX,
+    REPLAY_WP_SPEED, REPLAY_XTRK_GAIN
+                        navigation gains, by default those of
+                        ArduCopter/config.h. IMAX is in degrees.
+
+  For each ATT and NTUN record a line goes to stdout:
+
+    ATT,log,time,roll,pitch,yaw,roll,pitch,yaw
+    NTUN,log,time,nav_lon,nav_lat,nav_lon,nav_lat
+
+  with the logged values first and the replayed ones after them,
+  attitude in degrees and time in seconds since the start of the log.
+  The RMS differences over each log go to stderr.
+
+  The log needs RAW, ATT, GPS and NTUN logging enabled, and COMPASS for
+  the compass yaw correction. The estimate runs in 200Hz steps as the
+  firmware does, but RAW is logged at 50Hz, so each RAW sample is held
+  for four steps; the replayed attitude tracks the logged one closely
+  rather than exactly. The controllers are given the distance, bearing
+  and position errors of each NTUN record, and the integrators are
+  loaded from the record whenever the controller in use changes, so
+  their output can be compared with the log record for record.
+*/
+
+#if !DESKTOP_BUILD
+#error Replay only builds with the desktop build
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include <Arduino_Mega_ISR_Registry.h>
+#include <APM_RC.h>
+#include <AP_GPS.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <DataFlash.h>
+#include <AP_ADC.h>
+#include <AP_AnalogSource.h>
+#include <APM_BMP085.h>
+#include <AP_Compass.h>
+#include <AP_Math.h>
+#include <AP_InertialSensor.h>
+#include <AP_IMU.h>
+#include <AP_PeriodicProcess.h>
+#include <AP_TimerProcess.h>
+#include <AP_TimerAperiodicProcess.h>
+#include <AP_DCM.h>
+#include <PID.h>
+#include <APM_PI.h>
+#include <APM_Nav.h>
+#include "ReplayIMU.h"
+#include "../LogDecode/LogReader.h"
+
+#define RAW_RATE		50		// RAW records a second
+#define FAST_STEPS		4		// 200Hz estimator steps per RAW record
+
+// wp_control, as in ArduCopter/defines.h
+#define LOITER_MODE		1
+#define WP_MODE			2
+
+// as in ArduCopter/config.h
+#define LOITER_P		.3
+#define LOITER_I		0.0
+#define LOITER_IMAX		12
+#define NAV_P			3.0
+#define NAV_I			0.05
+#define NAV_IMAX		20
+#define WAYPOINT_SPEED_MAX	400
+#define CROSSTRACK_GAIN	4
+
+FastSerialPort0(Serial);
+
+// needed by the desktop support code
+Arduino_Mega_ISR_Registry	isr_registry;
+AP_TimerProcess				timer_scheduler;
+APM_BMP085_HIL_Class		barometer;
+AP_Compass_HIL				compass;
+
+static ReplayIMU	imu;
+static AP_GPS_HIL	gps_hil(NULL);
+static GPS			*g_gps = &gps_hil;
+static AP_DCM		*dcm;
+
+static APM_PI		pi_loiter_lat(NULL, LOITER_P, LOITER_I, LOITER_IMAX * 100);
+static APM_PI		pi_loiter_lon(NULL, LOITER_P, LOITER_I, LOITER_IMAX * 100);
+static APM_PI		pi_nav_lat(NULL, NAV_P, NAV_I, NAV_IMAX * 100);
+static APM_PI		pi_nav_lon(NULL, NAV_P, NAV_I, NAV_IMAX * 100);
+static APM_Nav		wp_nav(pi_nav_lat, pi_nav_lon, pi_loiter_lat, pi_loiter_lon);
+static int16_t		waypoint_speed_max	= WAYPOINT_SPEED_MAX;
+static float		crosstrack_gain		= CROSSTRACK_GAIN;
+
+// navigation state, as in ArduCopter
+static LocalFrame	local_frame;
+static float	dTnav;
+static int32_t	target_bearing;
+static int32_t	original_target_bearing;
+static int32_t	wp_distance;
+
+static struct Location	current_loc;
+static struct Location	prev_WP;
+static struct Location	next_WP;
+
+// the records replayed, with the format each has to have
+enum {
+	REC_NONE,
+	REC_ATT,
+	REC_GPS,
+	REC_NTUN,
+	REC_RAW,
+	REC_CMD,
+	REC_MAG
+};
+
+static const struct {
+	uint8_t		kind;
+	const char	*name;
+	const char	*format;
+} records[] = {
+	{ REC_ATT,	"ATT",	"hhHhhh" },
+	{ REC_GPS,	"GPS",	"IBLLeehH" },
+	{ REC_NTUN,	"NTUN",	"hhhhhhhhhhB" },
+	{ REC_RAW,	"RAW",	"LLLLLL" },
+	{ REC_CMD,	"CMD",	"BBBBBiii" },
+	{ REC_MAG,	"MAG",	"hhhhhhc" }
+};
+
+// what each message type of the log being replayed is
+static uint8_t		kinds[256];
+
+// the log being replayed
+static struct {
+	uint32_t	raw;			// RAW records so far
+	uint32_t	gps;			// GPS records so far
+	uint32_t	gps_time;		// time of the last one, milliseconds
+	uint8_t		wp_control;		// of the last NTUN record, 0 before one
+	uint32_t	att_count;		// ATT records in the summary
+	double		att_sq[3];		// sums of squared differences
+	uint32_t	ntun_count;		// NTUN records in the summary
+	double		ntun_sq[2];
+	uint64_t	start_nsec;
+} rs;
+
+static float		settle = 10;
+static int			only_log = -1;
+
+static uint64_t replay_nsec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static float env_float(const char *name, float value)
+{
+	const char *s = getenv(name);
+	return s != NULL ? atof(s) : value;
+}
+
+// seconds since the start of the log, going by the RAW records
+static float replay_time(void)
+{
+	return rs.raw / (float)RAW_RATE;
+}
+
+static bool replay_start(uint16_t log_number, uint16_t pages)
+{
+	if (only_log != -1 && only_log != log_number) {
+		return false;
+	}
+	memset(&rs, 0, sizeof(rs));
+	memset(kinds, REC_NONE, sizeof(kinds));
+	rs.start_nsec = replay_nsec();
+
+	// a fresh estimate for each log, with the gains ArduCopter sets up
+	// in init_ardupilot()
+	delete dcm;
+	dcm = new AP_DCM(&imu, g_gps, NULL);
+	dcm->set_centripetal(false);
+	dcm->kp_roll_pitch(0.030000);
+	dcm->ki_roll_pitch(0.00001278);
+	dcm->kp_yaw(0.08);
+	dcm->ki_yaw(0.00004);
+	return true;
+}
+
+static void replay_format(const struct Log_Format *fmt, uint16_t log_number)
+{
+	for (uint8_t i=0; i<sizeof(records)/sizeof(records[0]); i++) {
+		if (strcmp(fmt->name, records[i].name) != 0) {
+			continue;
+		}
+		if (strcmp(fmt->format, records[i].format) != 0) {
+			fprintf(stderr, "log %u: %s is %s, not the %s replay knows\n",
+					log_number, fmt->name, fmt->format, records[i].format);
+			return;
+		}
+		kinds[fmt->type] = records[i].kind;
+		if (records[i].kind == REC_MAG) {
+			// the firmware only uses the compass if it has one
+			dcm->set_compass(&compass);
+		}
+	}
+}
+
+static void replay_raw(const int32_t *v)
+{
+	imu.set_sample(Vector3f(v[0], v[1], v[2]) / 1.0e7,
+				   Vector3f(v[3], v[4], v[5]) / 1.0e7);
+	for (uint8_t i=0; i<FAST_STEPS; i++) {
+		dcm->update_DCM_fast();
+	}
+	rs.raw++;
+}
+
+static void replay_mag(const int32_t *v)
+{
+	float dec = radians(v[6] / 100.0);
+
+	if (dec != compass.get_declination()) {
+		compass.set_declination(dec);
+	}
+	compass.setHIL(v[0], v[1], v[2]);
+	compass.calculate(dcm->get_dcm_matrix());
+}
+
+static void replay_gps(const int32_t *v)
+{
+	uint32_t time = v[0];
+
+	if (rs.gps != 0) {
+		// navigation runs once for each fix
+		dTnav = (time - rs.gps_time) / 1000.0;
+		dTnav = constrain(dTnav, 0, 1.0);
+	}
+	rs.gps_time = time;
+	rs.gps++;
+
+	g_gps->time				= time;
+	g_gps->num_sats			= v[1];
+	g_gps->latitude			= v[2];
+	g_gps->longitude		= v[3];
+	g_gps->altitude			= v[5];
+	g_gps->ground_speed		= v[6];
+	g_gps->ground_course	= v[7];
+	g_gps->fix				= true;
+	g_gps->new_data			= true;
+
+	current_loc.lat			= v[2];
+	current_loc.lng			= v[3];
+	current_loc.alt			= v[4];
+
+	if (rs.gps == 1) {
+		// the firmware measures from home, which is about where
+		// the log starts
+		local_frame.set_origin(&current_loc);
+	}
+}
+
+static void replay_cmd(const int32_t *v)
+{
+	// ids below MAV_CMD_NAV_LAST (95) are navigation commands; this is
+	// what set_next_WP() does with them
+	if (v[2] >= 95 || v[6] == 0) {
+		return;
+	}
+	prev_WP = next_WP.lat != 0 ? next_WP : current_loc;
+	next_WP.lat = v[6];
+	next_WP.lng = v[7];
+	next_WP.alt = v[5];
+
+	// until there is a fix, measure from the WP
+	if (rs.gps == 0)
+		local_frame.set_origin(&next_WP);
+
+	original_target_bearing	= local_frame.bearing(&prev_WP, &next_WP);
+	wp_nav.start_leg(local_frame, &prev_WP, &next_WP);
+}
+
+static void replay_ntun(const int32_t *v, uint16_t log_number)
+{
+	uint8_t wp_control = v[10];
+
+	if (rs.gps < 2) {
+		// no dTnav yet
+		return;
+	}
+	wp_distance		= v[0];
+	target_bearing	= v[1] * 100;
+
+	if (wp_control != rs.wp_control) {
+		// start from where the firmware's controller was
+		pi_nav_lon.set_integrator(v[6]);
+		pi_nav_lat.set_integrator(v[7]);
+		pi_loiter_lon.set_integrator(v[8]);
+		pi_loiter_lat.set_integrator(v[9]);
+		rs.wp_control = wp_control;
+		return;
+	}
+
+	if (wp_control == WP_MODE) {
+		wp_nav.update_crosstrack(local_frame, &current_loc, &next_WP,
+								 target_bearing, original_target_bearing, crosstrack_gain);
+		wp_nav.calc_nav_rate(waypoint_speed_max, wp_distance,
+							 target_bearing - g_gps->ground_course, g_gps->ground_speed, dTnav);
+	} else {
+		// there's no optical flow in the log
+		wp_nav.set_ground_velocity(g_gps->ground_course, g_gps->ground_speed);
+		wp_nav.calc_loiter(v[2], v[3], dTnav);
+	}
+
+	printf("NTUN,%u,%.2f,%d,%d,%d,%d\n", log_number, replay_time(),
+		   v[4], v[5], wp_nav.nav_lon, wp_nav.nav_lat);
+	if (replay_time() >= settle) {
+		rs.ntun_sq[0] += sq((float)(wp_nav.nav_lon - v[4]));
+		rs.ntun_sq[1] += sq((float)(wp_nav.nav_lat - v[5]));
+		rs.ntun_count++;
+	}
+}
+
+static void replay_att(const int32_t *v, uint16_t log_number)
+{
+	float roll	= dcm->roll_sensor() / 100.0;
+	float pitch	= dcm->pitch_sensor() / 100.0;
+	float yaw	= dcm->yaw_sensor() / 100.0;
+	float dyaw;
+
+	if (rs.raw == 0) {
+		return;
+	}
+	printf("ATT,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", log_number, replay_time(),
+		   v[0] / 100.0, v[1] / 100.0, v[2] / 100.0, roll, pitch, yaw);
+	if (replay_time() >= settle) {
+		dyaw = APM_Nav::wrap_180((yaw - v[2] / 100.0) * 100) / 100.0;
+		rs.att_sq[0] += sq(roll - v[0] / 100.0);
+		rs.att_sq[1] += sq(pitch - v[1] / 100.0);
+		rs.att_sq[2] += sq(dyaw);
+		rs.att_count++;
+	}
+}
+
+static void replay_packet(const struct Log_Format *fmt, const int32_t *v, uint16_t log_number)
+{
+	switch (kinds[fmt->type]) {
+	case REC_ATT:	replay_att(v, log_number);	break;
+	case REC_GPS:	replay_gps(v);				break;
+	case REC_NTUN:	replay_ntun(v, log_number);	break;
+	case REC_RAW:	replay_raw(v);				break;
+	case REC_CMD:	replay_cmd(v);				break;
+	case REC_MAG:	replay_mag(v);				break;
+	}
+}
+
+static void replay_finish(uint16_t log_number, const struct log_stats *stats)
+{
+	float elapsed = (replay_nsec() - rs.start_nsec) * 1.0e-9;
+
+	fprintf(stderr, "log %u: %.1fs of flight in %.2fs", log_number, replay_time(), elapsed);
+	if (elapsed > 0) {
+		fprintf(stderr, " (%.0fx)", replay_time() / elapsed);
+	}
+	fprintf(stderr, "\n");
+	if (rs.raw == 0) {
+		fprintf(stderr, "  no RAW records, enable RAW logging to replay the attitude\n");
+	}
+	if (rs.att_count != 0) {
+		fprintf(stderr, "  ATT  rms roll %.2f pitch %.2f yaw %.2f degrees over %u records\n",
+				sqrt(rs.att_sq[0] / rs.att_count),
+				sqrt(rs.att_sq[1] / rs.att_count),
+				sqrt(rs.att_sq[2] / rs.att_count),
+				rs.att_count);
+	}
+	if (rs.ntun_count != 0) {
+		fprintf(stderr, "  NTUN rms nav_lon %.1f nav_lat %.1f over %u records\n",
+				sqrt(rs.ntun_sq[0] / rs.ntun_count),
+				sqrt(rs.ntun_sq[1] / rs.ntun_count),
+				rs.ntun_count);
+	}
+	if (stats->unknown != 0 || stats->bad_end != 0 || stats->no_keyframe != 0) {
+		fprintf(stderr, "  skipped %u unknown, %u with a bad end byte and %u delta records without a keyframe\n",
+				stats->unknown, stats->bad_end, stats->no_keyframe);
+	}
+}
+
+void setup(void)
+{
+	static const struct log_reader	reader = { replay_start, replay_format, replay_packet, replay_finish };
+	static char						out_buf[1 << 16];
+	const char						*image = "dataflash.bin";
+	const char						*s;
+	uint32_t						page_size = 512;
+	bool							raw = false;
+
+	if ((s = getenv("REPLAY_IMAGE")) != NULL) {
+		image = s;
+	}
+	if ((s = getenv("REPLAY_LOG")) != NULL) {
+		only_log = atoi(s);
+	}
+	if ((s = getenv("REPLAY_PAGE_SIZE")) != NULL) {
+		page_size = atoi(s);
+	}
+	if ((s = getenv("REPLAY_RAW")) != NULL) {
+		raw = atoi(s) != 0;
+	}
+	settle = env_float("REPLAY_SETTLE", settle);
+
+	pi_nav_lat.kP(env_float("REPLAY_NAV_P", NAV_P));
+	pi_nav_lat.kI(env_float("REPLAY_NAV_I", NAV_I));
+	pi_nav_lat.imax(env_float("REPLAY_NAV_IMAX", NAV_IMAX) * 100);
+	pi_nav_lon.kP(pi_nav_lat.kP());
+	pi_nav_lon.kI(pi_nav_lat.kI());
+	pi_nav_lon.imax(pi_nav_lat.imax());
+	pi_loiter_lat.kP(env_float("REPLAY_LOITER_P", LOITER_P));
+	pi_loiter_lat.kI(env_float("REPLAY_LOITER_I", LOITER_I));
+	pi_loiter_lat.imax(env_float("REPLAY_LOITER_IMAX", LOITER_IMAX) * 100);
+	pi_loiter_lon.kP(pi_loiter_lat.kP());
+	pi_loiter_lon.kI(pi_loiter_lat.kI());
+	pi_loiter_lon.imax(pi_loiter_lat.imax());
+	waypoint_speed_max = env_float("REPLAY_WP_SPEED", WAYPOINT_SPEED_MAX);
+	crosstrack_gain = env_float("REPLAY_XTRK_GAIN", CROSSTRACK_GAIN);
+
+	setvbuf(stdout, out_buf, _IOFBF, sizeof(out_buf));
+	if (!log_read_image(image, page_size, raw, &reader)) {
+		exit(1);
+	}
+	fflush(stdout);
+	exit(0);
+}
+
+void loop(void)
+{
+}
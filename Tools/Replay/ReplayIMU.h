@@ -0,0 +1,34 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	ReplayIMU.h
+/// @brief	An IMU that hands on the gyro and accel values of the RAW
+///         records of a log.
+
+#ifndef ReplayIMU_h
+#define ReplayIMU_h
+
+#include <AP_IMU.h>
+
+class ReplayIMU : public IMU
+{
+public:
+	ReplayIMU() {}
+
+	/// Set the values the next updates return. They are what
+	/// IMU::get_gyro() and IMU::get_accel() returned when the record
+	/// was written, so calibration has already been applied.
+	///
+	void		set_sample(const Vector3f &gyro, const Vector3f &accel) {
+		_gyro = gyro;
+		_accel = accel;
+	}
+
+	/// Hold the last sample for one step of the 200Hz fast loop.
+	///
+	virtual bool	update(void) {
+		_sample_time = 5000;
+		return true;
+	}
+};
+
+#endif
@@ -200,6 +200,7 @@
 #include <APM_BMP085.h> 	// ArduPilot Mega BMP085 Library 
 #include <DataFlash.h>		// ArduPilot Mega Flash Memory Library
 #include <AP_Compass.h>	        // ArduPilot Mega Magnetometer Library
+#include <AP_Math.h>             // ArduPilot Mega Vector/Matrix math Library
 #include <Wire.h>               // I2C Communication library
 #include <EEPROM.h>             // EEPROM 
 #include <AP_RangeFinder.h>     // RangeFinders (Sonars, IR Sensors)
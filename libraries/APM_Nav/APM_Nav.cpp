@@ -0,0 +1,163 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	APM_Nav.cpp
+/// @brief	The ArduCopter navigation rate controllers
+
+#include <stdlib.h>
+#include "APM_Nav.h"
+
+#define RADX100			0.000174533		// radians per degree * 100
+
+#define NAV_ERR_MAX		800
+
+APM_Nav::APM_Nav(APM_PI &pi_nav_lat, APM_PI &pi_nav_lon,
+				 APM_PI &pi_loiter_lat, APM_PI &pi_loiter_lon) :
+	x_actual_speed(0),
+	y_actual_speed(0),
+	x_rate_error(0),
+	y_rate_error(0),
+	crosstrack_error(0),
+	nav_lat(0),
+	nav_lon(0),
+	_pi_nav_lat(pi_nav_lat),
+	_pi_nav_lon(pi_nav_lon),
+	_pi_loiter_lat(pi_loiter_lat),
+	_pi_loiter_lon(pi_loiter_lon),
+	_speed_gov(0),
+	_leg_north(0),
+	_leg_east(0)
+{
+}
+
+// work out the direction of the leg once, when it is set, so
+// update_crosstrack() doesn't need any trig
+void
+APM_Nav::start_leg(const LocalFrame &frame,
+				   const struct Location *from, const struct Location *to)
+{
+	Vector2f leg 	= frame.offset(from, to);
+	float length 	= leg.length();
+
+	if (length < 1) {
+		// no track to follow
+		_leg_north 	= 0;
+		_leg_east 	= 0;
+	} else {
+		_leg_north 	= leg.x / length;
+		_leg_east 	= leg.y / length;
+	}
+
+	// the speed governor starts again on each leg
+	_speed_gov = 0;
+}
+
+void
+APM_Nav::reset(void)
+{
+	crosstrack_error 	= 0;
+	nav_lat 			= 0;
+	nav_lon 			= 0;
+}
+
+void
+APM_Nav::update_crosstrack(const LocalFrame &frame,
+						   const struct Location *loc, const struct Location *wp,
+						   int32_t bearing, int32_t leg_bearing, float gain)
+{
+	// If we are too far off or too close we don't do track following
+	if (labs(wrap_180(bearing - leg_bearing)) < 5000) {
+		// the sin of the angle between us and the leg, times the
+		// distance to go, is the cross product of the leg with the
+		// vector to the WP
+		Vector2f to_wp = frame.offset(loc, wp);
+		crosstrack_error = to_wp.y * _leg_north - to_wp.x * _leg_east;	 // Meters we are off track line
+
+		crosstrack_error = constrain(crosstrack_error * gain, -1200, 1200);
+	}
+}
+
+void
+APM_Nav::calc_nav_rate(int max_speed, int32_t distance,
+					   int32_t course_error, int32_t ground_speed, float dt)
+{
+	/*
+			   |< WP Radius
+	0  1   2   3   4   5   6   7   8m
+	...|...|...|...|...|...|...|...|
+		  100  |  200	  300	  400cm/s
+	           |  		 		            +|+
+	           |< we should slow to 1.5 m/s as we hit the target
+	*/
+
+	// max_speed is default 400 or 4m/s
+	// (distance * 50) = 1/2 of the distance converted to speed
+	// distance is always in m/s and not cm/s - I know it's stupid that way
+	// for example 4m from target = 200cm/s speed
+	// we choose the lowest speed based on disance
+	max_speed 		= min(max_speed, (distance * 50));
+
+	// limit the ramp up of the speed
+	// _speed_gov is reset to 0 at each new leg
+	if(_speed_gov < max_speed){
+		_speed_gov += (int)(100.0 * dt); // increase at 1.5/ms
+
+		// go at least 50cm/s
+		max_speed 		= max(50, _speed_gov);
+		// limit with governer
+		max_speed 		= min(max_speed, _speed_gov);
+	}
+
+	float temp 		= course_error * RADX100;
+
+	// heading laterally, we want a zero speed here
+	x_actual_speed 	= -fast_sin(temp) * (float)ground_speed;
+	x_rate_error 	= crosstrack_error -x_actual_speed;
+	x_rate_error 	= constrain(x_rate_error, -800, 800);
+	nav_lon		 	= constrain(_pi_nav_lon.get_pi(x_rate_error, dt), -3500, 3500);
+
+	// heading towards target
+	y_actual_speed 	= fast_cos(temp) * (float)ground_speed;
+	y_rate_error 	= max_speed - y_actual_speed; // 413
+	y_rate_error 	= constrain(y_rate_error, -800, 800);	// added a rate error limit to keep pitching down to a minimum
+	nav_lat		 	= constrain(_pi_nav_lat.get_pi(y_rate_error, dt), -3500, 3500);
+
+	// nav_lat and nav_lon are still to be rotated to the angle of
+	// the quad
+}
+
+void
+APM_Nav::set_ground_velocity(int32_t ground_course, int32_t ground_speed)
+{
+	float temp		= ground_course * RADX100;
+
+	x_actual_speed 	= (float)ground_speed * fast_sin(temp);
+	y_actual_speed 	= (float)ground_speed * fast_cos(temp);
+}
+
+void
+APM_Nav::calc_loiter(int x_error, int y_error, float dt)
+{
+	x_error = constrain(x_error, -NAV_ERR_MAX, NAV_ERR_MAX);
+	y_error = constrain(y_error, -NAV_ERR_MAX, NAV_ERR_MAX);
+
+	int x_target_speed = _pi_loiter_lon.get_pi(x_error, dt);
+	int y_target_speed = _pi_loiter_lat.get_pi(y_error, dt);
+
+	y_rate_error 	= y_target_speed - y_actual_speed; // 413
+	y_rate_error 	= constrain(y_rate_error, -250, 250);	// added a rate error limit to keep pitching down to a minimum
+	nav_lat		 	= _pi_nav_lat.get_pi(y_rate_error, dt);
+	nav_lat			= constrain(nav_lat, -3500, 3500);
+
+	x_rate_error 	= x_target_speed - x_actual_speed;
+	x_rate_error 	= constrain(x_rate_error, -250, 250);
+	nav_lon		 	= _pi_nav_lon.get_pi(x_rate_error, dt);
+	nav_lon			= constrain(nav_lon, -3500, 3500);
+}
+
+int32_t
+APM_Nav::wrap_180(int32_t error)
+{
+	if (error > 18000)	error -= 36000;
+	if (error < -18000)	error += 36000;
+	return error;
+}
@@ -0,0 +1,109 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	APM_Nav.h
+/// @brief	The ArduCopter navigation rate controllers, which turn a
+///			distance to a target into nav_lat and nav_lon, the pitch
+///			and roll wanted in the north-east frame.
+///
+/// These are kept out of the sketch so that the tools which benchmark
+/// and replay the navigation run the same code as the copter.
+
+#ifndef APM_Nav_h
+#define APM_Nav_h
+
+#include <AP_Common.h>
+#include <AP_Math.h>
+#include <APM_PI.h>
+
+/// @class	APM_Nav
+/// @brief	Waypoint and loiter rate control
+class APM_Nav {
+public:
+	/// Constructor
+	///
+	/// @param	pi_nav_lat		PI from the speed error towards the
+	///							target (or north when loitering) to nav_lat.
+	/// @param	pi_nav_lon		PI from the speed error across the track
+	///							(or east when loitering) to nav_lon.
+	/// @param	pi_loiter_lat	PI from the distance north to the speed
+	///							wanted when loitering.
+	/// @param	pi_loiter_lon	PI from the distance east to the speed
+	///							wanted when loitering.
+	///
+	APM_Nav(APM_PI &pi_nav_lat, APM_PI &pi_nav_lon,
+			APM_PI &pi_loiter_lat, APM_PI &pi_loiter_lon);
+
+	/// Start a leg from one location to another: work out the direction
+	/// of the leg for update_crosstrack() and reset the speed governor.
+	///
+	void		start_leg(const LocalFrame &frame,
+						  const struct Location *from, const struct Location *to);
+
+	/// Clear the controller outputs.
+	///
+	void		reset(void);
+
+	/// Update crosstrack_error, the speed towards the track wanted, in
+	/// cm/s, unless the bearing to the target is 50 degrees or more
+	/// off the bearing at the start of the leg.
+	///
+	/// @param	loc				The current location.
+	/// @param	wp				The location at the end of the leg.
+	/// @param	bearing			The bearing to wp, in degrees * 100.
+	/// @param	leg_bearing		The bearing to wp at the start of the leg.
+	/// @param	gain			The speed wanted per meter off the track.
+	///
+	void		update_crosstrack(const LocalFrame &frame,
+								  const struct Location *loc, const struct Location *wp,
+								  int32_t bearing, int32_t leg_bearing, float gain);
+
+	/// Iterate the waypoint controller. Call update_crosstrack() first.
+	///
+	/// @param	max_speed		The fastest to fly to the target, in cm/s.
+	/// @param	distance		The distance to the target, in meters.
+	/// @param	course_error	The bearing to the target less the
+	///							ground course, in degrees * 100.
+	/// @param	ground_speed	The ground speed, in cm/s.
+	/// @param	dt				The time since the last call, in seconds.
+	///
+	void		calc_nav_rate(int max_speed, int32_t distance,
+							  int32_t course_error, int32_t ground_speed, float dt);
+
+	/// Set x_actual_speed and y_actual_speed, east and north, from the
+	/// GPS ground course (degrees * 100) and speed (cm/s).
+	///
+	void		set_ground_velocity(int32_t ground_course, int32_t ground_speed);
+
+	/// Iterate the loiter controller, from x_actual_speed and
+	/// y_actual_speed and the distance to the target.
+	///
+	/// @param	x_error			The distance east to the target, in cm.
+	/// @param	y_error			The distance north to the target, in cm.
+	/// @param	dt				The time since the last call, in seconds.
+	///
+	void		calc_loiter(int x_error, int y_error, float dt);
+
+	/// Wrap an angle in degrees * 100 to -18000 to 18000.
+	///
+	static int32_t wrap_180(int32_t error);
+
+	int16_t		x_actual_speed;		///< cm/s east, or across the track
+	int16_t		y_actual_speed;		///< cm/s north, or towards the target
+	int16_t		x_rate_error;
+	int16_t		y_rate_error;
+	int16_t		crosstrack_error;	///< cm/s towards the track
+	int32_t		nav_lat;			///< pitch wanted, degrees * 100
+	int32_t		nav_lon;			///< roll wanted, degrees * 100
+
+private:
+	APM_PI		&_pi_nav_lat;
+	APM_PI		&_pi_nav_lon;
+	APM_PI		&_pi_loiter_lat;
+	APM_PI		&_pi_loiter_lon;
+
+	int16_t		_speed_gov;			///< speed ramp since the start of the leg
+	float		_leg_north;			///< unit vector along the leg
+	float		_leg_east;
+};
+
+#endif
@@ -133,9 +133,9 @@ void DcmNavigator::updateFast(float dt) {
     // dcm class for attitude
     if (_dcm) {
         _dcm->update_DCM_fast();
-        setRoll(_dcm->roll);
-        setPitch(_dcm->pitch);
-        setYaw(_dcm->yaw);
+        setRoll(_dcm->roll());
+        setPitch(_dcm->pitch());
+        setYaw(_dcm->yaw());
         setRollRate(_dcm->get_gyro().x);
         setPitchRate(_dcm->get_gyro().y);
         setYawRate(_dcm->get_gyro().z);
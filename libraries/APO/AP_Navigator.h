@@ -20,6 +20,7 @@
 #define AP_Navigator_H
 
 #include "constants.h"
+#include "../AP_Math/fast_math.h"
 #include <inttypes.h>
 
 class RangeFinder;
@@ -46,13 +47,13 @@ public:
 
     float getAirSpeed() const {
         // neglects vertical wind
-        float vWN = getVN() + getWindSpeed()*cos(getWindDirection());
-        float vWE = getVE() + getWindSpeed()*sin(getWindDirection());
-        return sqrt(vWN*vWN+vWE+vWE+getVD()*getVD());
+        float vWN = getVN() + getWindSpeed()*fast_cos(getWindDirection());
+        float vWE = getVE() + getWindSpeed()*fast_sin(getWindDirection());
+        return fast_sqrt(vWN*vWN+vWE+vWE+getVD()*getVD());
     }
 
     float getGroundSpeed() const {
-        return sqrt(getVN()*getVN()+getVE()*getVE());
+        return fast_sqrt(getVN()*getVN()+getVE()*getVE());
     } 
 
     float getWindSpeed() const {
@@ -143,7 +144,7 @@ public:
     }
 
     float getCourseOverGround() const {
-        return atan2(getVE(),getVN());
+        return fast_atan2(getVE(),getVN());
     }
 
     float getRelativeCourseOverGround() const {
@@ -156,7 +157,7 @@ public:
     }
 
     float getSpeedOverGround() const {
-        return sqrt(getVN()*getVN()+getVE()*getVE());
+        return fast_sqrt(getVN()*getVN()+getVE()*getVE());
     }
 
     float getXAccel() const {
@@ -174,7 +175,7 @@ public:
     void setAirSpeed(float airSpeed) {
         // assumes wind constant and rescale navigation speed
         float vScale = (1 + airSpeed/getAirSpeed());
-        float vNorm = sqrt(getVN()*getVN()+getVE()*getVE()+getVD()*getVD());
+        float vNorm = fast_sqrt(getVN()*getVN()+getVE()*getVE()+getVD()*getVD());
         _vN *= vScale/vNorm;
         _vE *= vScale/vNorm;
         _vD *= vScale/vNorm;
@@ -210,8 +211,8 @@ public:
 
     void setGroundSpeed(float groundSpeed) {
         float cog = getCourseOverGround();
-        _vN = cos(cog)*groundSpeed;
-        _vE = sin(cog)*groundSpeed;
+        _vN = fast_cos(cog)*groundSpeed;
+        _vE = fast_sin(cog)*groundSpeed;
     }
 
     void setLat_degInt(int32_t lat_degInt) {
@@ -157,7 +157,9 @@ void AP_ADC_ADS7844::Init( AP_PeriodicProcess * scheduler )
 
 	last_ch6_micros = micros();
 
-    scheduler->register_process( AP_ADC_ADS7844::read );
+    // sample every timer tick; a full 8 channel read is about 17
+    // SPI bytes at 2.6MHz
+    scheduler->register_process( AP_ADC_ADS7844::read, 1, 200 );
 
 }
 
@@ -13,6 +13,7 @@
 #include <AP_Common.h>
 
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 //#define ENABLE_FASTSERIAL_DEBUG
@@ -36,6 +37,11 @@ AP_Var      *AP_Var::_variables;
 AP_Var      *AP_Var::_grouped_variables;
 uint16_t    AP_Var::_tail_sentinel;
 uint16_t    AP_Var::_bytes_in_use;
+AP_Var::Index_Entry *AP_Var::_index;
+uint16_t    AP_Var::_index_size;
+uint16_t    AP_Var::_name_index_count;
+uint16_t    AP_Var::_key_index_count;
+bool        AP_Var::_index_valid;
 
 // Constructor for standalone variables
 //
@@ -51,6 +57,7 @@ AP_Var::AP_Var(Key p_key, const prog_char_t *name, Flags flags) :
     if (!has_flags(k_flag_unlisted)) {
         _link = _variables;
         _variables = this;
+        _invalidate_index();
     }
 }
 
@@ -85,6 +92,7 @@ AP_Var::AP_Var(AP_Var_group *pGroup, Key index, const prog_char_t *name, Flags f
     }
     _link = *vp;
     *vp = this;
+    _invalidate_index();
 }
 
 // Destructor
@@ -93,6 +101,13 @@ AP_Var::~AP_Var(void)
 {
     AP_Var  **vp;
 
+    // Only a variable the indices hold, or a group whose members they may
+    // hold, makes them stale; unlisted temporaries come and go freely.
+    //
+    if (has_flags(k_flag_is_group) || _indexed()) {
+        _invalidate_index();
+    }
+
     // Determine which list the variable may be in.
     // If the variable is a group member and the group has already
     // been destroyed, it may not be in any list.
@@ -155,12 +170,178 @@ void AP_Var::copy_name(char *buffer, size_t buffer_size) const
     }
 }
 
+// Hash a name, one character at a time.
+//
+#define NAME_HASH_STEP(_hash, _c)   (((_hash) << 5) - (_hash) + (uint8_t)(_c))
+
+uint16_t
+AP_Var::_name_hash(uint16_t hash) const
+{
+    const prog_char_t *p = _name;
+    char c;
+
+    // group members are named with the group's name as a prefix
+    if (_group) {
+        hash = ((const AP_Var *)_group)->_name_hash(hash);
+    }
+    if (p) {
+        while ((c = pgm_read_byte((const prog_char *)p++)) != 0) {
+            hash = NAME_HASH_STEP(hash, c);
+        }
+    }
+    return hash;
+}
+
+uint16_t
+AP_Var::_string_hash(const char *name)
+{
+    uint16_t hash = 0;
+
+    while (*name) {
+        hash = NAME_HASH_STEP(hash, *name++);
+    }
+    return hash;
+}
+
+// Discard the lookup indices. The memory is kept for the next build.
+//
+void
+AP_Var::_invalidate_index(void)
+{
+    _index_valid = false;
+    _name_index_count = 0;
+    _key_index_count = 0;
+}
+
+bool
+AP_Var::_indexed(void)
+{
+    // unlisted freestanding variables aren't in the list the indices are
+    // built from
+    if (!_group && has_flags(k_flag_unlisted)) {
+        return false;
+    }
+    return _name || key() != k_key_none;
+}
+
+// Put a variable into a sorted index with a binary search and a memmove.
+//
+void
+AP_Var::_index_insert(Index_Entry *index, uint16_t count, uint16_t value, AP_Var *vp)
+{
+    uint16_t lo = 0, hi = count, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (index[mid].value <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    memmove(&index[lo + 1], &index[lo], (count - lo) * sizeof(index[0]));
+    index[lo].value = value;
+    index[lo].var = vp;
+}
+
+// Build the lookup indices.
+//
+// Both indices live in _index, the names first and the keys after them.
+// The variables are counted first, and _index is allocated for them on
+// the first build, and again only if a later build finds more of them.
+// Each name is hashed, and each key read, once per build.
+//
+bool
+AP_Var::_build_index(void)
+{
+    AP_Var      *vp;
+    uint16_t    names = 0, keys = 0;
+    size_t      loopCount = 0;
+
+    if (_index_valid) {
+        return true;
+    }
+
+    // count the variables we will index
+    for (vp = first(); vp; vp = vp->next()) {
+        if (loopCount++>k_num_max) return false;
+        if (vp->_name) {
+            names++;
+        }
+        if (!vp->_group && (vp->key() != k_key_none)) {
+            keys++;
+        }
+    }
+    if (names + keys == 0) {
+        return false;
+    }
+    if (names + keys > _index_size) {
+        free(_index);
+        _index = (Index_Entry *)malloc((names + keys) * sizeof(_index[0]));
+        if (_index == NULL) {
+            // ::find will fall back to a linear search
+            _index_size = 0;
+            return false;
+        }
+        _index_size = names + keys;
+    }
+
+    // insert the named variables sorted by name hash
+    _name_index_count = 0;
+    for (vp = first(); vp; vp = vp->next()) {
+        if (vp->_name) {
+            _index_insert(_index, _name_index_count++, vp->_name_hash(), vp);
+        }
+    }
+
+    // insert the keyed freestanding variables sorted by key
+    _key_index_count = 0;
+    for (vp = _variables; vp; vp = vp->_link) {
+        Key key = vp->key();
+        if (key != k_key_none) {
+            _index_insert(&_index[_name_index_count], _key_index_count++, key, vp);
+        }
+    }
+
+    _index_valid = true;
+    return true;
+}
+
 // Find a variable by name.
 //
 AP_Var *
 AP_Var::find(const char *name)
 {
     AP_Var  *vp;
+    char    name_buffer[32];
+
+    if (_build_index()) {
+        uint16_t hash = _string_hash(name);
+        uint16_t lo = 0, hi = _name_index_count;
+
+        // binary search for the first variable with this hash
+        while (lo < hi) {
+            uint16_t mid = (lo + hi) / 2;
+            if (_index[mid].value < hash) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        // check every variable sharing the hash
+        for (; lo < _name_index_count; lo++) {
+            if (_index[lo].value != hash) {
+                break;
+            }
+            vp = _index[lo].var;
+            vp->copy_name(name_buffer, sizeof(name_buffer));
+            if (!strcmp(name, name_buffer)) {
+                return vp;
+            }
+        }
+        return NULL;
+    }
 
     size_t loopCount = 0;
 
@@ -168,8 +349,6 @@ AP_Var::find(const char *name)
 
         if (loopCount++>k_num_max) return NULL;
 
-        char    name_buffer[32];
-
         // copy the variable's name into our scratch buffer
         vp->copy_name(name_buffer, sizeof(name_buffer));
 
@@ -187,6 +366,27 @@ AP_Var *
 AP_Var::find(Key key)
 {
     AP_Var  *vp;
+
+    if (_build_index()) {
+        Index_Entry *key_index = &_index[_name_index_count];
+        uint16_t lo = 0, hi = _key_index_count;
+
+        while (lo < hi) {
+            uint16_t mid = (lo + hi) / 2;
+            Key     mid_key = key_index[mid].value;
+
+            if (mid_key == key) {
+                return key_index[mid].var;
+            }
+            if (mid_key < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return NULL;
+    }
+
     size_t loopCount = 0;
     for (vp = first(); vp; vp = vp->next()) {
         if (loopCount++>k_num_max) return NULL;
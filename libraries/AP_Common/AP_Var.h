@@ -216,6 +216,10 @@ public:
     ///
     /// If the variable has no name, it cannot be found by this interface.
     ///
+    /// Lookups go through an index of the variables sorted by name hash,
+    /// which is built on first use and rebuilt whenever a variable is
+    /// created or destroyed.
+    ///
     /// @param  name            The full name of the variable to be found.
     /// @return                 A pointer to the variable, or NULL if
     ///                         it does not exist.
@@ -390,6 +394,52 @@ private:
     static AP_Var       *_variables;        ///< linked list of all freestanding variables
     static AP_Var       *_grouped_variables; ///< linked list of all grouped variables
 
+    /// An entry in the lookup indices. The sort key is kept with the
+    /// variable so that a lookup doesn't read names out of program memory
+    /// or keys out of EEPROM as it goes.
+    struct Index_Entry {
+        uint16_t        value;              ///< ::_name_hash of var, or its key
+        AP_Var          *var;
+    };
+
+    // lookup indices used by ::find, allocated by ::_build_index for the
+    // variables there are
+    static Index_Entry  *_index;            ///< named variables by ::_name_hash, then keyed ones by key
+    static uint16_t     _index_size;        ///< number of entries allocated
+    static uint16_t     _name_index_count;  ///< number of named variables in _index
+    static uint16_t     _key_index_count;   ///< number of keyed variables following them
+    static bool         _index_valid;       ///< the indices are up to date
+
+    /// Compute the hash of the variable's whole name, as would be
+    /// returned by ::copy_name, without copying it out of program memory.
+    ///
+    /// @param  hash            The hash of any prefix already processed.
+    /// @return                 The hash of the prefix followed by the name.
+    ///
+    uint16_t            _name_hash(uint16_t hash = 0) const;
+
+    /// Compute the hash of a name held in RAM, compatible with ::_name_hash.
+    ///
+    static uint16_t     _string_hash(const char *name);
+
+    /// Build the name and key indices used by ::find.
+    ///
+    /// @return                 True if the indices are available.
+    ///
+    static bool         _build_index(void);
+
+    /// Insert a variable into a sorted index of count entries.
+    ///
+    static void         _index_insert(Index_Entry *index, uint16_t count, uint16_t value, AP_Var *vp);
+
+    /// Discard the lookup indices; called when the variable set changes.
+    ///
+    static void         _invalidate_index(void);
+
+    /// Check whether ::_build_index puts this variable in an index.
+    ///
+    bool                _indexed(void);
+
     // EEPROM space allocation and scanning
     static uint16_t     _tail_sentinel;     ///< EEPROM address of the tail sentinel
 
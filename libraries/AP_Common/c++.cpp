@@ -11,8 +11,17 @@
 #include "c++.h"
 #include "WProgram.h"
 
+#if DESKTOP_BUILD
+// count of heap allocations, so the desktop benchmarks can check that
+// the code under test does not allocate
+uint32_t heap_allocations;
+#endif
+
 void * operator new(size_t size)
 {
+#if DESKTOP_BUILD
+    heap_allocations++;
+#endif
 #ifdef AP_DISPLAYMEM
     displayMemory();
 #endif
@@ -35,6 +44,9 @@ extern "C" void __cxa_pure_virtual()
 
 void * operator new[](size_t size)
 {
+#if DESKTOP_BUILD
+    heap_allocations++;
+#endif
 #ifdef AP_DISPLAYMEM
     displayMemory();
 #endif
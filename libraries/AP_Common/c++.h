@@ -4,4 +4,9 @@
 void displayMemory();
 int freeMemory();
 
+#if DESKTOP_BUILD
+#include <stdint.h>
+extern uint32_t heap_allocations;
+#endif
+
 #endif
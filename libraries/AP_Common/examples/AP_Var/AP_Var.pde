@@ -223,6 +223,32 @@ setup(void)
         REQUIRE(!strcmp(name_buffer, "group_test"));
     }
 
+    // AP_Var: find by name and by key, as variables come and go
+    {
+        TEST(var_find);
+
+        AP_Float        f1(1.0, 20, PSTR("find1"));
+        AP_Float        f2(2.0, 21, PSTR("find2"));
+        AP_Var_group    group(22, PSTR("group_"));
+        AP_Float        f3(&group, 0, 3.0, PSTR("find3"));
+
+        REQUIRE(AP_Var::find("find1") == &f1);
+        REQUIRE(AP_Var::find("group_find3") == &f3);
+        REQUIRE(AP_Var::find("find3") == NULL);
+        REQUIRE(AP_Var::find((AP_Var::Key)21) == &f2);
+        REQUIRE(AP_Var::find((AP_Var::Key)22) == &group);
+        {
+            AP_Float    f4(4.0, 23, PSTR("find4"));
+            AP_Float    unlisted(5.0, AP_Var::k_key_none, NULL, AP_Var::k_flag_unlisted);
+
+            REQUIRE(AP_Var::find("find4") == &f4);
+            REQUIRE(AP_Var::find((AP_Var::Key)23) == &f4);
+        }
+        REQUIRE(AP_Var::find("find4") == NULL);
+        REQUIRE(AP_Var::find((AP_Var::Key)23) == NULL);
+        REQUIRE(AP_Var::find("find2") == &f2);
+    }
+
     // AP_Var: enumeration
     {
         TEST(empty_variables);
@@ -75,17 +75,17 @@ Compass::calculate(float roll, float pitch)
     float sin_roll;
     float cos_pitch;
     float sin_pitch;
-    cos_roll = cos(roll);
-	sin_roll = sin(roll);
-    cos_pitch = cos(pitch);
-	sin_pitch = sin(pitch);
+    cos_roll = fast_cos(roll);
+	sin_roll = fast_sin(roll);
+    cos_pitch = fast_cos(pitch);
+	sin_pitch = fast_sin(pitch);
 
     // Tilt compensated magnetic field X component:
     headX = mag_x*cos_pitch + mag_y*sin_roll*sin_pitch + mag_z*cos_roll*sin_pitch;
     // Tilt compensated magnetic field Y component:
     headY = mag_y*cos_roll - mag_z*sin_roll;
     // magnetic heading
-    heading = atan2(-headY,headX);
+    heading = fast_atan2(-headY,headX);
 
     // Declination correction (if supplied)
     if( fabs(_declination) > 0.0 )
@@ -98,8 +98,8 @@ Compass::calculate(float roll, float pitch)
     }
 
     // Optimization for external DCM use. Calculate normalized components
-    heading_x = cos(heading);
-    heading_y = sin(heading);
+    heading_x = fast_cos(heading);
+    heading_y = fast_sin(heading);
 }
 
 
@@ -108,7 +108,7 @@ Compass::calculate(const Matrix3f &dcm_matrix)
 {
     float headX;
     float headY;
-    float cos_pitch = sqrt(1-(dcm_matrix.c.x*dcm_matrix.c.x));
+    float cos_pitch = fast_sqrt(1-(dcm_matrix.c.x*dcm_matrix.c.x));
 	// sin(pitch) = - dcm_matrix(3,1)
 	// cos(pitch)*sin(roll) = - dcm_matrix(3,2)
 	// cos(pitch)*cos(roll) = - dcm_matrix(3,3)
@@ -119,7 +119,7 @@ Compass::calculate(const Matrix3f &dcm_matrix)
     headY = mag_y*dcm_matrix.c.z/cos_pitch - mag_z*dcm_matrix.c.y/cos_pitch;
     // magnetic heading
     // 6/4/11 - added constrain to keep bad values from ruining DCM Yaw - Jason S.
-	heading = constrain(atan2(-headY,headX), -3.15, 3.15);
+	heading = constrain(fast_atan2(-headY,headX), -3.15, 3.15);
 
     // Declination correction (if supplied)
     if( fabs(_declination) > 0.0 )
@@ -132,8 +132,8 @@ Compass::calculate(const Matrix3f &dcm_matrix)
     }
 
     // Optimization for external DCM use. Calculate normalized components
-    heading_x = cos(heading);
-    heading_y = sin(heading);
+    heading_x = fast_cos(heading);
+    heading_y = fast_sin(heading);
 }
 
 void
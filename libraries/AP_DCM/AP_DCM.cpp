@@ -53,23 +53,26 @@ AP_DCM::update_DCM_fast(void)
 
 	matrix_update(delta_t); 	// Integrate the DCM matrix
 
+	// the trig values are worked out when next asked for, but the
+	// Euler angles are refreshed on their own ticks below, so the fast
+	// loop never pays for all of them at once
+	_stale |= STALE_TRIG;
+
 	switch(_toggle++){
 		case 0:
 			normalize();				// Normalize the DCM matrix
 		break;
 
 		case 1:
-			//drift_correction();			// Normalize the DCM matrix
-			euler_rp();			// Calculate pitch, roll, yaw for stabilization and navigation
+			euler_rp();			// Calculate pitch, roll for stabilization and navigation
 		break;
 
 		case 2:
-			drift_correction();			// Normalize the DCM matrix
+			drift_correction();			// Perform drift correction
 		break;
 
 		case 3:
-			//drift_correction();			// Normalize the DCM matrix
-			euler_rp();			// Calculate pitch, roll, yaw for stabilization and navigation
+			euler_rp();			// Calculate pitch, roll for stabilization and navigation
 		break;
 
 		case 4:
@@ -77,9 +80,8 @@ AP_DCM::update_DCM_fast(void)
 		break;
 
 		default:
-			euler_rp();			// Calculate pitch, roll, yaw for stabilization and navigation
+			euler_rp();			// Calculate pitch, roll for stabilization and navigation
 			_toggle = 0;
-			//drift_correction();			// Normalize the DCM matrix
 		break;
 	}
 }
@@ -99,7 +101,9 @@ AP_DCM::update_DCM(void)
 	matrix_update(delta_t); 	// Integrate the DCM matrix
 	normalize();			// Normalize the DCM matrix
 	drift_correction();		// Perform drift correction
-	euler_angles();			// Calculate pitch, roll, yaw for stabilization and navigation
+
+	// the Euler angles and trig values are worked out when next asked for
+	_stale = STALE_ALL;
 }
 
 /**************************************************/
@@ -122,9 +126,6 @@ printm(const char *l, Matrix3f &m)
 void
 AP_DCM::matrix_update(float _G_Dt)
 {
-	Matrix3f	update_matrix;
-	Matrix3f	temp_matrix;
-
 	_omega_integ_corr 	= _gyro_vector 		+ _omega_I;		// Used for _centripetal correction (theoretically better than _omega)
 	_omega 				= _omega_integ_corr + _omega_P;		// Equation 16, adding proportional and integral correction terms
 
@@ -132,36 +133,13 @@ AP_DCM::matrix_update(float _G_Dt)
 		accel_adjust();				// Remove _centripetal acceleration.
 	}
 
+	// Equation 17: R = R + R * skew(omega * dt), done in place on the rows
+	// of the matrix so no update or temporary matrix is needed
  #if OUTPUTMODE == 1
- 	float tmp = _G_Dt * _omega.x;
-	update_matrix.b.z = -tmp; 		// -delta Theta x
-	update_matrix.c.y =  tmp; 		// delta Theta x
-
- 	tmp = _G_Dt * _omega.y;
-	update_matrix.c.x = -tmp; 		// -delta Theta y
-	update_matrix.a.z =  tmp; 		// delta Theta y
-
- 	tmp = _G_Dt * _omega.z;
-	update_matrix.b.x =  tmp; 		// delta Theta z
-	update_matrix.a.y = -tmp; 		// -delta Theta z
-
-	update_matrix.a.x = 0;
-	update_matrix.b.y = 0;
-	update_matrix.c.z = 0;
+	_dcm_matrix.rotate(_omega * _G_Dt);
  #else										// Uncorrected data (no drift correction)
-	update_matrix.a.x = 0;
-	update_matrix.a.y = -_G_Dt * _gyro_vector.z;
-	update_matrix.a.z =  _G_Dt * _gyro_vector.y;
-	update_matrix.b.x =  _G_Dt * _gyro_vector.z;
-	update_matrix.b.y = 0;
-	update_matrix.b.z = -_G_Dt * _gyro_vector.x;
-	update_matrix.c.x = -_G_Dt * _gyro_vector.y;
-	update_matrix.c.y =  _G_Dt * _gyro_vector.x;
-	update_matrix.c.z = 0;
+	_dcm_matrix.rotate(_gyro_vector * _G_Dt);
  #endif
-
-	temp_matrix = _dcm_matrix * update_matrix;
-	_dcm_matrix = _dcm_matrix + temp_matrix;		// Equation 17
 }
 
 
@@ -196,23 +174,32 @@ We call the process of enforcing the orthogonality conditions 
 void
 AP_DCM::normalize(void)
 {
-	float error = 0;
-	Vector3f	temporary[3];
-
+	float error;
+	float ax, ay, az;
 	int problem = 0;
 
-	error = _dcm_matrix.a * _dcm_matrix.b; 							// eq.18
-
-	temporary[0] = _dcm_matrix.b;
-	temporary[1] = _dcm_matrix.a;
-	temporary[0] = _dcm_matrix.a - (temporary[0] * (0.5f * error));		// eq.19
-	temporary[1] = _dcm_matrix.b - (temporary[1] * (0.5f * error));		// eq.19
-
-	temporary[2] = temporary[0] % temporary[1];							// c= a x b // eq.20
-
-	_dcm_matrix.a = renorm(temporary[0], problem);
-	_dcm_matrix.b = renorm(temporary[1], problem);
-	_dcm_matrix.c = renorm(temporary[2], problem);
+	error = 0.5f * (_dcm_matrix.a * _dcm_matrix.b); 				// eq.18
+
+	// eq.19, share the error between the a and b rows. The original a
+	// row is kept in scalars since b needs it after a has been updated.
+	ax = _dcm_matrix.a.x;
+	ay = _dcm_matrix.a.y;
+	az = _dcm_matrix.a.z;
+	_dcm_matrix.a.x -= _dcm_matrix.b.x * error;
+	_dcm_matrix.a.y -= _dcm_matrix.b.y * error;
+	_dcm_matrix.a.z -= _dcm_matrix.b.z * error;
+	_dcm_matrix.b.x -= ax * error;
+	_dcm_matrix.b.y -= ay * error;
+	_dcm_matrix.b.z -= az * error;
+
+	// c= a x b // eq.20
+	_dcm_matrix.c.x = _dcm_matrix.a.y * _dcm_matrix.b.z - _dcm_matrix.a.z * _dcm_matrix.b.y;
+	_dcm_matrix.c.y = _dcm_matrix.a.z * _dcm_matrix.b.x - _dcm_matrix.a.x * _dcm_matrix.b.z;
+	_dcm_matrix.c.z = _dcm_matrix.a.x * _dcm_matrix.b.y - _dcm_matrix.a.y * _dcm_matrix.b.x;
+
+	renorm(_dcm_matrix.a, problem);
+	renorm(_dcm_matrix.b, problem);
+	renorm(_dcm_matrix.c, problem);
 
 	if (problem == 1) {		// Our solution is blowing up and we will force back to initial condition.	Hope we are not upside down!
 		_dcm_matrix.a.x = 1.0f;
@@ -231,8 +218,8 @@ AP_DCM::normalize(void)
 }
 
 /**************************************************/
-Vector3f
-AP_DCM::renorm(Vector3f const &a, int &problem)
+void
+AP_DCM::renorm(Vector3f &a, int &problem)
 {
 	float	renorm_val;
 
@@ -248,7 +235,7 @@ AP_DCM::renorm(Vector3f const &a, int &problem)
 		renorm_blowup_count++;
 	}
 
-	return(a * renorm_val);
+	a *= renorm_val;
 }
 
 /**************************************************/
@@ -308,7 +295,7 @@ AP_DCM::drift_correction(void)
 			if(in_motion) {
 				error_course = (_dcm_matrix.a.x * _course_over_ground_y) - (_dcm_matrix.b.x * _course_over_ground_x);	// Equation 23, Calculating YAW error
 			} else  {
-				float cos_psi_err, sin_psi_err;
+				float cos_psi_err, sin_psi_err, yaw;
 				// This is the case for when we first start moving and reset the DCM so that yaw matches the gps ground course
 				// This is just to get a reasonable estimate faster
 				yaw = atan2(_dcm_matrix.b.x, _dcm_matrix.a.x);
@@ -354,43 +341,51 @@ AP_DCM::drift_correction(void)
 
 /**************************************************/
 void
-AP_DCM::euler_angles(void)
+AP_DCM::euler_rp(void)
 {
 	#if (OUTPUTMODE == 2)				 // Only accelerometer info (debugging purposes)
-	roll 		= atan2(_accel_vector.y, -_accel_vector.z);		// atan2(acc_y, acc_z)
-	pitch 		= asin((_accel_vector.x) / (double)9.81); // asin(acc_x)
-	yaw 			= 0;
+	_roll 			= atan2(_accel_vector.y, -_accel_vector.z);		// atan2(acc_y, acc_z)
+	_pitch 			= asin((_accel_vector.x) / (double)9.81); // asin(acc_x)
 	#else
-	pitch 		= -asin(_dcm_matrix.c.x);
-	roll 		= atan2(_dcm_matrix.c.y, _dcm_matrix.c.z);
-	yaw 		= atan2(_dcm_matrix.b.x, _dcm_matrix.a.x);
+	_pitch 			= -asin(_dcm_matrix.c.x);
+	_roll 			= atan2(_dcm_matrix.c.y, _dcm_matrix.c.z);
 	#endif
-
-	roll_sensor 	= degrees(roll)  * 100;
-	pitch_sensor 	= degrees(pitch) * 100;
-	yaw_sensor 		= degrees(yaw)   * 100;
-
-	if (yaw_sensor < 0)
-		yaw_sensor += 36000;
+	_roll_sensor 	= degrees(_roll)  * 100;
+	_pitch_sensor 	= degrees(_pitch) * 100;
+	_stale &= ~STALE_EULER_RP;
 }
 
 void
-AP_DCM::euler_rp(void)
+AP_DCM::euler_yaw(void)
 {
-	pitch 			= -asin(_dcm_matrix.c.x);
-	roll 			= atan2(_dcm_matrix.c.y, _dcm_matrix.c.z);
-	roll_sensor 	= degrees(roll)  * 100;
-	pitch_sensor 	= degrees(pitch) * 100;
+	#if (OUTPUTMODE == 2)
+	_yaw 			= 0;
+	#else
+	_yaw 			= atan2(_dcm_matrix.b.x, _dcm_matrix.a.x);
+	#endif
+	_yaw_sensor 	= degrees(_yaw)   * 100;
+
+	if (_yaw_sensor < 0)
+		_yaw_sensor += 36000;
+	_stale &= ~STALE_EULER_YAW;
 }
 
+/**************************************************/
+// sines and cosines of the Euler angles, straight from the matrix
+// without any trig calls
 void
-AP_DCM::euler_yaw(void)
+AP_DCM::update_trig(void)
 {
-	yaw 			= atan2(_dcm_matrix.b.x, _dcm_matrix.a.x);
-	yaw_sensor 		= degrees(yaw)   * 100;
+	float yaw_len;
 
-	if (yaw_sensor < 0)
-		yaw_sensor += 36000;
-}
+	_sin_pitch 		= -_dcm_matrix.c.x;
+	_cos_pitch 		= sqrt(1 - (_dcm_matrix.c.x * _dcm_matrix.c.x));
 
+	_cos_roll 		= _dcm_matrix.c.z / _cos_pitch;
+	_sin_roll 		= _dcm_matrix.c.y / _cos_pitch;
 
+	yaw_len 		= sqrt(_dcm_matrix.a.x * _dcm_matrix.a.x + _dcm_matrix.b.x * _dcm_matrix.b.x);
+	_cos_yaw 		= _dcm_matrix.a.x / yaw_len;
+	_sin_yaw 		= _dcm_matrix.b.x / yaw_len;
+	_stale &= ~STALE_TRIG;
+}
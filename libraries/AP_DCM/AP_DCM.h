@@ -35,15 +35,16 @@ public:
 		_ki_roll_pitch(0.00001278),
 		_kp_yaw(0.8), // .8
 		_ki_yaw(0.00004), // 0.00004
-		_toggle(0)
+		_toggle(0),
+		_stale(STALE_ALL)
 	{}
 
 	// Accessors
-	Vector3f	get_gyro(void) {return _omega_integ_corr; }		// We return the raw gyro vector corrected for bias
-	Vector3f	get_accel(void) { return _accel_vector; }
-	Matrix3f	get_dcm_matrix(void) {return _dcm_matrix; }
-	Matrix3f	get_dcm_transposed(void) {Matrix3f temp = _dcm_matrix;  return temp.transpose();}
-	Vector3f	get_integrator(void) {return _omega_I; }		// We return the current drift correction integrator values
+	const Vector3f	&get_gyro(void) const {return _omega_integ_corr; }		// We return the raw gyro vector corrected for bias
+	const Vector3f	&get_accel(void) const { return _accel_vector; }
+	const Matrix3f	&get_dcm_matrix(void) const {return _dcm_matrix; }
+	Matrix3f	get_dcm_transposed(void) const {return _dcm_matrix.transposed();}	// prefer get_dcm_matrix().mul_transpose(v)
+	const Vector3f	&get_integrator(void) const {return _omega_I; }		// We return the current drift correction integrator values
 	
 	float		get_health(void) {return _health;}
 	void		set_centripetal(bool b) {_centripetal = b;}
@@ -54,13 +55,30 @@ public:
 	void 		update_DCM(void);
 	void 		update_DCM_fast(void);
 
-	long		roll_sensor;					// Degrees * 100
-	long		pitch_sensor;					// Degrees * 100
-	long		yaw_sensor;						// Degrees * 100
-
-	float		roll;							// Radians
-	float		pitch;							// Radians
-	float		yaw;							// Radians
+	// Euler angles and their sines and cosines. These are worked out
+	// from the DCM matrix the first time they are asked for after each
+	// update, so a loop that only needs the matrix doesn't pay for the
+	// asin/atan2 calls. update_DCM_fast() instead refreshes the angles
+	// on their own ticks, as before, and reads in between get the last
+	// values.
+	long		roll_sensor(void)	{ if (_stale & STALE_EULER_RP) euler_rp(); return _roll_sensor; }	// Degrees * 100
+	long		pitch_sensor(void)	{ if (_stale & STALE_EULER_RP) euler_rp(); return _pitch_sensor; }	// Degrees * 100
+	long		yaw_sensor(void)	{ if (_stale & STALE_EULER_YAW) euler_yaw(); return _yaw_sensor; }	// Degrees * 100
+
+	float		roll(void)			{ if (_stale & STALE_EULER_RP) euler_rp(); return _roll; }		// Radians
+	float		pitch(void)			{ if (_stale & STALE_EULER_RP) euler_rp(); return _pitch; }		// Radians
+	float		yaw(void)			{ if (_stale & STALE_EULER_YAW) euler_yaw(); return _yaw; }		// Radians
+
+	float		cos_roll(void)		{ if (_stale & STALE_TRIG) update_trig(); return _cos_roll; }
+	float		sin_roll(void)		{ if (_stale & STALE_TRIG) update_trig(); return _sin_roll; }
+	float		cos_pitch(void)		{ if (_stale & STALE_TRIG) update_trig(); return _cos_pitch; }
+	float		sin_pitch(void)		{ if (_stale & STALE_TRIG) update_trig(); return _sin_pitch; }
+	float		cos_yaw(void)		{ if (_stale & STALE_TRIG) update_trig(); return _cos_yaw; }
+	float		sin_yaw(void)		{ if (_stale & STALE_TRIG) update_trig(); return _sin_yaw; }
+
+	// make roll and pitch read as level until they are next worked out,
+	// so a test can run the motors without the attitude getting in the way
+	void		zero_roll_pitch(void) { _roll = _pitch = 0; _roll_sensor = _pitch_sensor = 0; _stale &= ~STALE_EULER_RP; }
 
 	uint8_t 	gyro_sat_count;
 	uint8_t 	renorm_sqrt_count;
@@ -95,12 +113,11 @@ private:
 	float 		read_adc(int select);
 	void 		matrix_update(float _G_Dt);
 	void 		normalize(void);
-	Vector3f 	renorm(Vector3f const &a, int &problem);
+	void 		renorm(Vector3f &a, int &problem);
 	void 		drift_correction(void);
-	void 		euler_angles(void);
-
 	void 		euler_rp(void);
 	void 		euler_yaw(void);
+	void 		update_trig(void);
 
 
 	// members
@@ -128,6 +145,23 @@ private:
 	float		_health;
 	bool		_centripetal;
 	uint8_t		_toggle;
+
+	// which of the values derived from the matrix are out of date
+	enum {
+		STALE_EULER_RP	= 1,
+		STALE_EULER_YAW	= 2,
+		STALE_TRIG		= 4,
+		STALE_ALL		= 7
+	};
+	uint8_t		_stale;
+
+	float		_roll, _pitch, _yaw;			// Radians
+	long		_roll_sensor;					// Degrees * 100
+	long		_pitch_sensor;					// Degrees * 100
+	long		_yaw_sensor;					// Degrees * 100
+	float		_cos_roll, _sin_roll;
+	float		_cos_pitch, _sin_pitch;
+	float		_cos_yaw, _sin_yaw;
 };
 
 #endif
@@ -21,26 +21,32 @@
 
 /**************************************************/
 void
-AP_DCM_HIL::setHil(float _roll, float _pitch, float _yaw,
+AP_DCM_HIL::setHil(float roll, float pitch, float yaw,
 		float _rollRate, float _pitchRate, float _yawRate)
 {
-	roll = _roll;
-	pitch = _pitch;
-	yaw = _yaw;
+	_roll = roll;
+	_pitch = pitch;
+	_yaw = yaw;
 
 	_omega_integ_corr.x = _rollRate;
 	_omega_integ_corr.y = _pitchRate;
 	_omega_integ_corr.z = _yawRate;
 
-	roll_sensor =ToDeg(roll)*100;
-	pitch_sensor =ToDeg(pitch)*100;
-	yaw_sensor =ToDeg(yaw)*100;
+	_roll_sensor =ToDeg(_roll)*100;
+	_pitch_sensor =ToDeg(_pitch)*100;
+	_yaw_sensor =ToDeg(_yaw)*100;
 
 	// Need the standard C_body<-nav dcm from navigation frame to body frame
 	// Strapdown Inertial Navigation Technology / Titterton/ pg. 41
-	float sRoll = sin(roll), cRoll = cos(roll);
-	float sPitch = sin(pitch), cPitch = cos(pitch);
-	float sYaw = sin(yaw), cYaw = cos(yaw);
+	float sRoll = sin(_roll), cRoll = cos(_roll);
+	float sPitch = sin(_pitch), cPitch = cos(_pitch);
+	float sYaw = sin(_yaw), cYaw = cos(_yaw);
+	_sin_roll = sRoll;
+	_cos_roll = cRoll;
+	_sin_pitch = sPitch;
+	_cos_pitch = cPitch;
+	_sin_yaw = sYaw;
+	_cos_yaw = cYaw;
 	_dcm_matrix.a.x =  cPitch*cYaw;
 	_dcm_matrix.a.y =  -cRoll*sYaw+sRoll*sPitch*cYaw;
 	_dcm_matrix.a.z =  sRoll*sYaw+cRoll*sPitch*cYaw;
@@ -18,14 +18,17 @@ public:
 	AP_DCM_HIL() :
 		_dcm_matrix(1, 0, 0,
 					0, 1, 0,
-					0, 0, 1)
+					0, 0, 1),
+		_cos_roll(1),
+		_cos_pitch(1),
+		_cos_yaw(1)
 	{}
 
 	// Accessors
-	Vector3f	get_gyro(void) {return _omega_integ_corr; }
-	Vector3f	get_accel(void) { return _accel_vector; }
-	Matrix3f	get_dcm_matrix(void) {return _dcm_matrix; }
-	Matrix3f	get_dcm_transposed(void) {Matrix3f temp = _dcm_matrix;  return temp.transpose();}
+	const Vector3f	&get_gyro(void) const {return _omega_integ_corr; }
+	const Vector3f	&get_accel(void) const { return _accel_vector; }
+	const Matrix3f	&get_dcm_matrix(void) const {return _dcm_matrix; }
+	Matrix3f	get_dcm_transposed(void) const {return _dcm_matrix.transposed();}
 
 	void		set_centripetal(bool b) {}
 	void		set_compass(Compass *compass) {}
@@ -36,13 +39,24 @@ public:
 
 	float		get_health(void) { return 1.0; }
 
-	long		roll_sensor;					// Degrees * 100
-	long		pitch_sensor;					// Degrees * 100
-	long		yaw_sensor;						// Degrees * 100
+	// same accessors as AP_DCM, all worked out by setHil()
+	long		roll_sensor(void)	{ return _roll_sensor; }	// Degrees * 100
+	long		pitch_sensor(void)	{ return _pitch_sensor; }	// Degrees * 100
+	long		yaw_sensor(void)	{ return _yaw_sensor; }		// Degrees * 100
 
-	float		roll;							// Radians
-	float		pitch;							// Radians
-	float		yaw;							// Radians
+	float		roll(void)			{ return _roll; }			// Radians
+	float		pitch(void)			{ return _pitch; }			// Radians
+	float		yaw(void)			{ return _yaw; }			// Radians
+
+	float		cos_roll(void)		{ return _cos_roll; }
+	float		sin_roll(void)		{ return _sin_roll; }
+	float		cos_pitch(void)		{ return _cos_pitch; }
+	float		sin_pitch(void)		{ return _sin_pitch; }
+	float		cos_yaw(void)		{ return _cos_yaw; }
+	float		sin_yaw(void)		{ return _sin_yaw; }
+
+	// make roll and pitch read as level until the next setHil()
+	void		zero_roll_pitch(void) { _roll = _pitch = 0; _roll_sensor = _pitch_sensor = 0; }
 
 	uint8_t 	gyro_sat_count;
 	uint8_t 	renorm_sqrt_count;
@@ -69,6 +83,14 @@ private:
 	Matrix3f	_dcm_matrix;
 	Vector3f 	_omega_integ_corr;
 	Vector3f 	_accel_vector;
+
+	float		_roll, _pitch, _yaw;			// Radians
+	long		_roll_sensor;					// Degrees * 100
+	long		_pitch_sensor;					// Degrees * 100
+	long		_yaw_sensor;					// Degrees * 100
+	float		_cos_roll, _sin_roll;
+	float		_cos_pitch, _sin_pitch;
+	float		_cos_yaw, _sin_yaw;
 };
 
 #endif
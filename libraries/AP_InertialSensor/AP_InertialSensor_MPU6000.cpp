@@ -95,7 +95,8 @@ AP_InertialSensor_MPU6000::AP_InertialSensor_MPU6000( int cs_pin )
 void AP_InertialSensor_MPU6000::init( AP_PeriodicProcess * scheduler )
 {
     hardware_init();
-    scheduler->register_process( &AP_InertialSensor_MPU6000::read );
+    // sample every timer tick; 15 SPI bytes per read
+    scheduler->register_process( &AP_InertialSensor_MPU6000::read, 1, 100 );
 }
 
 // accumulation in ISR - must be read with interrupts disabled
@@ -5,3 +5,5 @@
 #include "vector2.h"
 #include "vector3.h"
 #include "matrix3.h"
+#include "fast_math.h"
+#include "local_frame.h"
@@ -0,0 +1,91 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+//
+// Cycle counts of the AP_Math fast_* functions against the libm calls
+// they replace, on the board. The accuracy sweep runs on the host, in
+// Tools/MathBench.
+//
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include <AP_Math.h>
+
+FastSerialPort0(Serial);
+
+#define CALLS	500
+
+// volatile so the compiler can't fold or drop the calls
+static volatile float	in_x[8];
+static volatile float	in_y[8];
+static volatile float	sink;
+
+enum fn {
+	FN_NONE, FN_SIN, FN_FAST_SIN, FN_COS, FN_FAST_COS, FN_ASIN, FN_FAST_ASIN,
+	FN_ATAN2, FN_FAST_ATAN2, FN_SQRT, FN_FAST_SQRT, FN_INVSQRT, FN_FAST_INVSQRT
+};
+
+// microseconds taken by CALLS calls of f
+static uint32_t time_calls(enum fn f)
+{
+	uint32_t start = micros();
+
+	for (uint16_t i=0; i<CALLS; i++) {
+		float x = in_x[i & 7];
+		float y = in_y[i & 7];
+		switch (f) {
+		case FN_NONE:			sink = x;					break;
+		case FN_SIN:			sink = sin(x);				break;
+		case FN_FAST_SIN:		sink = fast_sin(x);			break;
+		case FN_COS:			sink = cos(x);				break;
+		case FN_FAST_COS:		sink = fast_cos(x);			break;
+		case FN_ASIN:			sink = asin(x * 0.3);		break;
+		case FN_FAST_ASIN:		sink = fast_asin(x * 0.3);	break;
+		case FN_ATAN2:			sink = atan2(y, x);			break;
+		case FN_FAST_ATAN2:		sink = fast_atan2(y, x);	break;
+		case FN_SQRT:			sink = sqrt(y);				break;
+		case FN_FAST_SQRT:		sink = fast_sqrt(y);		break;
+		case FN_INVSQRT:		sink = 1 / sqrt(y);			break;
+		case FN_FAST_INVSQRT:	sink = fast_invsqrt(y);		break;
+		}
+	}
+	return micros() - start;
+}
+
+static void report(const char *name, enum fn f, uint32_t overhead)
+{
+	uint32_t t = time_calls(f);
+
+	t = t > overhead ? t - overhead : 0;
+	Serial.printf_P(PSTR("%-14s %6lu cycles\n"), name,
+					(unsigned long)(t * clockCyclesPerMicrosecond() / CALLS));
+}
+
+void setup(void)
+{
+	uint32_t overhead;
+
+	Serial.begin(115200);
+	Serial.println_P(PSTR("AP_Math fast_math test"));
+
+	for (uint8_t i=0; i<8; i++) {
+		in_x[i] = -3.0 + i * 0.8;
+		in_y[i] = 0.5 + i * 12.3;
+	}
+	overhead = time_calls(FN_NONE);
+
+	report("sin",			FN_SIN,				overhead);
+	report("fast_sin",		FN_FAST_SIN,		overhead);
+	report("cos",			FN_COS,				overhead);
+	report("fast_cos",		FN_FAST_COS,		overhead);
+	report("asin",			FN_ASIN,			overhead);
+	report("fast_asin",		FN_FAST_ASIN,		overhead);
+	report("atan2",			FN_ATAN2,			overhead);
+	report("fast_atan2",	FN_FAST_ATAN2,		overhead);
+	report("sqrt",			FN_SQRT,			overhead);
+	report("fast_sqrt",		FN_FAST_SQRT,		overhead);
+	report("1/sqrt",		FN_INVSQRT,			overhead);
+	report("fast_invsqrt",	FN_FAST_INVSQRT,	overhead);
+}
+
+void loop(void)
+{
+}
@@ -0,0 +1,181 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+//
+// Checks of the AP_Math LocalFrame against the great circle distance and
+// rhumb line bearing, worked out in double precision on a PC, for pairs
+// of locations near the origin and tens of kilometers from it; and of
+// the round trip from a location to north-east-down and back.
+//
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include <AP_Math.h>
+
+FastSerialPort0(Serial);
+
+// what local_frame.h promises, in meters: a few centimeters within
+// 20km of the origin, under a meter within 50km
+#define DIST_ERR_NEAR	0.05
+#define DIST_ERR_FAR	1.0
+// and fast_sqrt adds up to 5e-6 of the distance
+#define DIST_ERR_REL	1.0e-5
+// degrees * 100: rounding of the reference and truncation of bearing()
+#define BRG_ERR			2
+// meters: the resolution of a Location, 1e-7 degrees, is 1.1cm
+#define NED_ERR			0.012
+
+// Canberra, and 60 degrees north where longitude shrinks faster
+static const int32_t origin_lat[] = { -353632620, 600000000 };
+static const int32_t origin_lng[] = { 1491652370, 250000000 };
+
+static const struct pair {
+	uint8_t		origin;
+	int32_t		a_lat, a_lng;
+	int32_t		b_lat, b_lng;
+	float		distance;		// great circle, meters
+	int32_t		bearing;		// rhumb line, degrees * 100
+	uint8_t		far;			// more than 20km from the origin
+} pairs[] = {
+	{ 0, -353632620, 1491652370, -353626332, 1491660081, 98.994, 4500, 0 },		// 100m northeast
+	{ 0, -353632620, 1491652370, -353632889, 1491652811, 4.999, 12680, 0 },		// 5m southeast
+	{ 0, -353632620, 1491652370, -353632620, 1493855475, 19999.990, 9000, 0 },	// 20km east
+	{ 0, -353632620, 1491652370, -354903017, 1493210186, 19991.926, 13502, 0 },	// 20km southeast
+	{ 0, -354530935, 1491101594, -352913968, 1492643767, 22802.534, 3787, 0 },	// 23km across the origin
+	{ 0, -351835990, 1491652370, -351835990, 1491663386, 100.226, 9000, 0 },		// 100m east, 20km north
+	{ 0, -355339419, 1492203146, -355275908, 1492281026, 998.812, 4494, 0 },		// 1km northeast, 20km south
+	{ 0, -353632620, 1491652370, -350456627, 1487757830, 50048.521, 31494, 1 },	// 50km northwest
+	{ 0, -349141044, 1491652370, -349141044, 1491663386, 100.558, 9000, 1 },		// 100m east, 50km north
+	{ 1, 600000000, 250000000, 600006288, 250012576, 98.991, 4500, 0 },			// 100m northeast
+	{ 1, 600000000, 250000000, 599999731, 250000719, 4.998, 12681, 0 },			// 5m southeast
+	{ 1, 600000000, 250000000, 600000000, 253593261, 19999.975, 9000, 0 },		// 20km east
+	{ 1, 600000000, 250000000, 598729603, 252540795, 20018.983, 13495, 0 },		// 20km southeast
+	{ 1, 599101685, 249101685, 600718652, 251616967, 22805.802, 3788, 0 },		// 23km across the origin
+	{ 1, 601796630, 250000000, 601796630, 250017966, 99.455, 9000, 0 },			// 100m east, 20km north
+	{ 1, 598293201, 250898315, 598356712, 251025337, 1002.383, 4514, 0 },		// 1km northeast, 20km south
+	{ 1, 600000000, 250000000, 603175993, 243648013, 49879.134, 31514, 1 },		// 50km northwest
+	{ 1, 604491576, 250000000, 604491576, 250017966, 98.637, 9000, 1 },			// 100m east, 50km north
+};
+
+#define NUM_PAIRS	(sizeof(pairs) / sizeof(pairs[0]))
+
+static LocalFrame	frame;
+static uint8_t		failed;
+
+static void set_origin(uint8_t i)
+{
+	struct Location	origin;
+
+	origin.lat = origin_lat[i];
+	origin.lng = origin_lng[i];
+	origin.alt = 58400;
+	frame.set_origin(&origin);
+}
+
+// the difference between two bearings, 0 to 18000
+static int32_t bearing_error(int32_t a, int32_t b)
+{
+	int32_t		d = labs(a - b) % 36000;
+
+	return d > 18000 ? 36000 - d : d;
+}
+
+// offset(), distance() and bearing() against the reference, both ways
+static void test_pairs(void)
+{
+	float		max_near = 0, max_far = 0;
+	int32_t		max_brg = 0;
+
+	for (uint8_t i = 0; i < NUM_PAIRS; i++) {
+		const struct pair	*p = &pairs[i];
+		struct Location		a, b;
+		float				dist, err, limit;
+		int32_t				brg_err;
+		Vector2f			ab, ba;
+
+		set_origin(p->origin);
+		a.lat = p->a_lat;
+		a.lng = p->a_lng;
+		b.lat = p->b_lat;
+		b.lng = p->b_lng;
+
+		dist = frame.distance(&a, &b);
+		err = fabs(dist - p->distance);
+		limit = (p->far ? DIST_ERR_FAR : DIST_ERR_NEAR) + p->distance * DIST_ERR_REL;
+		brg_err = max(bearing_error(frame.bearing(&a, &b), p->bearing),
+					  bearing_error(frame.bearing(&b, &a), p->bearing + 18000));
+		ab = frame.offset(&a, &b);
+		ba = frame.offset(&b, &a);
+
+		if (err > limit || brg_err > BRG_ERR || ab.x != -ba.x || ab.y != -ba.y) {
+			Serial.printf_P(PSTR("pair %u: distance %.3f, want %.3f; bearing off by %ld\n"),
+							i, dist, p->distance, (long)brg_err);
+			failed++;
+		}
+		if (p->far) {
+			max_far = max(max_far, err);
+		} else {
+			max_near = max(max_near, err);
+		}
+		max_brg = max(max_brg, brg_err);
+	}
+	Serial.printf_P(PSTR("distance error: %.3fm within 20km, %.3fm within 50km\n"),
+					max_near, max_far);
+	Serial.printf_P(PSTR("bearing error: %ld cdeg\n"), (long)max_brg);
+}
+
+// location() and ned() undo each other, to the resolution of a Location
+static void test_round_trip(void)
+{
+	static const float	north[] = { -50000, -20000, -100, -3, 0, 7, 250, 20000, 50000 };
+	static const float	east[] = { -45000, -150, 0, 4, 18000, 50000 };
+	static const float	down[] = { -120.5, 0, 35 };
+	float				max_err = 0;
+
+	for (uint8_t o = 0; o < 2; o++) {
+		set_origin(o);
+		for (uint8_t i = 0; i < sizeof(north) / sizeof(north[0]); i++) {
+			for (uint8_t j = 0; j < sizeof(east) / sizeof(east[0]); j++) {
+				for (uint8_t k = 0; k < sizeof(down) / sizeof(down[0]); k++) {
+					Vector3f		want(north[i], east[j], down[k]);
+					Vector3f		got;
+					struct Location	loc, again;
+					float			err;
+
+					frame.location(want, &loc);
+					got = frame.ned(&loc);
+					frame.location(got, &again);
+					err = max(max(fabs(got.x - want.x), fabs(got.y - want.y)),
+							  fabs(got.z - want.z));
+					max_err = max(max_err, err);
+					if (err > NED_ERR ||
+						labs(again.lat - loc.lat) > 1 ||
+						labs(again.lng - loc.lng) > 1 ||
+						labs(again.alt - loc.alt) > 1) {
+						Serial.printf_P(PSTR("round trip %.1f,%.1f,%.1f: got %.3f,%.3f,%.3f\n"),
+										want.x, want.y, want.z, got.x, got.y, got.z);
+						failed++;
+					}
+				}
+			}
+		}
+	}
+	Serial.printf_P(PSTR("round trip error: %.4fm\n"), max_err);
+}
+
+void setup(void)
+{
+	Serial.begin(115200);
+	Serial.println_P(PSTR("AP_Math LocalFrame test"));
+
+	test_pairs();
+	test_round_trip();
+
+	if (failed) {
+		Serial.printf_P(PSTR("FAIL: %u\n"), failed);
+	} else {
+		Serial.println_P(PSTR("PASS"));
+	}
+}
+
+void loop(void)
+{
+}
@@ -0,0 +1,143 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	fast_math.cpp
+/// @brief	Bounded-error replacements for the libm trig and square root
+///			functions. See fast_math.h for the error bounds.
+
+#include "fast_math.h"
+
+#define FM_PI			3.14159265358979f
+#define FM_HALF_PI		1.57079632679490f
+#define FM_INV_TWO_PI	0.159154943091895f
+
+// 2 pi split in two, so that x - k * 2 pi keeps its precision for
+// small k. The first part has few enough bits that k * FM_TWO_PI_HI
+// is exact.
+#define FM_TWO_PI_HI	6.28125f
+#define FM_TWO_PI_LO	0.00193530717958648f
+
+// sin(x) on [-pi/2, pi/2], minimax, 1.5e-6 max error
+#define SIN_C1			 0.9999996185f
+#define SIN_C3			-0.1666584690f
+#define SIN_C5			 0.008313958682f
+#define SIN_C7			-0.0001852322017f
+
+// atan(x) on [-1, 1], minimax, 1.7e-6 max error
+#define ATAN_C1			 0.9999772191f
+#define ATAN_C3			-0.3326228279f
+#define ATAN_C5			 0.1935403761f
+#define ATAN_C7			-0.1164264820f
+#define ATAN_C9			 0.05264735147f
+#define ATAN_C11		-0.01171913573f
+
+// x brought into [-pi, pi]
+static float
+wrap_pi(float x)
+{
+	float	n = x * FM_INV_TWO_PI;
+	int32_t	k = (int32_t)(n >= 0 ? n + 0.5f : n - 0.5f);
+
+	return (x - k * FM_TWO_PI_HI) - k * FM_TWO_PI_LO;
+}
+
+// sin(x) for x in [-pi, pi]
+static float
+sin_pi(float x)
+{
+	// fold into [-pi/2, pi/2], using sin(x) = sin(pi - x)
+	if (x > FM_HALF_PI) {
+		x = FM_PI - x;
+	} else if (x < -FM_HALF_PI) {
+		x = -FM_PI - x;
+	}
+
+	float	x2 = x * x;
+	return x * (SIN_C1 + x2 * (SIN_C3 + x2 * (SIN_C5 + x2 * SIN_C7)));
+}
+
+float
+fast_sin(float x)
+{
+	return sin_pi(wrap_pi(x));
+}
+
+float
+fast_cos(float x)
+{
+	// shift after wrapping, so the shift doesn't cost precision for
+	// large x
+	x = wrap_pi(x) + FM_HALF_PI;
+	if (x > FM_PI) {
+		x -= 2 * FM_PI;
+	}
+	return sin_pi(x);
+}
+
+// atan(t) for t in [0, 1]
+static float
+atan_unit(float t)
+{
+	float	t2 = t * t;
+	return t * (ATAN_C1 + t2 * (ATAN_C3 + t2 * (ATAN_C5 +
+				t2 * (ATAN_C7 + t2 * (ATAN_C9 + t2 * ATAN_C11)))));
+}
+
+float
+fast_atan2(float y, float x)
+{
+	float	ax = x < 0 ? -x : x;
+	float	ay = y < 0 ? -y : y;
+	float	a;
+
+	if (ax == 0 && ay == 0) {
+		return 0;
+	}
+
+	// fold into the first octant so the polynomial only sees [0, 1]
+	if (ay <= ax) {
+		a = atan_unit(ay / ax);
+	} else {
+		a = FM_HALF_PI - atan_unit(ax / ay);
+	}
+	if (x < 0) {
+		a = FM_PI - a;
+	}
+	return y < 0 ? -a : a;
+}
+
+float
+fast_asin(float x)
+{
+	if (x > 1) {
+		x = 1;
+	} else if (x < -1) {
+		x = -1;
+	}
+	return fast_atan2(x, fast_sqrt(1 - x * x));
+}
+
+float
+fast_invsqrt(float x)
+{
+	union {
+		float		f;
+		uint32_t	i;
+	} u;
+	float	half_x = 0.5f * x;
+
+	// first guess from the float's exponent, then two Newton steps
+	u.f = x;
+	u.i = 0x5f375a86UL - (u.i >> 1);
+	u.f = u.f * (1.5f - half_x * u.f * u.f);
+	u.f = u.f * (1.5f - half_x * u.f * u.f);
+	return u.f;
+}
+
+float
+fast_sqrt(float x)
+{
+	if (x <= 0) {
+		return 0;
+	}
+	return x * fast_invsqrt(x);
+}
@@ -0,0 +1,35 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	fast_math.h
+/// @brief	Bounded-error replacements for the libm trig and square root
+///			functions, for use in the flight code on the AVR.
+///
+/// Each function uses a minimax polynomial or a Newton step instead of
+/// the full precision libm routine. The error bounds below are absolute
+/// (in radians) unless noted, and are what Tools/MathBench measures
+/// against double precision libm over the whole domain:
+///
+///		fast_sin, fast_cos		1.7e-6		for |x| <= 10000
+///		fast_atan2				2.0e-6		any y, x; fast_atan2(0, 0) is 0
+///		fast_asin				4.0e-6		x is clamped to [-1, 1]
+///		fast_invsqrt			5e-6 relative, for x > 0
+///		fast_sqrt				5e-6 relative; returns 0 for x <= 0
+///
+/// That is well below the resolution of anything the flight code does
+/// with the results (centi-degree angles, centimetre distances), but
+/// the functions are not a drop-in replacement where full float
+/// precision is needed.
+
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <stdint.h>
+
+float	fast_sin(float x);
+float	fast_cos(float x);
+float	fast_atan2(float y, float x);
+float	fast_asin(float x);
+float	fast_invsqrt(float x);
+float	fast_sqrt(float x);
+
+#endif
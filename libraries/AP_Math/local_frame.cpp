@@ -0,0 +1,78 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	local_frame.cpp
+/// @brief	A local north-east-down frame anchored at a Location. See
+///			local_frame.h.
+
+#include <math.h>
+#include <AP_Common.h>
+#include "local_frame.h"
+#include "fast_math.h"
+
+// meters per unit of latitude (degrees * 10^7)
+#define LF_LAT_SCALE	0.01113195f
+
+// degrees * 100 per radian
+#define LF_CDEG_PER_RAD	5729.57795f
+
+LocalFrame::LocalFrame() :
+	_lat(0),
+	_lng(0),
+	_alt(0),
+	_lng_scale(1),
+	_lng_slope(0)
+{
+}
+
+void
+LocalFrame::set_origin(const struct Location *origin)
+{
+	_lat = origin->lat;
+	_lng = origin->lng;
+	_alt = origin->alt;
+	_lng_scale = cos(_lat * (1.0e-7 * M_PI / 180));
+	_lng_slope = -0.5 * sin(_lat * (1.0e-7 * M_PI / 180)) * (1.0e-7 * M_PI / 180);
+}
+
+Vector3f
+LocalFrame::ned(const struct Location *loc) const
+{
+	return Vector3f((loc->lat - _lat) * LF_LAT_SCALE,
+					(loc->lng - _lng) * LF_LAT_SCALE * _lng_scale_mid(loc->lat - _lat),
+					(_alt - loc->alt) * 0.01f);
+}
+
+Vector2f
+LocalFrame::offset(const struct Location *a, const struct Location *b) const
+{
+	return Vector2f((b->lat - a->lat) * LF_LAT_SCALE,
+					(b->lng - a->lng) * LF_LAT_SCALE *
+					_lng_scale_mid((a->lat - _lat) + (b->lat - _lat)));
+}
+
+float
+LocalFrame::distance(const struct Location *a, const struct Location *b) const
+{
+	Vector2f	d = offset(a, b);
+
+	return fast_sqrt(d.x * d.x + d.y * d.y);
+}
+
+int32_t
+LocalFrame::bearing(const struct Location *a, const struct Location *b) const
+{
+	Vector2f	d = offset(a, b);
+	int32_t		bearing = fast_atan2(d.y, d.x) * LF_CDEG_PER_RAD;
+
+	if (bearing < 0)
+		bearing += 36000;
+	return bearing;
+}
+
+void
+LocalFrame::location(const Vector3f &ned, struct Location *loc) const
+{
+	loc->lat = _lat + (int32_t)(ned.x / LF_LAT_SCALE);
+	loc->lng = _lng + (int32_t)(ned.y / (LF_LAT_SCALE * _lng_scale_mid(loc->lat - _lat)));
+	loc->alt = _alt - (int32_t)(ned.z * 100);
+}
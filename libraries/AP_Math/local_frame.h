@@ -0,0 +1,74 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: t -*-
+
+/// @file	local_frame.h
+/// @brief	A local north-east-down frame anchored at a Location, usually
+///			home, so that navigation can be done in meters.
+///
+/// Locations hold latitude and longitude in degrees * 10^7 and altitude
+/// in centimeters. Offsets are taken between those integers first and
+/// only then scaled to meters, so they keep their resolution however
+/// far from the origin the two points are. Longitude is scaled by the
+/// cosine of the latitude half way between the two points, taken from
+/// a straight line fitted to the cosine at the origin in set_origin(),
+/// so no call needs any trig.
+///
+/// Distances are good to a few centimeters within 20 kilometers of the
+/// origin, and to under a meter within 50; libraries/AP_Math/examples/
+/// local_frame_test checks this. Bearings are those of the rhumb line.
+/// The frame does not handle the 180 degree meridian.
+
+#ifndef LOCAL_FRAME_H
+#define LOCAL_FRAME_H
+
+#include <stdint.h>
+#include "vector2.h"
+#include "vector3.h"
+
+struct Location;
+
+class LocalFrame
+{
+public:
+	/// A frame at latitude and longitude zero until set_origin() is
+	/// called, which scales longitude the same as latitude.
+	LocalFrame();
+
+	/// Anchor the frame at origin.
+	void		set_origin(const struct Location *origin);
+
+	/// How much shorter a unit of longitude is than one of latitude
+	/// at the origin; the cosine of its latitude.
+	float		lng_scale(void) const { return _lng_scale; }
+
+	/// The position of loc relative to the origin, in meters north,
+	/// east and down.
+	Vector3f	ned(const struct Location *loc) const;
+
+	/// The horizontal offset from a to b, in meters north (x) and
+	/// east (y).
+	Vector2f	offset(const struct Location *a, const struct Location *b) const;
+
+	/// The horizontal distance from a to b, in meters.
+	float		distance(const struct Location *a, const struct Location *b) const;
+
+	/// The bearing from a to b, in degrees * 100 clockwise from north,
+	/// 0 to 36000.
+	int32_t		bearing(const struct Location *a, const struct Location *b) const;
+
+	/// Set the latitude, longitude and altitude of loc to the point
+	/// ned meters from the origin. The rest of loc is left alone.
+	void		location(const Vector3f &ned, struct Location *loc) const;
+
+private:
+	int32_t		_lat;
+	int32_t		_lng;
+	int32_t		_alt;
+	float		_lng_scale;
+	float		_lng_slope;		///< change of _lng_scale per unit of latitude, halved
+
+	/// The longitude scale half way between the origin and a point
+	/// dlat units of latitude north of it.
+	float		_lng_scale_mid(int32_t dlat) const { return _lng_scale + _lng_slope * dlat; }
+};
+
+#endif
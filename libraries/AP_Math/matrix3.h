@@ -71,23 +71,23 @@ public:
 	Matrix3<T> operator + (const Matrix3<T> &m) const
 	{   return Matrix3<T>(a+m.a, b+m.b, c+m.c);	 }
 	Matrix3<T> &operator += (const Matrix3<T> &m)
-	{	return *this = *this + m;	}
+	{	a += m.a; b += m.b; c += m.c; return *this;	}
 
 	// subtraction
 	Matrix3<T> operator - (const Matrix3<T> &m) const
 	{   return Matrix3<T>(a-m.a, b-m.b, c-m.c);	 }
 	Matrix3<T> &operator -= (const Matrix3<T> &m)
-	{	return *this = *this - m;	}
+	{	a -= m.a; b -= m.b; c -= m.c; return *this;	}
 
 	// uniform scaling
 	Matrix3<T> operator * (const T num) const
 	{	return Matrix3<T>(a*num, b*num, c*num);	}
 	Matrix3<T> &operator *= (const T num)
-	{	return *this = *this * num;	}
+	{	a *= num; b *= num; c *= num; return *this;	}
 	 Matrix3<T> operator / (const T num) const
 	{	return Matrix3<T>(a/num, b/num, c/num);	}
 	Matrix3<T> &operator /= (const T num)
-	{	return *this = *this / num;	}
+	{	a /= num; b /= num; c /= num; return *this;	}
 
 	// multiplication by a vector
 	Vector3<T> operator *(const Vector3<T> &v) const
@@ -114,6 +114,26 @@ public:
 	Matrix3<T> &operator *=(const Matrix3<T> &m)
 	{	return *this = *this * m;	}
 
+	// multiplication of the transpose by a vector, without forming
+	// the transpose
+	Vector3<T> mul_transpose(const Vector3<T> &v) const
+	{
+		return Vector3<T>(a.x * v.x + b.x * v.y + c.x * v.z,
+						  a.y * v.x + b.y * v.y + c.y * v.z,
+						  a.z * v.x + b.z * v.y + c.z * v.z);
+	}
+
+	// apply an additive rotation update in place, i.e.
+	//     *this += *this * skew(g)
+	// where skew(g) is the cross product matrix of the small rotation g.
+	// Each row r becomes r + r % g, so no temporary matrix is needed.
+	void rotate(const Vector3<T> &g)
+	{
+		rotate_row(a, g);
+		rotate_row(b, g);
+		rotate_row(c, g);
+	}
+
 	// transpose the matrix
 	Matrix3<T> transposed(void) const
 	{
@@ -121,9 +141,22 @@ public:
 						  Vector3<T>(a.y, b.y, c.y),
 						  Vector3<T>(a.z, b.z, c.z));
 	}
-	Matrix3<T> transpose(void)
-	{	return *this = transposed();	}
+	void transpose(void)
+	{
+		T t;
+		t = a.y; a.y = b.x; b.x = t;
+		t = a.z; a.z = c.x; c.x = t;
+		t = b.z; b.z = c.y; c.y = t;
+	}
 
+private:
+	static void rotate_row(Vector3<T> &r, const Vector3<T> &g)
+	{
+		T x = r.y * g.z - r.z * g.y;
+		T y = r.z * g.x - r.x * g.z;
+		T z = r.x * g.y - r.y * g.x;
+		r.x += x; r.y += y; r.z += z;
+	}
 };
 
 typedef Matrix3<int>			Matrix3i;
@@ -60,12 +60,12 @@ void AP_Mount::set_mavlink_angles(int roll, int pitch, int yaw)
 void AP_Mount::set_GPS_target_location(Location targetGPSLocation)
 {
 	_target_GPS_location=targetGPSLocation;
+	_target_frame.set_origin(&_target_GPS_location);
 }
 
 // This one should be called periodically
 void AP_Mount::update_mount_position()
 {
-	Matrix3f m;					//holds 3 x 3 matrix, var is used as temp in calcs
 	Vector3f targ;				//holds target vector, var is used as temp in calcs
 	Vector3f aux_vec;			//holds target vector, var is used as temp in calcs
 
@@ -88,13 +88,12 @@ void AP_Mount::update_mount_position()
 		aux_vec.x = _mavlink_angles.x;
 		aux_vec.y = _mavlink_angles.y;
 		aux_vec.z = _mavlink_angles.z;
-		m = _dcm?_dcm->get_dcm_transposed():_dcm_hil->get_dcm_transposed();
-		//rotate vector
-		targ = m*aux_vec;
+		//rotate vector by the transposed dcm matrix
+		targ = _dcm?_dcm->get_dcm_matrix().mul_transpose(aux_vec):_dcm_hil->get_dcm_matrix().mul_transpose(aux_vec);
 		// TODO The next three lines are probably not correct yet
-		roll_angle  = _stab_roll? degrees(atan2( targ.y,targ.z))*100:_mavlink_angles.y;	//roll
-		pitch_angle = _stab_pitch?degrees(atan2(-targ.x,targ.z))*100:_neutral_angles.x;	//pitch
-		yaw_angle   = _stab_yaw?  degrees(atan2(-targ.x,targ.y))*100:_neutral_angles.z;	//yaw
+		roll_angle  = _stab_roll? degrees(fast_atan2( targ.y,targ.z))*100:_mavlink_angles.y;	//roll
+		pitch_angle = _stab_pitch?degrees(fast_atan2(-targ.x,targ.z))*100:_neutral_angles.x;	//pitch
+		yaw_angle   = _stab_yaw?  degrees(fast_atan2(-targ.x,targ.y))*100:_neutral_angles.z;	//yaw
 		break;
 	}
 
@@ -103,15 +102,15 @@ void AP_Mount::update_mount_position()
 		// TODO It does work, but maybe is a good idea to replace this simplified implementation with a proper one
 		if (_dcm)
 		{
-			roll_angle  = -_dcm->roll_sensor;
-			pitch_angle = -_dcm->pitch_sensor;
-			yaw_angle   = -_dcm->yaw_sensor;
+			roll_angle  = -_dcm->roll_sensor();
+			pitch_angle = -_dcm->pitch_sensor();
+			yaw_angle   = -_dcm->yaw_sensor();
 		}
 		if (_dcm_hil)
 		{
-			roll_angle  = -_dcm_hil->roll_sensor;
-			pitch_angle = -_dcm_hil->pitch_sensor;
-			yaw_angle   = -_dcm_hil->yaw_sensor;
+			roll_angle  = -_dcm_hil->roll_sensor();
+			pitch_angle = -_dcm_hil->pitch_sensor();
+			yaw_angle   = -_dcm_hil->yaw_sensor();
 		}
 		if (g_rc_function[RC_Channel_aux::k_mount_roll])
 			roll_angle  = rc_map(g_rc_function[RC_Channel_aux::k_mount_roll]);
@@ -128,15 +127,14 @@ void AP_Mount::update_mount_position()
 		{
 			calc_GPS_target_vector(&_target_GPS_location);
 		}
-		m = (_dcm)?_dcm->get_dcm_transposed():_dcm_hil->get_dcm_transposed();
-		targ = m*_GPS_vector;
+		targ = (_dcm)?_dcm->get_dcm_matrix().mul_transpose(_GPS_vector):_dcm_hil->get_dcm_matrix().mul_transpose(_GPS_vector);
 		/* disable stabilization for now, this will help debug */
 		_stab_roll = 0;_stab_pitch=0;_stab_yaw=0;
 		/**/
 		// TODO The next three lines are probably not correct yet
-		roll_angle  = _stab_roll? degrees(atan2( targ.y,targ.z))*100:_GPS_vector.y;	//roll
-		pitch_angle = _stab_pitch?degrees(atan2(-targ.x,targ.z))*100:0;	//pitch
-		yaw_angle   = _stab_yaw?  degrees(atan2(-targ.x,targ.y))*100:degrees(atan2(-_GPS_vector.x,_GPS_vector.y))*100;	//yaw
+		roll_angle  = _stab_roll? degrees(fast_atan2( targ.y,targ.z))*100:_GPS_vector.y;	//roll
+		pitch_angle = _stab_pitch?degrees(fast_atan2(-targ.x,targ.z))*100:0;	//pitch
+		yaw_angle   = _stab_yaw?  degrees(fast_atan2(-targ.x,targ.y))*100:degrees(fast_atan2(-_GPS_vector.x,_GPS_vector.y))*100;	//yaw
 		break;
 	}
 	default:
@@ -264,9 +262,16 @@ void AP_Mount::control_cmd()
 
 void AP_Mount::calc_GPS_target_vector(struct Location *target)
 {
-	_GPS_vector.x = (target->lng-_gps->longitude) * cos((_gps->latitude+target->lat)/2)*.01113195;
-	_GPS_vector.y = (target->lat-_gps->latitude)*.01113195;
-	_GPS_vector.z = (_gps->altitude-target->alt);
+	struct Location here;
+	here.lat = _gps->latitude;
+	here.lng = _gps->longitude;
+	here.alt = _gps->altitude;
+
+	// the longitude scale of the target was worked out when it was set
+	Vector2f to_target = _target_frame.offset(&here, target);
+	_GPS_vector.x = to_target.y;	// east
+	_GPS_vector.y = to_target.x;	// north
+	_GPS_vector.z = (here.alt - target->alt) * 0.01;	// height above the target
 }
 
 void
@@ -87,6 +87,7 @@ private:
 	MountType _mount_type;
 
 	struct Location _target_GPS_location;
+	LocalFrame _target_frame;		///< meters from _target_GPS_location
 	
 	Vector3i _retract_angles;		///< retracted position for mount, vector.x = roll vector.y = pitch, vector.z=yaw
 	Vector3i _neutral_angles;		///< neutral position for mount, vector.x = roll vector.y = pitch, vector.z=yaw
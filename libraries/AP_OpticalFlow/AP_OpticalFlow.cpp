@@ -111,7 +111,7 @@ AP_OpticalFlow::update_position(float roll, float pitch, float cos_yaw_x, float
 /*
 {
 	// only update position if surface quality is good and angle is not over 45 degrees
-	if( surface_quality >= 10 && fabs(_dcm->roll) <= FORTYFIVE_DEGREES && fabs(_dcm->pitch) <= FORTYFIVE_DEGREES ) {
+	if( surface_quality >= 10 && fabs(_dcm->roll()) <= FORTYFIVE_DEGREES && fabs(_dcm->pitch()) <= FORTYFIVE_DEGREES ) {
 		altitude = max(altitude, 0);
 		Vector3f omega = _dcm->get_gyro();
 
@@ -12,6 +12,7 @@ class AP_PeriodicProcessStub : public AP_PeriodicProcess
         AP_PeriodicProcessStub(int period = 0);
         void init( Arduino_Mega_ISR_Registry * isr_reg );
         void register_process(void (* proc)(void));
+        void register_process(void (* proc)(void), uint8_t rate_divider, uint16_t max_time_micros);
         static void run(void);
     protected:
         static int  _period;
@@ -8,12 +8,17 @@ extern "C" {
 }
 
 int AP_TimerProcess::_period;
-void (*AP_TimerProcess::_proc)(void);
+uint8_t AP_TimerProcess::_num_procs;
+void (*AP_TimerProcess::_proc[AP_TIMERPROCESS_MAX_PROCS])(void);
+uint8_t AP_TimerProcess::_rate_divider[AP_TIMERPROCESS_MAX_PROCS];
+uint8_t AP_TimerProcess::_countdown[AP_TIMERPROCESS_MAX_PROCS];
+uint16_t AP_TimerProcess::_max_time_micros[AP_TIMERPROCESS_MAX_PROCS];
+uint16_t AP_TimerProcess::_overruns;
+uint8_t AP_TimerProcess::_resume;
 
 AP_TimerProcess::AP_TimerProcess(int period)
 {
     _period = period;
-    _proc = NULL;
 }
 
 void AP_TimerProcess::init( Arduino_Mega_ISR_Registry * isr_reg )
@@ -31,13 +36,81 @@ void AP_TimerProcess::init( Arduino_Mega_ISR_Registry * isr_reg )
 
 void AP_TimerProcess::register_process(void (*proc)(void) )
 {
-    _proc = proc;
+    register_process(proc, 1, 0);
+}
+
+void AP_TimerProcess::register_process(void (*proc)(void), uint8_t rate_divider, uint16_t max_time_micros)
+{
+    uint8_t i;
+
+    if (rate_divider == 0) {
+        rate_divider = 1;
+    }
+
+    // a driver that is initialised again (e.g. an IMU warm start)
+    // just gets its rate and budget updated
+    for (i = 0; i < _num_procs; i++) {
+        if (_proc[i] == proc) {
+            break;
+        }
+    }
+    if (i == AP_TIMERPROCESS_MAX_PROCS) {
+        return;
+    }
+
+    // fill the slot in before it is made visible to the ISR
+    _proc[i]            = proc;
+    _rate_divider[i]    = rate_divider;
+    _countdown[i]       = 0;
+    _max_time_micros[i] = max_time_micros;
+    if (i == _num_procs) {
+        _num_procs++;
+    }
     TCNT2 = 1;                 // Should go off almost immediately.
 }
 
 void AP_TimerProcess::run(void)
 {
     TCNT2 = _period;
-    if (_proc != NULL)
-        _proc();
+    run_processes();
+}
+
+/*
+  run every process that is due on this tick, in the order they were
+  registered. When a process runs over its budget the remaining due
+  processes are left due, and the next tick starts with the process
+  after the one that overran and wraps around, so a process that
+  keeps overrunning can't starve the ones registered after it.
+ */
+void AP_TimerProcess::run_processes(void)
+{
+    bool out_of_time = false;
+    uint8_t i = _resume;
+
+    _resume = 0;
+    for (uint8_t n = 0; n < _num_procs; n++, i++) {
+        if (i >= _num_procs) {
+            i = 0;
+        }
+        if (_countdown[i] != 0) {
+            _countdown[i]--;
+            continue;
+        }
+        if (out_of_time) {
+            continue;
+        }
+        _countdown[i] = _rate_divider[i] - 1;
+
+        if (_max_time_micros[i] == 0) {
+            _proc[i]();
+        } else {
+            uint32_t start = micros();
+            _proc[i]();
+            if (micros() - start > _max_time_micros[i]) {
+                _overruns++;
+                out_of_time = true;
+                _resume = i + 1;
+            }
+        }
+    }
 }
@@ -2,22 +2,40 @@
 #ifndef __AP_TIMERPROCESS_H__
 #define __AP_TIMERPROCESS_H__
 
+#include <stdint.h>
+
 #include "PeriodicProcess.h"
 #include "../Arduino_Mega_ISR_Registry/Arduino_Mega_ISR_Registry.h"
 
 /* XXX this value is a total guess, will look up. */
 #define TIMERPROCESS_PER_DEFAULT (256)
 
+/* maximum number of processes that can be chained on the timer */
+#define AP_TIMERPROCESS_MAX_PROCS 5
+
 class AP_TimerProcess : public AP_PeriodicProcess
 {
     public:
         AP_TimerProcess(int period = TIMERPROCESS_PER_DEFAULT);
         void init( Arduino_Mega_ISR_Registry * isr_reg );
         void register_process(void (* proc)(void));
+        void register_process(void (* proc)(void), uint8_t rate_divider, uint16_t max_time_micros);
         static void run(void);
+
+        /* number of times a process has run over its time budget */
+        static uint16_t overruns(void) { return _overruns; }
+
     protected:
+        static void run_processes(void);
+
         static int  _period;
-        static void (*_proc)(void);
+        static uint8_t _num_procs;
+        static void (*_proc[AP_TIMERPROCESS_MAX_PROCS])(void);
+        static uint8_t _rate_divider[AP_TIMERPROCESS_MAX_PROCS];
+        static uint8_t _countdown[AP_TIMERPROCESS_MAX_PROCS];
+        static uint16_t _max_time_micros[AP_TIMERPROCESS_MAX_PROCS];
+        static uint16_t _overruns;
+        static uint8_t _resume;    /* where the next tick starts */
 };
 
 #endif // __AP_TIMERPROCESS_H__
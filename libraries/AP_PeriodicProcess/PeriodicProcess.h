@@ -2,10 +2,24 @@
 #ifndef __PERIODICPROCESS_H__
 #define __PERIODICPROCESS_H__
 
+#include <stdint.h>
+
 class AP_PeriodicProcess
 {
     public:
         virtual void register_process(void (* proc)(void)) = 0;
+
+        /* register a process to run every rate_divider ticks of the
+         * scheduler. max_time_micros is the time the process is
+         * expected to take; if it runs over, the rest of the processes
+         * that were due are put off until the next tick. Zero means the
+         * process has no budget. Schedulers that can only run a single
+         * process every tick ignore the extra arguments. */
+        virtual void register_process(void (* proc)(void),
+                                      uint8_t /* rate_divider */,
+                                      uint16_t /* max_time_micros */) {
+            register_process(proc);
+        }
 };
 
 #endif // __PERIODICPROCESS_H__
@@ -0,0 +1,108 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+//
+// This is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 2.1 of the License, or (at
+// your option) any later version.
+//
+
+/// @file   AP_Scheduler.cpp
+/// @brief  Table driven cooperative task scheduler.
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include "AP_Scheduler.h"
+
+#include <string.h>
+
+AP_Scheduler::AP_Scheduler() :
+    _tasks(NULL),
+    _num_tasks(0),
+    _tick_counter(0),
+    _state(NULL)
+{
+}
+
+void AP_Scheduler::init(const Task *tasks, Task_State *state, uint8_t num_tasks)
+{
+    _tasks = tasks;
+    _state = state;
+    _num_tasks = num_tasks;
+    _tick_counter = 0;
+    memset(_state, 0, num_tasks * sizeof(_state[0]));
+}
+
+void AP_Scheduler::run(uint16_t time_available)
+{
+    // the tasks put off on the last tick go first
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        if (_state[i].deferred) {
+            _run_task(i, time_available);
+        }
+    }
+
+    // then the rest, in table order. A deferred task that just ran
+    // isn't due again until its next interval
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        if (!_state[i].deferred) {
+            _run_task(i, time_available);
+        }
+    }
+}
+
+void AP_Scheduler::_run_task(uint8_t i, uint16_t &time_available)
+{
+    Task        task;
+    uint16_t    dt;
+    uint32_t    start, time_taken;
+
+    dt = _tick_counter - _state[i].last_run;
+
+    // the table lives in program memory
+    memcpy_P(&task, (const prog_char_t *)&_tasks[i], sizeof(task));
+
+    if (dt < task.interval_ticks) {
+        // not due yet
+        return;
+    }
+    if (task.max_time_micros > time_available &&
+        dt < 2 * task.interval_ticks) {
+        // won't fit in what is left of this tick, go first next tick
+        _state[i].deferred = true;
+        return;
+    }
+
+    start = micros();
+    task.function();
+    time_taken = micros() - start;
+
+    // the next run is due an interval after this one was, so running
+    // late doesn't slow the task down. A task more than an interval
+    // behind drops the runs it missed rather than running back to back
+    _state[i].deferred = false;
+    if (dt < 2 * task.interval_ticks) {
+        _state[i].last_run += task.interval_ticks;
+    } else {
+        _state[i].last_run = _tick_counter - dt % task.interval_ticks;
+    }
+
+    if (time_taken > task.max_time_micros) {
+        _state[i].overruns++;
+    }
+    if (time_taken >= time_available) {
+        // out of time, only starving tasks can run now
+        time_available = 0;
+    } else {
+        time_available -= time_taken;
+    }
+}
+
+uint16_t AP_Scheduler::total_overruns(void) const
+{
+    uint16_t total = 0;
+
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        total += _state[i].overruns;
+    }
+    return total;
+}
@@ -0,0 +1,119 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+//
+// This is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 2.1 of the License, or (at
+// your option) any later version.
+//
+
+/// @file   AP_Scheduler.h
+/// @brief  Table driven cooperative task scheduler.
+///
+/// The main loop runs its time critical work (the fast loop) once per
+/// tick, then calls ::tick and hands the scheduler whatever is left of
+/// the tick's time slot.  The scheduler runs the tasks that are due, in
+/// table order, skipping any whose worst case time doesn't fit in the
+/// time that remains.  A skipped task stays due and goes first on the
+/// next tick, so lower rate work spreads itself over the slack in
+/// successive ticks instead of piling into a single slot.  A task keeps
+/// to its own rate: the next run is due an interval after the last one
+/// was due, not after it ran.
+
+#ifndef AP_Scheduler_h
+#define AP_Scheduler_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+class AP_Scheduler
+{
+public:
+    typedef void (*task_fn_t)(void);
+
+    /// One entry in the task table.  Tables are expected to be in
+    /// program memory.
+    ///
+    struct Task {
+        task_fn_t   function;           ///< function to call
+        uint16_t    interval_ticks;     ///< run at most every this many ticks
+        uint16_t    max_time_micros;    ///< worst case run time
+    };
+
+    /// What the scheduler keeps for each task.  The caller provides an
+    /// array of these the size of the task table.
+    ///
+    struct Task_State {
+        uint16_t    last_run;           ///< the tick the last run was due on
+        uint16_t    overruns;           ///< number of overruns
+        bool        deferred;           ///< put off for want of time
+    };
+
+    /// Constructor
+    ///
+    AP_Scheduler();
+
+    /// Set the task table.
+    ///
+    /// @param  tasks           The task table, in program memory, highest
+    ///                         priority first.
+    /// @param  state           An array with an entry for each task.
+    ///
+    template <size_t N>
+    void init(const Task (&tasks)[N], Task_State (&state)[N]) {
+        init(&tasks[0], &state[0], N);
+    }
+
+    /// Set the task table, for when the arrays' sizes aren't known here.
+    ///
+    /// @param  num_tasks       Number of entries in tasks and state.
+    ///
+    void init(const Task *tasks, Task_State *state, uint8_t num_tasks);
+
+    /// Advance the tick counter; call once per main loop tick.
+    ///
+    void tick(void) {
+        _tick_counter++;
+    }
+
+    /// Run the tasks that are due and fit in the time available.
+    ///
+    /// The tasks put off on the last tick go first, then the rest in
+    /// table order.  A task that has been kept waiting for more than an
+    /// extra interval is run even if it doesn't fit, so that a busy fast
+    /// loop can delay the slow tasks but never starve them.
+    ///
+    /// @param  time_available  Microseconds left in the current tick.
+    ///
+    void run(uint16_t time_available);
+
+    /// Number of times a task ran for longer than its max_time_micros.
+    ///
+    /// @param  task            Index of the task in the table.
+    ///
+    uint16_t overruns(uint8_t task) const {
+        return (task < _num_tasks) ? _state[task].overruns : 0;
+    }
+
+    /// Total number of task overruns since ::init.
+    ///
+    uint16_t total_overruns(void) const;
+
+    /// The number of ticks since ::init.
+    ///
+    uint16_t ticks(void) const {
+        return _tick_counter;
+    }
+
+private:
+    const Task  *_tasks;                ///< task table, in program memory
+    uint8_t     _num_tasks;             ///< number of entries in _tasks
+    uint16_t    _tick_counter;          ///< ticks since init
+    Task_State  *_state;                ///< per task state, _num_tasks entries
+
+    /// Run task i if it is due and fits in time_available, which it
+    /// reduces by the time the task takes.
+    ///
+    void _run_task(uint8_t i, uint16_t &time_available);
+};
+
+#endif // AP_Scheduler_h
@@ -0,0 +1,60 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+//
+// Simple test for the AP_Scheduler interface
+//
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include <AP_Scheduler.h>
+
+FastSerialPort0(Serial);        // FTDI/console
+
+static AP_Scheduler scheduler;
+static uint32_t     fast_loopTimer;
+static uint16_t     fast_count, ten_hz_count, one_hz_count;
+
+static void ten_hz_task(void)
+{
+    ten_hz_count++;
+    delayMicroseconds(2000);
+}
+
+static void one_hz_task(void)
+{
+    one_hz_count++;
+    Serial.printf_P(PSTR("ticks=%u fast=%u 10Hz=%u 1Hz=%u overruns=%u/%u\n"),
+                    scheduler.ticks(), fast_count, ten_hz_count, one_hz_count,
+                    scheduler.overruns(0), scheduler.overruns(1));
+}
+
+// run at 100Hz, so the 10Hz task is due every 10 ticks
+static const AP_Scheduler::Task scheduler_tasks[] PROGMEM = {
+    { ten_hz_task,      10,     2500 },
+    { one_hz_task,     100,     1000 },
+};
+static AP_Scheduler::Task_State scheduler_state[sizeof(scheduler_tasks)/sizeof(scheduler_tasks[0])];
+
+void setup(void)
+{
+    Serial.begin(115200);
+    Serial.println_P(PSTR("AP_Scheduler test"));
+    scheduler.init(scheduler_tasks, scheduler_state);
+}
+
+void loop(void)
+{
+    uint32_t timer = micros();
+
+    if (timer - fast_loopTimer < 10000) {
+        return;
+    }
+    fast_loopTimer = timer;
+
+    // pretend to be a fast loop that takes 6ms
+    fast_count++;
+    delayMicroseconds(6000);
+
+    scheduler.tick();
+    timer = micros() - timer;
+    scheduler.run(timer < 10000 ? 10000 - timer : 0);
+}
@@ -5,13 +5,75 @@
 #define DataFlash_h
 
 #include <stdint.h>
+#include <stddef.h>
+
+class AP_PeriodicProcess;
+
+// Message type of the format records written at the start of each log.
+// Each one describes one of the other message types of the log, so that
+// the log can be decoded without the code that wrote it.
+#define LOG_FORMAT_MSG	0x80
+
+// The payload of a LOG_FORMAT_MSG record. length is the number of
+// payload bytes of the message it describes, without the two head
+// bytes, the message type and the end byte. format has one character
+// per field, in the order they are written:
+//
+//   b   int8_t          B   uint8_t
+//   h   int16_t         H   uint16_t
+//   i   int32_t         I   uint32_t
+//   c   int16_t * 100   C   uint16_t * 100
+//   e   int32_t * 100   L   int32_t * 10^7 (latitude, longitude)
+//   M   uint8_t flight mode
+//
+// Multi-byte fields are big-endian, as written by WriteInt() and
+// WriteLong(). labels holds the field names, separated by commas.
+struct Log_Format {
+	uint8_t type;
+	uint8_t length;
+	char name[5];
+	char format[16];
+	char labels[64];
+};
+
+// A record with LOG_DELTA_FLAG added to its message type has the fields
+// of the message type without the flag, each written as its difference
+// from the same field of the last record of that type, modulo 2^32. A
+// difference d is written zig-zag encoded, (d << 1) ^ (d >> 31), as a
+// varint: 7 bits a byte, low bits first, with the top bit set on every
+// byte but the last. Delta records follow an ordinary record of the
+// type, the keyframe, so a reader that doesn't know about them still
+// gets every keyframe.
+#define LOG_DELTA_FLAG		0x40
+#define LOG_DELTA_FIELDS	8	// most fields a delta encoded type can have
+
+// The last record of a delta encoded message type
+struct Log_Delta {
+	uint8_t count;		// records since the keyframe, 0 before the first one
+	int32_t last[LOG_DELTA_FIELDS];
+};
+
+// When Init() is given a scheduler, WriteByte() only appends to a RAM
+// ring of DF_RING_SIZE bytes, and a timer process moves up to
+// DF_DRAIN_BYTES a tick from the ring into the chip buffer, committing
+// each full page once the chip has finished with the last one. So
+// logging from the fast loop never waits on the chip. Bytes that find
+// the ring full are dropped and counted, see GetDropped(); a reader
+// resynchronises on the next record head. Bursts bigger than the ring
+// are written between SyncWrite(true) and SyncWrite(false), which goes
+// to the chip directly and waits on it. DF_RING_SIZE must be a power of
+// two no bigger than 256.
+#ifndef DF_RING_SIZE
+# define DF_RING_SIZE	256
+#endif
+#define DF_DRAIN_BYTES	32
 
 class DataFlash_Class
 {
   public:
 	DataFlash_Class() {} // Constructor
 
-  virtual void Init() = 0;
+  virtual void Init(AP_PeriodicProcess *scheduler = NULL) = 0;
 	virtual void ReadManufacturerID() = 0;
 	virtual int16_t GetPage() = 0;
 	virtual int16_t GetWritePage() = 0;
@@ -21,12 +83,15 @@ class DataFlash_Class
   // Write methods
 	virtual void StartWrite(int16_t PageAdr) = 0;
 	virtual void FinishWrite() = 0;
+	virtual void StopWrite() = 0;
+	virtual void SyncWrite(bool on) = 0;
 	virtual void WriteByte(unsigned char data) = 0;
 	virtual void WriteInt(int16_t data) = 0;
 	virtual void WriteLong(int32_t data) = 0;
+	virtual uint16_t GetDropped() = 0;
 
 	// Read methods
-	virtual void StartRead(int16_t PageAdr) = 0;
+	virtual bool StartRead(int16_t PageAdr) = 0;
 	virtual unsigned char ReadByte() = 0;
 	virtual int16_t ReadInt() = 0;
 	virtual int32_t ReadLong() = 0;
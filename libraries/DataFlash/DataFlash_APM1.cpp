@@ -21,7 +21,8 @@
 		WriteByte(data) : Write a byte
 		WriteInt(data) :  Write an integer (2 bytes)
 		WriteLong(data) : Write a long (4 bytes)
-		StartRead(page) : Start a read on (page)
+		StopWrite() : Finish the current page and stop writing until the next StartWrite
+		StartRead(page) : Start a read on (page), false while writing
 		GetWritePage() : Returns the last page written to
 		GetPage() : Returns the last page read
 		ReadByte()
@@ -35,6 +36,7 @@
 #include <stdint.h>
 #include "DataFlash.h"
 #include <SPI.h>
+#include "../AP_PeriodicProcess/AP_PeriodicProcess.h"
 
 #define OVERWRITE_DATA 1 // 0: When reach the end page stop, 1: Start overwriting from page 1
 
@@ -72,6 +74,9 @@
 #define DF_CHIP_ERASE_2   0x80
 #define DF_CHIP_ERASE_3   0x9A
 
+// the writer the timer process drains the ring of
+static DataFlash_APM1 *ring_writer;
+
 // *** INTERNAL FUNCTIONS ***
 
 void dataflash_CS_inactive()
@@ -90,7 +95,7 @@ DataFlash_APM1::DataFlash_APM1()
 }
 
 // Public Methods //////////////////////////////////////////////////////////////
-void DataFlash_APM1::Init(void)
+void DataFlash_APM1::Init(AP_PeriodicProcess *scheduler)
 {
   pinMode(DF_DATAOUT, OUTPUT);
   pinMode(DF_DATAIN, INPUT);
@@ -105,6 +110,7 @@ void DataFlash_APM1::Init(void)
   #endif
 
   df_Read_END=false;
+  df_Stop_Write=1;	// nothing to write until StartWrite()
 
   dataflash_CS_inactive();     //disable device
 
@@ -116,6 +122,21 @@ void DataFlash_APM1::Init(void)
 
   // get page size: 512 or 528
   df_PageSize=PageSize();
+
+  df_Ring_Head=0;
+  df_Ring_Tail=0;
+  df_Ring_Hold=0;
+  df_Ring_On=0;
+  df_Dropped=0;
+  if (scheduler != NULL)
+    {
+    // from now on the timer writes the log to the chip. A tick moves
+    // DF_DRAIN_BYTES in one burst and maybe starts a page, about
+    // 100us with SPI at 8MHz
+    ring_writer=this;
+    df_Ring_On=1;
+    scheduler->register_process(DataFlash_APM1::RingTimer, 1, 200);
+    }
 }
 
 // This function is mainly to test the device
@@ -242,6 +263,23 @@ void DataFlash_APM1::BufferWrite (unsigned char BufferNum, uint16_t IntPageAdr,
   dataflash_CS_inactive();   // disable dataflash command decoder
 }
 
+void DataFlash_APM1::BufferWriteBlock (unsigned char BufferNum, uint16_t IntPageAdr, const unsigned char *Data, uint16_t Len)
+{
+  dataflash_CS_active();     // activate dataflash command decoder
+
+  if (BufferNum==1)
+    SPI.transfer(DF_BUFFER_1_WRITE);
+  else
+    SPI.transfer(DF_BUFFER_2_WRITE);
+  SPI.transfer(0x00);				 //don't cares
+  SPI.transfer((unsigned char)(IntPageAdr>>8));  //upper part of internal buffer address
+  SPI.transfer((unsigned char)(IntPageAdr));	 //lower part of internal buffer address
+  while (Len--)
+    SPI.transfer(*Data++);			 //the chip steps the buffer address itself
+
+  dataflash_CS_inactive();   // disable dataflash command decoder
+}
+
 unsigned char DataFlash_APM1::BufferRead (unsigned char BufferNum, uint16_t IntPageAdr)
 {
   byte tmp;
@@ -306,20 +344,27 @@ void DataFlash_APM1::ChipErase ()
 // *** DATAFLASH PUBLIC FUNCTIONS ***
 void DataFlash_APM1::StartWrite(int16_t PageAdr)
 {
+  df_Ring_Hold=1;		// keep the timer off the chip while we start
   df_BufferNum=1;
   df_BufferIdx=4;
   df_PageAdr=PageAdr;
-  df_Stop_Write=0;
+  df_Ring_Tail=df_Ring_Head;	// drop anything left from the last write
   WaitReady();
-      // We are starting a new page - write FileNumber and FilePage
-		BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
-		BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
-		BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
-		BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+
+  // We are starting a new page - write FileNumber and FilePage
+  BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
+  BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
+  BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
+  BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+  df_Stop_Write=0;
+  df_Ring_Hold=0;
 }
 
 void DataFlash_APM1::FinishWrite(void)
 {
+	df_Ring_Hold=1;		// keep the timer off the chip until we are done
+	RingDrain(DF_RING_SIZE,1);	// the rest of the ring goes in first
+	WaitReady();		// the timer may have just written a page
 	df_BufferIdx=0;
 	BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
 	df_PageAdr++;
@@ -338,42 +383,135 @@ void DataFlash_APM1::FinishWrite(void)
         df_BufferNum=2;
 	else
         df_BufferNum=1;
+	df_Ring_Hold=0;
 }
 
+// Write out the page being written, and ignore any more writes until
+// the next StartWrite(), so the chip can be read without the writer
+// getting in the way
+void DataFlash_APM1::StopWrite(void)
+{
+	if (!df_Stop_Write) {
+		FinishWrite();
+		df_Stop_Write=1;
+	}
+}
 
-void DataFlash_APM1::WriteByte(byte data)
+// Write the full buffer to its page, NO WAIT, and start the next page
+// in the other buffer. The chip must be ready for it.
+void DataFlash_APM1::NextPage(void)
 {
-  if (!df_Stop_Write)
+  df_BufferIdx=4;		//(4 bytes for FileNumber, FilePage)
+  BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
+  df_PageAdr++;
+  if (OVERWRITE_DATA==1)
+    {
+    if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, start from the begining
+      df_PageAdr = 1;
+    }
+  else
+    {
+    if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, stop here
+      df_Stop_Write=1;
+    }
+
+  if (df_BufferNum==1)  // Change buffer to continue writing...
+    df_BufferNum=2;
+  else
+    df_BufferNum=1;
+  // We are starting a new page - write FileNumber and FilePage
+  BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
+  BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
+  df_FilePage++;
+  BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
+  BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+}
+
+// Move up to max bytes from the ring into the chip buffer, writing out
+// each page as it fills. Without wait it leaves a full page the chip
+// isn't ready for yet, and carries on from there on a later call.
+void DataFlash_APM1::RingDrain(uint16_t max, unsigned char wait)
+{
+  uint8_t tail = df_Ring_Tail;
+  uint16_t len;
+
+  while (max > 0 && tail != df_Ring_Head && !df_Stop_Write)
     {
-    BufferWrite(df_BufferNum,df_BufferIdx,data);
-    df_BufferIdx++;
     if (df_BufferIdx >= df_PageSize)  // End of buffer?
       {
-      df_BufferIdx=4;		//(4 bytes for FileNumber, FilePage)
-	  BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
-      df_PageAdr++;
-	  if (OVERWRITE_DATA==1)
-	    {
-        if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, start from the begining
-		  df_PageAdr = 1;
-	    }
-      else
-	    {
-        if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, stop here
-		  df_Stop_Write=1;
-	    }
+      if (wait)
+        WaitReady();
+      else if (!ReadStatus())
+        break;
+      NextPage();
+      continue;
+      }
+    // one burst, up to the end of the ring or of the page
+    len = (df_Ring_Head - tail) & (DF_RING_SIZE - 1);
+    if (len > DF_RING_SIZE - tail)
+      len = DF_RING_SIZE - tail;
+    if (len > df_PageSize - df_BufferIdx)
+      len = df_PageSize - df_BufferIdx;
+    if (len > max)
+      len = max;
+    BufferWriteBlock(df_BufferNum,df_BufferIdx,&df_Ring[tail],len);
+    df_BufferIdx += len;
+    max -= len;
+    tail = (tail + len) & (DF_RING_SIZE - 1);
+    df_Ring_Tail = tail;
+    }
+}
 
-      if (df_BufferNum==1)  // Change buffer to continue writing...
-        df_BufferNum=2;
+// The timer process: the next bytes of the ring go to the chip, unless
+// the main loop is using it
+void DataFlash_APM1::RingTimer(void)
+{
+  DataFlash_APM1 *df = ring_writer;
+
+  if (df->df_Ring_On && !df->df_Ring_Hold)
+    df->RingDrain(DF_DRAIN_BYTES,0);
+}
+
+// Between SyncWrite(true) and SyncWrite(false) WriteByte() goes
+// straight to the chip, waiting on it as it needs to, with the timer
+// process held off. For bursts bigger than the ring, such as the format
+// records at the start of a log.
+void DataFlash_APM1::SyncWrite(bool on)
+{
+  if (on)
+    {
+    df_Ring_Hold=1;
+    RingDrain(DF_RING_SIZE,1);	// what is in the ring goes first
+    }
+  else
+    df_Ring_Hold=0;
+}
+
+void DataFlash_APM1::WriteByte(byte data)
+{
+  uint8_t next;
+
+  if (!df_Stop_Write)
+    {
+    if (df_Ring_On && !df_Ring_Hold)
+      {
+      next = (df_Ring_Head + 1) & (DF_RING_SIZE - 1);
+      if (next == df_Ring_Tail)  // Ring full?
+        df_Dropped++;
       else
-        df_BufferNum=1;
-      // We are starting a new page - write FileNumber and FilePage
-		BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
-		BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
-		df_FilePage++;
-		BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
-		BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+        {
+        df_Ring[df_Ring_Head] = data;
+        df_Ring_Head = next;
+        }
+      return;
       }
+    if (df_BufferIdx >= df_PageSize)  // End of buffer?
+      {
+      WaitReady();
+      NextPage();
+      }
+    BufferWrite(df_BufferNum,df_BufferIdx,data);
+    df_BufferIdx++;
     }
 }
 
@@ -397,14 +535,25 @@ int16_t DataFlash_APM1::GetWritePage()
   return(df_PageAdr);
 }
 
+// Get the number of bytes dropped because the ring was full
+uint16_t DataFlash_APM1::GetDropped()
+{
+  return(df_Dropped);
+}
+
 // Get the last page read
 int16_t DataFlash_APM1::GetPage()
 {
   return(df_Read_PageAdr-1);
 }
 
-void DataFlash_APM1::StartRead(int16_t PageAdr)
+// Start reading at PageAdr. The read shares the chip, and its buffer 1,
+// with the writer, so it is refused while a log is being written:
+// StopWrite() first, when it is safe to end the log
+bool DataFlash_APM1::StartRead(int16_t PageAdr)
 {
+  if (!df_Stop_Write)
+    return false;
   df_Read_BufferNum=1;
   df_Read_BufferIdx=4;
   df_Read_PageAdr=PageAdr;
@@ -420,6 +569,7 @@ void DataFlash_APM1::StartRead(int16_t PageAdr)
 //Serial.println(df_FileNumber, DEC);	Serial.print("\t");
 		df_FilePage = BufferRead(df_Read_BufferNum,2);   // High byte
 		df_FilePage = (df_FilePage<<8) | BufferRead(df_Read_BufferNum,3); // Low byte
+  return true;
 }
 
 byte DataFlash_APM1::ReadByte()
@@ -6,8 +6,12 @@
 
 #include "DataFlash.h"
 
-// flash size
-#define DF_LAST_PAGE 4096
+// flash size. Logs use pages 1 to DF_LAST_PAGE, and the last
+// DF_DIR_PAGES pages hold the log directory
+#define DF_NUM_PAGES 4096
+#define DF_DIR_PAGES 8
+#define DF_DIR_PAGE (DF_NUM_PAGES - DF_DIR_PAGES)
+#define DF_LAST_PAGE (DF_DIR_PAGE - 1)
 
 class DataFlash_APM1 : public DataFlash_Class
 {
@@ -23,15 +27,26 @@ class DataFlash_APM1 : public DataFlash_Class
 	unsigned char df_Stop_Write;
 	uint16_t df_FileNumber;
 	uint16_t df_FilePage;
+	// the RAM ring WriteByte() appends to, see DataFlash.h
+	unsigned char df_Ring[DF_RING_SIZE];
+	volatile uint8_t df_Ring_Head;		// next free byte, only moved by WriteByte()
+	volatile uint8_t df_Ring_Tail;		// next byte for the chip
+	volatile unsigned char df_Ring_Hold;	// keeps the timer process off the chip
+	unsigned char df_Ring_On;
+	uint16_t df_Dropped;
 	//Methods
 	unsigned char BufferRead (unsigned char BufferNum, uint16_t IntPageAdr);
 	void BufferWrite (unsigned char BufferNum, uint16_t IntPageAdr, unsigned char Data);
+	void BufferWriteBlock (unsigned char BufferNum, uint16_t IntPageAdr, const unsigned char *Data, uint16_t Len);
 	void BufferToPage (unsigned char BufferNum, uint16_t PageAdr, unsigned char wait);
 	void PageToBuffer(unsigned char BufferNum, uint16_t PageAdr);
 	void WaitReady();
 	unsigned char ReadStatusReg();
 	unsigned char ReadStatus();
 	uint16_t PageSize();
+	void NextPage();
+	void RingDrain(uint16_t max, unsigned char wait);
+	static void RingTimer();
 
   public:
 	unsigned char df_manufacturer;
@@ -40,7 +55,7 @@ class DataFlash_APM1 : public DataFlash_Class
 	uint16_t df_PageSize;
 
 	DataFlash_APM1(); // Constructor
-	void Init();
+	void Init(AP_PeriodicProcess *scheduler = NULL);
 	void ReadManufacturerID();
 	int16_t GetPage();
 	int16_t GetWritePage();
@@ -49,12 +64,15 @@ class DataFlash_APM1 : public DataFlash_Class
 	// Write methods
 	void StartWrite(int16_t PageAdr);
 	void FinishWrite();
+	void StopWrite();
+	void SyncWrite(bool on);
 	void WriteByte(unsigned char data);
 	void WriteInt(int16_t data);
 	void WriteLong(int32_t data);
+	uint16_t GetDropped();
 
 	// Read methods
-	void StartRead(int16_t PageAdr);
+	bool StartRead(int16_t PageAdr);
 	unsigned char ReadByte();
 	int16_t ReadInt();
 	int32_t ReadLong();
@@ -21,7 +21,8 @@
 		WriteByte(data) : Write a byte
 		WriteInt(data) :  Write an integer (2 bytes)
 		WriteLong(data) : Write a long (4 bytes)
-		StartRead(page) : Start a read on (page)
+		StopWrite() : Finish the current page and stop writing until the next StartWrite
+		StartRead(page) : Start a read on (page), false while writing
 		GetWritePage() : Returns the last page written to
 		GetPage() : Returns the last page read
 		ReadByte()
@@ -40,6 +41,7 @@ extern "C" {
 }
 
 #include "DataFlash_APM2.h"
+#include "../AP_PeriodicProcess/AP_PeriodicProcess.h"
 
 // DataFlash is connected to Serial Port 3 (we will use SPI mode)
 #if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
@@ -78,6 +80,9 @@ extern "C" {
 
 #define OVERWRITE_DATA 0 // 0: When reach the end page stop, 1: Start overwritten from page 1
 
+// the writer the timer process drains the ring of
+static DataFlash_APM2 *ring_writer;
+
 // *** INTERNAL FUNCTIONS ***
 unsigned char DataFlash_APM2::SPI_transfer(unsigned char data)
 {
@@ -107,7 +112,7 @@ DataFlash_APM2::DataFlash_APM2()
 }
 
 // Public Methods //////////////////////////////////////////////////////////////
-void DataFlash_APM2::Init(void)
+void DataFlash_APM2::Init(AP_PeriodicProcess *scheduler)
 {
   pinMode(DF_DATAOUT, OUTPUT);
   pinMode(DF_DATAIN, INPUT);
@@ -121,6 +126,7 @@ void DataFlash_APM2::Init(void)
   digitalWrite(DF_RESET,HIGH);
 
   df_Read_END=false;
+  df_Stop_Write=1;	// nothing to write until StartWrite()
 
   CS_inactive();     //disable device
 
@@ -136,6 +142,21 @@ void DataFlash_APM2::Init(void)
 
   // get page size: 512 or 528  (by default: 528)
   df_PageSize=PageSize();
+
+  df_Ring_Head=0;
+  df_Ring_Tail=0;
+  df_Ring_Hold=0;
+  df_Ring_On=0;
+  df_Dropped=0;
+  if (scheduler != NULL)
+    {
+    // from now on the timer writes the log to the chip. A tick moves
+    // DF_DRAIN_BYTES in one burst and maybe starts a page, about
+    // 100us with the USART at 8MHz
+    ring_writer=this;
+    df_Ring_On=1;
+    scheduler->register_process(DataFlash_APM2::RingTimer, 1, 200);
+    }
 }
 
 // This function is mainly to test the device
@@ -257,6 +278,22 @@ void DataFlash_APM2::BufferWrite (unsigned char BufferNum, uint16_t IntPageAdr,
   SPI_transfer(Data);				 //write data byte
 }
 
+void DataFlash_APM2::BufferWriteBlock (unsigned char BufferNum, uint16_t IntPageAdr, const unsigned char *Data, uint16_t Len)
+{
+  CS_inactive();   // Reset dataflash command decoder
+  CS_active();
+
+  if (BufferNum==1)
+    SPI_transfer(DF_BUFFER_1_WRITE);
+  else
+    SPI_transfer(DF_BUFFER_2_WRITE);
+  SPI_transfer(0x00);				 //don't cares
+  SPI_transfer((unsigned char)(IntPageAdr>>8));  //upper part of internal buffer address
+  SPI_transfer((unsigned char)(IntPageAdr));	 //lower part of internal buffer address
+  while (Len--)
+    SPI_transfer(*Data++);			 //the chip steps the buffer address itself
+}
+
 unsigned char DataFlash_APM2::BufferRead (unsigned char BufferNum, uint16_t IntPageAdr)
 {
   byte tmp;
@@ -317,10 +354,11 @@ void DataFlash_APM2::ChipErase ()
 // *** DATAFLASH PUBLIC FUNCTIONS ***
 void DataFlash_APM2::StartWrite(int16_t PageAdr)
 {
+  df_Ring_Hold=1;		// keep the timer off the chip while we start
   df_BufferNum=1;
   df_BufferIdx=4;
   df_PageAdr=PageAdr;
-  df_Stop_Write=0;
+  df_Ring_Tail=df_Ring_Head;	// drop anything left from the last write
   WaitReady();
 
   // We are starting a new page - write FileNumber and FilePage
@@ -328,21 +366,26 @@ void DataFlash_APM2::StartWrite(int16_t PageAdr)
   BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
   BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
   BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+  df_Stop_Write=0;
+  df_Ring_Hold=0;
 }
 
 void DataFlash_APM2::FinishWrite(void)
 {
+	df_Ring_Hold=1;		// keep the timer off the chip until we are done
+	RingDrain(DF_RING_SIZE,1);	// the rest of the ring goes in first
+	WaitReady();		// the timer may have just written a page
 	df_BufferIdx=0;
 	BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
 	df_PageAdr++;
 	if (OVERWRITE_DATA==1)
 	    {
-        if (df_PageAdr>=DF_MAX_PAGE)  // If we reach the end of the memory, start from the begining
+        if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the log pages, start from the begining
 		  df_PageAdr = 1;
 	    }
 	else
 	    {
-        if (df_PageAdr>=DF_MAX_PAGE)  // If we reach the end of the memory, stop here
+        if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the log pages, stop here
 		  df_Stop_Write=1;
 	    }
 
@@ -350,42 +393,135 @@ void DataFlash_APM2::FinishWrite(void)
         df_BufferNum=2;
 	else
         df_BufferNum=1;
+	df_Ring_Hold=0;
 }
 
+// Write out the page being written, and ignore any more writes until
+// the next StartWrite(), so the chip can be read without the writer
+// getting in the way
+void DataFlash_APM2::StopWrite(void)
+{
+	if (!df_Stop_Write) {
+		FinishWrite();
+		df_Stop_Write=1;
+	}
+}
 
-void DataFlash_APM2::WriteByte(byte data)
+// Write the full buffer to its page, NO WAIT, and start the next page
+// in the other buffer. The chip must be ready for it.
+void DataFlash_APM2::NextPage(void)
 {
-  if (!df_Stop_Write)
+  df_BufferIdx=4;		//(4 bytes for FileNumber, FilePage)
+  BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
+  df_PageAdr++;
+  if (OVERWRITE_DATA==1)
+    {
+    if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the log pages, start from the begining
+      df_PageAdr = 1;
+    }
+  else
+    {
+    if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the log pages, stop here
+      df_Stop_Write=1;
+    }
+
+  if (df_BufferNum==1)  // Change buffer to continue writing...
+    df_BufferNum=2;
+  else
+    df_BufferNum=1;
+  // We are starting a new page - write FileNumber and FilePage
+  BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
+  BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
+  df_FilePage++;
+  BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
+  BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+}
+
+// Move up to max bytes from the ring into the chip buffer, writing out
+// each page as it fills. Without wait it leaves a full page the chip
+// isn't ready for yet, and carries on from there on a later call.
+void DataFlash_APM2::RingDrain(uint16_t max, unsigned char wait)
+{
+  uint8_t tail = df_Ring_Tail;
+  uint16_t len;
+
+  while (max > 0 && tail != df_Ring_Head && !df_Stop_Write)
     {
-    BufferWrite(df_BufferNum,df_BufferIdx,data);
-    df_BufferIdx++;
     if (df_BufferIdx >= df_PageSize)  // End of buffer?
       {
-	  df_BufferIdx=4;		//(4 bytes for FileNumber, FilePage)
-	  BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
-      df_PageAdr++;
-	  if (OVERWRITE_DATA==1)
-	    {
-        if (df_PageAdr>=DF_MAX_PAGE)  // If we reach the end of the memory, start from the begining
-		  df_PageAdr = 1;
-	    }
-      else
-	    {
-        if (df_PageAdr>=DF_MAX_PAGE)  // If we reach the end of the memory, stop here
-		  df_Stop_Write=1;
-	    }
+      if (wait)
+        WaitReady();
+      else if (!ReadStatus())
+        break;
+      NextPage();
+      continue;
+      }
+    // one burst, up to the end of the ring or of the page
+    len = (df_Ring_Head - tail) & (DF_RING_SIZE - 1);
+    if (len > DF_RING_SIZE - tail)
+      len = DF_RING_SIZE - tail;
+    if (len > df_PageSize - df_BufferIdx)
+      len = df_PageSize - df_BufferIdx;
+    if (len > max)
+      len = max;
+    BufferWriteBlock(df_BufferNum,df_BufferIdx,&df_Ring[tail],len);
+    df_BufferIdx += len;
+    max -= len;
+    tail = (tail + len) & (DF_RING_SIZE - 1);
+    df_Ring_Tail = tail;
+    }
+}
 
-      if (df_BufferNum==1)  // Change buffer to continue writing...
-        df_BufferNum=2;
+// The timer process: the next bytes of the ring go to the chip, unless
+// the main loop is using it
+void DataFlash_APM2::RingTimer(void)
+{
+  DataFlash_APM2 *df = ring_writer;
+
+  if (df->df_Ring_On && !df->df_Ring_Hold)
+    df->RingDrain(DF_DRAIN_BYTES,0);
+}
+
+// Between SyncWrite(true) and SyncWrite(false) WriteByte() goes
+// straight to the chip, waiting on it as it needs to, with the timer
+// process held off. For bursts bigger than the ring, such as the format
+// records at the start of a log.
+void DataFlash_APM2::SyncWrite(bool on)
+{
+  if (on)
+    {
+    df_Ring_Hold=1;
+    RingDrain(DF_RING_SIZE,1);	// what is in the ring goes first
+    }
+  else
+    df_Ring_Hold=0;
+}
+
+void DataFlash_APM2::WriteByte(byte data)
+{
+  uint8_t next;
+
+  if (!df_Stop_Write)
+    {
+    if (df_Ring_On && !df_Ring_Hold)
+      {
+      next = (df_Ring_Head + 1) & (DF_RING_SIZE - 1);
+      if (next == df_Ring_Tail)  // Ring full?
+        df_Dropped++;
       else
-        df_BufferNum=1;
-      // We are starting a new page - write FileNumber and FilePage
-      BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
-      BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
-      df_FilePage++;
-      BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
-      BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+        {
+        df_Ring[df_Ring_Head] = data;
+        df_Ring_Head = next;
+        }
+      return;
       }
+    if (df_BufferIdx >= df_PageSize)  // End of buffer?
+      {
+      WaitReady();
+      NextPage();
+      }
+    BufferWrite(df_BufferNum,df_BufferIdx,data);
+    df_BufferIdx++;
     }
 }
 
@@ -409,14 +545,25 @@ int16_t DataFlash_APM2::GetWritePage()
   return(df_PageAdr);
 }
 
+// Get the number of bytes dropped because the ring was full
+uint16_t DataFlash_APM2::GetDropped()
+{
+  return(df_Dropped);
+}
+
 // Get the last page read
 int16_t DataFlash_APM2::GetPage()
 {
   return(df_Read_PageAdr-1);
 }
 
-void DataFlash_APM2::StartRead(int16_t PageAdr)
+// Start reading at PageAdr. The read shares the chip, and its buffer 1,
+// with the writer, so it is refused while a log is being written:
+// StopWrite() first, when it is safe to end the log
+bool DataFlash_APM2::StartRead(int16_t PageAdr)
 {
+  if (!df_Stop_Write)
+    return false;
   df_Read_BufferNum=1;
   df_Read_BufferIdx=4;
   df_Read_PageAdr=PageAdr;
@@ -429,6 +576,7 @@ void DataFlash_APM2::StartRead(int16_t PageAdr)
   df_FileNumber = (df_FileNumber<<8) | BufferRead(df_Read_BufferNum,1); // Low byte
   df_FilePage = BufferRead(df_Read_BufferNum,2);   // High byte
   df_FilePage = (df_FilePage<<8) | BufferRead(df_Read_BufferNum,3); // Low byte
+  return true;
 }
 
 byte DataFlash_APM2::ReadByte()
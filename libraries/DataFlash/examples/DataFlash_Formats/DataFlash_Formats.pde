@@ -0,0 +1,140 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+//
+// Test that the format records at the start of a log get through the
+// DataFlash write ring. A log is started the way the vehicles start
+// one, with more format records than the ring holds, and then read
+// back and its FMT block decoded.
+//
+
+#include <FastSerial.h>
+#include <AP_Common.h>
+#include <SPI.h>
+#include <Arduino_Mega_ISR_Registry.h>
+#include <AP_PeriodicProcess.h>
+#include <DataFlash.h>
+
+FastSerialPort0(Serial);        // FTDI/console
+
+#define HEAD_BYTE1      0xA3
+#define HEAD_BYTE2      0x95
+#define END_BYTE        0xBA
+#define TEST_PAGE       1
+#define TEST_FORMATS    8       // 720 bytes of format records
+#define TEST_MSG        1
+
+static DataFlash_APM1 DataFlash;
+
+// The stub never runs the timer process, so nothing drains the ring
+// but SyncWrite() and FinishWrite(); the worst case for the ring
+static AP_PeriodicProcessStub scheduler;
+
+// The format record for message type i + 1
+static void make_format(uint8_t i, struct Log_Format *fmt)
+{
+    memset(fmt, 0, sizeof(*fmt));
+    fmt->type = TEST_MSG + i;
+    fmt->length = 4;
+    fmt->name[0] = 'T';
+    fmt->name[1] = '0' + i;
+    strcpy(fmt->format, "I");
+    strcpy(fmt->labels, "Value");
+}
+
+static void write_log(void)
+{
+    struct Log_Format fmt;
+
+    DataFlash.StartWrite(TEST_PAGE);
+
+    // as Log_Write_Formats() in the vehicles does
+    DataFlash.SyncWrite(true);
+    for (uint8_t i = 0; i < TEST_FORMATS; i++) {
+        make_format(i, &fmt);
+        DataFlash.WriteByte(HEAD_BYTE1);
+        DataFlash.WriteByte(HEAD_BYTE2);
+        DataFlash.WriteByte(LOG_FORMAT_MSG);
+        for (uint8_t j = 0; j < sizeof(fmt); j++) {
+            DataFlash.WriteByte(((uint8_t *)&fmt)[j]);
+        }
+        DataFlash.WriteByte(END_BYTE);
+    }
+    DataFlash.SyncWrite(false);
+
+    // and an ordinary record after them, through the ring
+    DataFlash.WriteByte(HEAD_BYTE1);
+    DataFlash.WriteByte(HEAD_BYTE2);
+    DataFlash.WriteByte(TEST_MSG);
+    DataFlash.WriteLong(0x12345678);
+    DataFlash.WriteByte(END_BYTE);
+
+    DataFlash.StopWrite();
+}
+
+// Decode the FMT block, returning the number of format records that
+// came back as they were written
+static uint8_t read_formats(void)
+{
+    struct Log_Format fmt, got;
+    uint8_t ok = 0;
+
+    DataFlash.StartRead(TEST_PAGE);
+    for (uint8_t i = 0; i < TEST_FORMATS; i++) {
+        make_format(i, &fmt);
+        if (DataFlash.ReadByte() != HEAD_BYTE1 ||
+            DataFlash.ReadByte() != HEAD_BYTE2 ||
+            DataFlash.ReadByte() != LOG_FORMAT_MSG) {
+            Serial.printf_P(PSTR("format %u: bad head\n"), i);
+            return ok;
+        }
+        for (uint8_t j = 0; j < sizeof(got); j++) {
+            ((uint8_t *)&got)[j] = DataFlash.ReadByte();
+        }
+        if (DataFlash.ReadByte() != END_BYTE) {
+            Serial.printf_P(PSTR("format %u: bad end byte\n"), i);
+            return ok;
+        }
+        if (memcmp(&fmt, &got, sizeof(fmt)) != 0) {
+            Serial.printf_P(PSTR("format %u: wrong contents\n"), i);
+            return ok;
+        }
+        ok++;
+    }
+    return ok;
+}
+
+// The ordinary record that follows the FMT block
+static bool read_record(void)
+{
+    return DataFlash.ReadByte() == HEAD_BYTE1 &&
+           DataFlash.ReadByte() == HEAD_BYTE2 &&
+           DataFlash.ReadByte() == TEST_MSG &&
+           DataFlash.ReadLong() == 0x12345678 &&
+           DataFlash.ReadByte() == END_BYTE;
+}
+
+void setup(void)
+{
+    uint8_t ok;
+    bool record;
+
+    Serial.begin(115200);
+    Serial.println_P(PSTR("DataFlash format record test"));
+
+    DataFlash.Init(&scheduler);
+    write_log();
+    ok = read_formats();
+    record = read_record();
+
+    Serial.printf_P(PSTR("formats %u/%u, record %S, dropped %u\n"),
+                    ok, TEST_FORMATS, record ? PSTR("ok") : PSTR("bad"),
+                    DataFlash.GetDropped());
+    if (ok == TEST_FORMATS && record && DataFlash.GetDropped() == 0) {
+        Serial.println_P(PSTR("PASS"));
+    } else {
+        Serial.println_P(PSTR("FAIL"));
+    }
+}
+
+void loop(void)
+{
+}
@@ -47,6 +47,7 @@ void setup()
 		DataFlash.WriteByte(0x4E);
 		delay(10);
 		}
+	DataFlash.StopWrite();	 // the chip can't be read while writing
 	delay(100);
 }
 
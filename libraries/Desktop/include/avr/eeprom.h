@@ -16,6 +16,10 @@ void eeprom_write_byte(uint8_t *p, uint8_t value);
 void eeprom_write_word(uint16_t *p, uint16_t value);
 void eeprom_write_dword(uint32_t *p, uint32_t value);
 void eeprom_write_block(const void *buf, void *ptr, uint8_t size);
+
+// the emulated EEPROM is always ready for the next write
+#define eeprom_is_ready() 1
+#define eeprom_busy_wait() do {} while (0)
 	
 #ifdef __cplusplus
 }
@@ -20,8 +20,33 @@ void pinMode(uint8_t pin, uint8_t mode)
 }
 
 
+/*
+  with a virtual clock, time only moves when the SITL code steps
+  it. Code that busy-waits on millis() or micros() would never see
+  time advance, so if the clock is read many times without being
+  stepped we nudge it forward by one timer tick
+ */
+static uint64_t virtual_time_usec(void)
+{
+	static uint64_t last_usec;
+	static uint32_t spin_count;
+
+	if (desktop_state.virtual_usec != last_usec) {
+		last_usec = desktop_state.virtual_usec;
+		spin_count = 0;
+	} else if (++spin_count > 1000) {
+		spin_count = 0;
+		sitl_advance_time(1000);
+		last_usec = desktop_state.virtual_usec;
+	}
+	return desktop_state.virtual_usec;
+}
+
 long unsigned int millis(void)
 {
+	if (desktop_state.virtual_clock) {
+		return virtual_time_usec() / 1000;
+	}
 	struct timeval tp;
 	gettimeofday(&tp,NULL);
 	return 1.0e3*((tp.tv_sec + (tp.tv_usec*1.0e-6)) - 
@@ -31,6 +56,9 @@ long unsigned int millis(void)
 
 long unsigned int micros(void)
 {
+	if (desktop_state.virtual_clock) {
+		return virtual_time_usec();
+	}
 	struct timeval tp;
 	gettimeofday(&tp,NULL);
 	return 1.0e6*((tp.tv_sec + (tp.tv_usec*1.0e-6)) - 
@@ -40,6 +68,11 @@ long unsigned int micros(void)
 
 void delayMicroseconds(unsigned usec)
 {
+	if (desktop_state.virtual_clock) {
+		// run the timers for the time we would have slept
+		sitl_advance_time(usec);
+		return;
+	}
 	usleep(usec);
 }
 
@@ -6,38 +6,81 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
 #include "DataFlash.h"
 #include <SPI.h>
+#include <AP_PeriodicProcess.h>
 
 #define DF_PAGE_SIZE 512
-#define DF_NUM_PAGES 4096
+#define DF_FLASH_SIZE (DF_PAGE_SIZE*DF_NUM_PAGES)
 
-static int flash_fd;
-static uint8_t buffer[2][DF_PAGE_SIZE];
+/*
+  the whole of dataflash.bin is mapped into memory. Reading a page
+  into a chip buffer just points the buffer at the page in the
+  mapping, so nothing is copied. The first write into a buffer that
+  is aliasing a page copies it into the private write buffer first,
+  so a read can never modify the flash behind our back
+ */
+static uint8_t *flash;
+static uint8_t *buffer[2];
+static uint8_t write_buffer[2][DF_PAGE_SIZE];
 
 #define OVERWRITE_DATA 1 // 0: When reach the end page stop, 1: Start overwritten from page 1
 
+// the writer the timer process drains the ring of
+static DataFlash_APM1 *ring_writer;
+
 // Public Methods //////////////////////////////////////////////////////////////
-void DataFlash_APM1::Init(void)
-{
-	if (flash_fd == 0) {
-		flash_fd = open("dataflash.bin", O_RDWR, 0777);
-		if (flash_fd == -1) {
-			uint8_t *fill;
-			fill = (uint8_t *)malloc(DF_PAGE_SIZE*DF_NUM_PAGES);
-			flash_fd = open("dataflash.bin", O_RDWR | O_CREAT, 0777);
-			memset(fill, 0xFF, DF_PAGE_SIZE*DF_NUM_PAGES);
-			write(flash_fd, fill, DF_PAGE_SIZE*DF_NUM_PAGES);
-			free(fill);
+void DataFlash_APM1::Init(AP_PeriodicProcess *scheduler)
+{
+	if (flash == NULL) {
+		struct stat st;
+		int fd = open("dataflash.bin", O_RDWR | O_CREAT, 0777);
+		if (fd == -1 || fstat(fd, &st) != 0) {
+			perror("dataflash.bin");
+			exit(1);
+		}
+		if (ftruncate(fd, DF_FLASH_SIZE) != 0) {
+			perror("ftruncate dataflash.bin");
+			exit(1);
+		}
+		flash = (uint8_t *)mmap(NULL, DF_FLASH_SIZE, PROT_READ | PROT_WRITE,
+					MAP_SHARED, fd, 0);
+		if (flash == MAP_FAILED) {
+			perror("mmap dataflash.bin");
+			exit(1);
 		}
+		// the mapping keeps the file open for us
+		close(fd);
+		if (st.st_size < DF_FLASH_SIZE) {
+			// a new (or short) image, erased flash reads as 0xFF
+			memset(flash + st.st_size, 0xFF, DF_FLASH_SIZE - st.st_size);
+		}
+		buffer[0] = write_buffer[0];
+		buffer[1] = write_buffer[1];
 	}
 	df_PageSize = DF_PAGE_SIZE;
 	df_BufferNum  = 1;
 	df_BufferIdx  = 0;
 	df_PageAdr    = 0;
-	df_Stop_Write = 0;
+	df_Stop_Write = 1;	// nothing to write until StartWrite()
+
+	df_Ring_Head  = 0;
+	df_Ring_Tail  = 0;
+	df_Ring_Hold  = 0;
+	df_Ring_On    = 0;
+	df_Dropped    = 0;
+	if (scheduler != NULL) {
+		// from now on the timer writes the log to the chip
+		ring_writer = this;
+		df_Ring_On = 1;
+		scheduler->register_process(DataFlash_APM1::RingTimer, 1, 200);
+	}
 }
 
 // This function is mainly to test the device
@@ -77,17 +120,33 @@ void DataFlash_APM1::WaitReady()
 
 void DataFlash_APM1::PageToBuffer(unsigned char BufferNum, uint16_t PageAdr)
 {
-	pread(flash_fd, buffer[BufferNum-1], DF_PAGE_SIZE, PageAdr*DF_PAGE_SIZE);
+	buffer[BufferNum-1] = &flash[PageAdr*DF_PAGE_SIZE];
 }
 
 void DataFlash_APM1::BufferToPage (unsigned char BufferNum, uint16_t PageAdr, unsigned char wait)
 {
-	pwrite(flash_fd, buffer[BufferNum-1], DF_PAGE_SIZE, PageAdr*DF_PAGE_SIZE);
+	uint8_t *page = &flash[PageAdr*DF_PAGE_SIZE];
+	if (buffer[BufferNum-1] != page) {
+		memcpy(page, buffer[BufferNum-1], DF_PAGE_SIZE);
+	}
 }
 
 void DataFlash_APM1::BufferWrite (unsigned char BufferNum, uint16_t IntPageAdr, unsigned char Data)
 {
-	buffer[BufferNum-1][IntPageAdr] = (uint8_t)Data;
+	uint8_t *wbuf = write_buffer[BufferNum-1];
+	if (buffer[BufferNum-1] != wbuf) {
+		// the buffer is aliasing a flash page, take a private copy
+		memcpy(wbuf, buffer[BufferNum-1], DF_PAGE_SIZE);
+		buffer[BufferNum-1] = wbuf;
+	}
+	wbuf[IntPageAdr] = (uint8_t)Data;
+}
+
+void DataFlash_APM1::BufferWriteBlock (unsigned char BufferNum, uint16_t IntPageAdr, const unsigned char *Data, uint16_t Len)
+{
+	while (Len--) {
+		BufferWrite(BufferNum, IntPageAdr++, *Data++);
+	}
 }
 
 unsigned char DataFlash_APM1::BufferRead (unsigned char BufferNum, uint16_t IntPageAdr)
@@ -99,36 +158,40 @@ unsigned char DataFlash_APM1::BufferRead (unsigned char BufferNum, uint16_t IntP
 
 void DataFlash_APM1::PageErase (uint16_t PageAdr)
 {
-	uint8_t fill[DF_PAGE_SIZE];
-	memset(fill, 0xFF, sizeof(fill));
-	pwrite(flash_fd, fill, DF_PAGE_SIZE, PageAdr*DF_PAGE_SIZE);
+	memset(&flash[PageAdr*DF_PAGE_SIZE], 0xFF, DF_PAGE_SIZE);
 }
 
 
 void DataFlash_APM1::ChipErase ()
 {
-	for (int i=0; DF_NUM_PAGES; i++) {
-		PageErase(i);
-	}
+	memset(flash, 0xFF, DF_FLASH_SIZE);
+	msync(flash, DF_FLASH_SIZE, MS_ASYNC);
 }
 
 // *** DATAFLASH PUBLIC FUNCTIONS ***
 void DataFlash_APM1::StartWrite(int16_t PageAdr)
 {
+  df_Ring_Hold=1;		// keep the timer off the chip while we start
   df_BufferNum=1;
   df_BufferIdx=4;
   df_PageAdr=PageAdr;
-  df_Stop_Write=0;
+  df_Ring_Tail=df_Ring_Head;	// drop anything left from the last write
   WaitReady();
-      // We are starting a new page - write FileNumber and FilePage
-		BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
-		BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
-		BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
-		BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+
+  // We are starting a new page - write FileNumber and FilePage
+  BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
+  BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
+  BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
+  BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+  df_Stop_Write=0;
+  df_Ring_Hold=0;
 }
 
 void DataFlash_APM1::FinishWrite(void)
 {
+	df_Ring_Hold = 1;		// keep the timer off the chip until we are done
+	RingDrain(DF_RING_SIZE,1);	// the rest of the ring goes in first
+	WaitReady();		// the timer may have just written a page
 	df_BufferIdx=0;
 	BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
 	df_PageAdr++;
@@ -147,42 +210,135 @@ void DataFlash_APM1::FinishWrite(void)
         df_BufferNum=2;
 	else
         df_BufferNum=1;
+	df_Ring_Hold = 0;
+}
+
+// Write out the page being written, and ignore any more writes until
+// the next StartWrite(), so the chip can be read without the writer
+// getting in the way
+void DataFlash_APM1::StopWrite(void)
+{
+	if (!df_Stop_Write) {
+		FinishWrite();
+		df_Stop_Write=1;
+	}
 }
 
+// Write the full buffer to its page, NO WAIT, and start the next page
+// in the other buffer. The chip must be ready for it.
+void DataFlash_APM1::NextPage(void)
+{
+  df_BufferIdx=4;		//(4 bytes for FileNumber, FilePage)
+  BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
+  df_PageAdr++;
+  if (OVERWRITE_DATA==1)
+    {
+    if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, start from the begining
+      df_PageAdr = 1;
+    }
+  else
+    {
+    if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, stop here
+      df_Stop_Write=1;
+    }
 
-void DataFlash_APM1::WriteByte(byte data)
+  if (df_BufferNum==1)  // Change buffer to continue writing...
+    df_BufferNum=2;
+  else
+    df_BufferNum=1;
+  // We are starting a new page - write FileNumber and FilePage
+  BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
+  BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
+  df_FilePage++;
+  BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
+  BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+}
+
+// Move up to max bytes from the ring into the chip buffer, writing out
+// each page as it fills. Without wait it leaves a full page the chip
+// isn't ready for yet, and carries on from there on a later call.
+void DataFlash_APM1::RingDrain(uint16_t max, unsigned char wait)
 {
-  if (!df_Stop_Write)
+  uint8_t tail = df_Ring_Tail;
+  uint16_t len;
+
+  while (max > 0 && tail != df_Ring_Head && !df_Stop_Write)
     {
-    BufferWrite(df_BufferNum,df_BufferIdx,data);
-    df_BufferIdx++;
     if (df_BufferIdx >= df_PageSize)  // End of buffer?
       {
-      df_BufferIdx=4;		//(4 bytes for FileNumber, FilePage)
-	  BufferToPage(df_BufferNum,df_PageAdr,0);  // Write Buffer to memory, NO WAIT
-      df_PageAdr++;
-	  if (OVERWRITE_DATA==1)
-	    {
-        if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, start from the begining
-		  df_PageAdr = 1;
-	    }
-      else
-	    {
-        if (df_PageAdr>DF_LAST_PAGE)  // If we reach the end of the memory, stop here
-		  df_Stop_Write=1;
-	    }
+      if (wait)
+        WaitReady();
+      else if (!ReadStatus())
+        break;
+      NextPage();
+      continue;
+      }
+    // one burst, up to the end of the ring or of the page
+    len = (df_Ring_Head - tail) & (DF_RING_SIZE - 1);
+    if (len > DF_RING_SIZE - tail)
+      len = DF_RING_SIZE - tail;
+    if (len > df_PageSize - df_BufferIdx)
+      len = df_PageSize - df_BufferIdx;
+    if (len > max)
+      len = max;
+    BufferWriteBlock(df_BufferNum,df_BufferIdx,&df_Ring[tail],len);
+    df_BufferIdx += len;
+    max -= len;
+    tail = (tail + len) & (DF_RING_SIZE - 1);
+    df_Ring_Tail = tail;
+    }
+}
 
-      if (df_BufferNum==1)  // Change buffer to continue writing...
-        df_BufferNum=2;
+// The timer process: the next bytes of the ring go to the chip, unless
+// the main loop is using it
+void DataFlash_APM1::RingTimer(void)
+{
+  DataFlash_APM1 *df = ring_writer;
+
+  if (df->df_Ring_On && !df->df_Ring_Hold)
+    df->RingDrain(DF_DRAIN_BYTES,0);
+}
+
+// Between SyncWrite(true) and SyncWrite(false) WriteByte() goes
+// straight to the chip, waiting on it as it needs to, with the timer
+// process held off. For bursts bigger than the ring, such as the format
+// records at the start of a log.
+void DataFlash_APM1::SyncWrite(bool on)
+{
+  if (on)
+    {
+    df_Ring_Hold=1;
+    RingDrain(DF_RING_SIZE,1);	// what is in the ring goes first
+    }
+  else
+    df_Ring_Hold=0;
+}
+
+void DataFlash_APM1::WriteByte(byte data)
+{
+  uint8_t next;
+
+  if (!df_Stop_Write)
+    {
+    if (df_Ring_On && !df_Ring_Hold)
+      {
+      next = (df_Ring_Head + 1) & (DF_RING_SIZE - 1);
+      if (next == df_Ring_Tail)  // Ring full?
+        df_Dropped++;
       else
-        df_BufferNum=1;
-      // We are starting a new page - write FileNumber and FilePage
-		BufferWrite(df_BufferNum,0,df_FileNumber>>8);   // High byte
-		BufferWrite(df_BufferNum,1,df_FileNumber&0xFF); // Low byte
-		df_FilePage++;
-		BufferWrite(df_BufferNum,2,df_FilePage>>8);   // High byte
-		BufferWrite(df_BufferNum,3,df_FilePage&0xFF); // Low byte
+        {
+        df_Ring[df_Ring_Head] = data;
+        df_Ring_Head = next;
+        }
+      return;
       }
+    if (df_BufferIdx >= df_PageSize)  // End of buffer?
+      {
+      WaitReady();
+      NextPage();
+      }
+    BufferWrite(df_BufferNum,df_BufferIdx,data);
+    df_BufferIdx++;
     }
 }
 
@@ -206,14 +362,25 @@ int16_t DataFlash_APM1::GetWritePage()
   return(df_PageAdr);
 }
 
+// Get the number of bytes dropped because the ring was full
+uint16_t DataFlash_APM1::GetDropped()
+{
+  return(df_Dropped);
+}
+
 // Get the last page read
 int16_t DataFlash_APM1::GetPage()
 {
   return(df_Read_PageAdr-1);
 }
 
-void DataFlash_APM1::StartRead(int16_t PageAdr)
+// Start reading at PageAdr. The read shares the chip, and its buffer 1,
+// with the writer, so it is refused while a log is being written:
+// StopWrite() first, when it is safe to end the log
+bool DataFlash_APM1::StartRead(int16_t PageAdr)
 {
+  if (!df_Stop_Write)
+    return false;
   df_Read_BufferNum=1;
   df_Read_BufferIdx=4;
   df_Read_PageAdr=PageAdr;
@@ -229,6 +396,7 @@ void DataFlash_APM1::StartRead(int16_t PageAdr)
 //Serial.println(df_FileNumber, DEC);	Serial.print("\t");
 		df_FilePage = BufferRead(df_Read_BufferNum,2);   // High byte
 		df_FilePage = (df_FilePage<<8) | BufferRead(df_Read_BufferNum,3); // Low byte
+  return true;
 }
 
 byte DataFlash_APM1::ReadByte()
@@ -42,13 +42,14 @@
 #include <sys/ioctl.h>
 #include <sys/types.h> 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include "desktop.h"
 #include "util.h"
 
 #define LISTEN_BASE_PORT 5760
-#define BUFFER_SIZE 128
+#define BUFFER_SIZE 1024U
 
     
 #if   defined(UDR3)
@@ -92,7 +93,7 @@ static void tcp_start_connection(unsigned int serial_port, bool wait_for_connect
 #ifdef HAVE_SOCK_SIN_LEN
 	sockaddr.sin_len = sizeof(sockaddr);
 #endif
-	sockaddr.sin_port = htons(LISTEN_BASE_PORT+serial_port);
+	sockaddr.sin_port = htons(SITL_PORT(LISTEN_BASE_PORT+serial_port));
 	sockaddr.sin_family = AF_INET;
 
 	s->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
@@ -118,7 +119,7 @@ static void tcp_start_connection(unsigned int serial_port, bool wait_for_connect
         exit(1);
 	}
 
-	printf("Serial port %u on TCP port %u\n", serial_port, LISTEN_BASE_PORT+serial_port);
+	printf("Serial port %u on TCP port %u\n", serial_port, SITL_PORT(LISTEN_BASE_PORT+serial_port));
 	fflush(stdout);
 
 	if (wait_for_connection) {
@@ -186,6 +187,142 @@ static void check_connection(struct tcp_state *s)
 FastSerial::Buffer __FastSerial__rxBuffer[FS_MAX_PORTS];
 FastSerial::Buffer __FastSerial__txBuffer[FS_MAX_PORTS];
 
+
+/*
+  the socket has reached EOF or failed
+ */
+static void close_connection(struct tcp_state *s)
+{
+	close(s->fd);
+	s->connected = false;
+	fprintf(stdout, "Closed connection on serial port %u\n", s->serial_port);
+	fflush(stdout);
+}
+
+/*
+  true if a failed send or recv only means the socket has no room or
+  no data right now
+ */
+static bool would_block(int err)
+{
+#if EAGAIN != EWOULDBLOCK
+	if (err == EWOULDBLOCK) {
+		return true;
+	}
+#endif
+	return err == EAGAIN;
+}
+
+/*
+  push as much of the tx ring as the socket will take, using a single
+  sendmsg() for the (up to two) contiguous pieces of the ring
+ */
+static void serial_flush(uint8_t port)
+{
+	struct tcp_state *s = &tcp_state[port];
+	FastSerial::Buffer *b = &__FastSerial__txBuffer[port];
+	struct iovec iov[2];
+	struct msghdr msg;
+	int flags = MSG_NOSIGNAL;
+	uint16_t head = b->head;
+	ssize_t n;
+
+	if (head == b->tail) {
+		return;
+	}
+	if (s->serial_port == 1) {
+		// the GPS is a one way pipe, it can't take our output
+		b->tail = head;
+		return;
+	}
+	check_connection(s);
+	if (!s->connected) {
+		// nobody is listening, throw it away like a real UART would
+		b->tail = head;
+		return;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	iov[0].iov_base = &b->bytes[b->tail];
+	if (head > b->tail) {
+		iov[0].iov_len = head - b->tail;
+		msg.msg_iovlen = 1;
+	} else {
+		iov[0].iov_len = (b->mask + 1) - b->tail;
+		iov[1].iov_base = &b->bytes[0];
+		iov[1].iov_len = head;
+		msg.msg_iovlen = head?2:1;
+	}
+
+	if (!desktop_state.slider) {
+		flags |= MSG_DONTWAIT;
+	}
+	n = sendmsg(s->fd, &msg, flags);
+	if (n > 0) {
+		b->tail = (b->tail + n) & b->mask;
+	} else if (n == -1 && !would_block(errno)) {
+		close_connection(s);
+		b->tail = head;
+	}
+}
+
+/*
+  flush any pending output, then fill the rx ring with whatever the
+  socket has waiting in a single recv()
+ */
+static void serial_update(uint8_t port)
+{
+	struct tcp_state *s = &tcp_state[port];
+	FastSerial::Buffer *b = &__FastSerial__rxBuffer[port];
+	uint16_t head = b->head;
+	uint16_t space;
+	ssize_t n;
+
+	if (b->bytes == NULL) {
+		// port not open yet
+		return;
+	}
+
+	// flush before we look for input, so anything waiting on a
+	// reply has actually been sent
+	serial_flush(port);
+
+	check_connection(s);
+	if (!s->connected) {
+		return;
+	}
+
+	// free contiguous space from the head, leaving one byte so a
+	// full ring isn't mistaken for an empty one
+	if (head >= b->tail) {
+		space = (b->mask + 1) - head;
+		if (b->tail == 0) {
+			space--;
+		}
+	} else {
+		space = b->tail - head - 1;
+	}
+	if (space == 0) {
+		return;
+	}
+
+	if (s->serial_port == 1) {
+		n = sitl_gps_read(s->fd, &b->bytes[head], space);
+		if (n > 0) {
+			b->head = (head + n) & b->mask;
+		}
+		return;
+	}
+
+	n = recv(s->fd, &b->bytes[head], space, MSG_DONTWAIT | MSG_NOSIGNAL);
+	if (n > 0) {
+		b->head = (head + n) & b->mask;
+	} else if (n == 0 || (n == -1 && !would_block(errno))) {
+		close_connection(s);
+	}
+}
+
 // Constructor /////////////////////////////////////////////////////////////////
 
 FastSerial::FastSerial(const uint8_t portNumber, volatile uint8_t *ubrrh, volatile uint8_t *ubrrl,
@@ -207,6 +344,20 @@ FastSerial::FastSerial(const uint8_t portNumber, volatile uint8_t *ubrrh, volati
 
 void FastSerial::begin(long baud)
 {
+	begin(baud, 0, 0);
+}
+
+void FastSerial::begin(long baud, unsigned int rxSpace, unsigned int txSpace)
+{
+	// the ring buffers are only allocated once, the desktop has
+	// plenty of memory so we don't bother shrinking them again
+	if (_rxBuffer->bytes == NULL) {
+		_allocBuffer(_rxBuffer, rxSpace);
+	}
+	if (_txBuffer->bytes == NULL) {
+		_allocBuffer(_txBuffer, txSpace);
+	}
+
 	switch (_u2x) {
 	case 0:
 		tcp_start_connection(_u2x, true);
@@ -225,117 +376,149 @@ void FastSerial::begin(long baud)
 	}
 }
 
-void FastSerial::begin(long baud, unsigned int rxSpace, unsigned int txSpace)
-{
-	begin(baud);
-}
-
 void FastSerial::end()
 {
 }
 
 int FastSerial::available(void)
 {
-	struct tcp_state *s = &tcp_state[_u2x];
-
-	check_connection(s);
-
-	if (!s->connected) {
-		return 0;
+	if (_rxBuffer->head == _rxBuffer->tail) {
+		// nothing buffered, see if the socket has anything for us
+		serial_update(_u2x);
 	}
-
-	if (select_check(s->fd)) {
-#ifdef FIONREAD
-		// use FIONREAD to get exact value if possible
-		int num_ready;
-		if (ioctl(s->fd, FIONREAD, &num_ready) == 0) {
-			if (num_ready > BUFFER_SIZE) {
-				return BUFFER_SIZE;
-			}
-			if (num_ready == 0) {
-				// EOF is reached
-				fprintf(stdout, "Closed connection on serial port %u\n", s->serial_port);
-				close(s->fd);
-				s->connected = false;
-				return 0;
-			}
-			return num_ready;
-		}
-#endif
-		return 1; // best we can do is say 1 byte available
-	}
-	return 0;
+	return ((_rxBuffer->head - _rxBuffer->tail) & _rxBuffer->mask);
 }
 
 int FastSerial::txspace(void)
 {
-	// always claim there is space available
-	return BUFFER_SIZE;
+	return (_txBuffer->mask - ((_txBuffer->head - _txBuffer->tail) & _txBuffer->mask));
 }
 
 int FastSerial::read(void)
 {
-	struct tcp_state *s = &tcp_state[_u2x];
-	char c;
+	uint8_t c;
 
 	if (available() <= 0) {
 		return -1;
 	}
 
-	if (s->serial_port == 1) {
-		if (sitl_gps_read(s->fd, &c, 1) == 1) {
-			return (uint8_t)c;
-		}
+	c = _rxBuffer->bytes[_rxBuffer->tail];
+	_rxBuffer->tail = (_rxBuffer->tail + 1) & _rxBuffer->mask;
+	return c;
+}
+
+int FastSerial::peek(void)
+{
+	if (available() <= 0) {
 		return -1;
 	}
+	return _rxBuffer->bytes[_rxBuffer->tail];
+}
 
-    int n = recv(s->fd, &c, 1, MSG_DONTWAIT | MSG_NOSIGNAL);
-	if (n <= 0) {
-		// the socket has reached EOF
-		close(s->fd);
-		s->connected = false;
-		fprintf(stdout, "Closed connection on serial port %u\n", s->serial_port);
-		fflush(stdout);
-		return -1;
+void FastSerial::flush(void)
+{
+	_rxBuffer->head = _rxBuffer->tail;
+}
+
+void FastSerial::write(uint8_t c)
+{
+	uint16_t i;
+
+	i = (_txBuffer->head + 1) & _txBuffer->mask;
+	if (i == _txBuffer->tail) {
+		// the ring is full, try to push some of it out now
+		serial_flush(_u2x);
+		if (i == _txBuffer->tail) {
+			// the socket can't take any more, drop the byte
+			return;
+		}
 	}
-    if (n == 1) {
-		return (uint8_t)c;
+
+	_txBuffer->bytes[_txBuffer->head] = c;
+	_txBuffer->head = i;
+	if (!desktop_state.running) {
+		// nothing flushes the ring until loop() is running, so
+		// write setup() output straight through
+		serial_flush(_u2x);
 	}
-	return -1;
 }
 
-int FastSerial::peek(void)
+uint8_t *FastSerial::tx_reserve(uint16_t len, uint16_t *contig, uint8_t **wrap)
 {
-	return -1;
+	uint16_t space;
+
+	if (_txBuffer->bytes == NULL) {
+		return NULL;
+	}
+	space = txspace();
+	if (len > space) {
+		// make room by pushing what we have out to the socket
+		serial_flush(_u2x);
+		space = txspace();
+		if (len > space) {
+			return NULL;
+		}
+	}
+
+	*contig = (_txBuffer->mask + 1) - _txBuffer->head;
+	*wrap = _txBuffer->bytes;
+	return &_txBuffer->bytes[_txBuffer->head];
 }
 
-void FastSerial::flush(void)
+void FastSerial::tx_commit(uint16_t len)
 {
+	_txBuffer->head = (_txBuffer->head + len) & _txBuffer->mask;
+	if (!desktop_state.running) {
+		serial_flush(_u2x);
+	}
 }
 
-void FastSerial::write(uint8_t c)
+const uint8_t *FastSerial::rx_peek(uint16_t *len)
 {
-	struct tcp_state *s = &tcp_state[_u2x];
-	int flags = MSG_NOSIGNAL;
-	check_connection(s);
-	if (!s->connected) {
-		return;
+	*len = 0;
+	if (_rxBuffer->bytes == NULL) {
+		return NULL;
 	}
-	if (!desktop_state.slider) {
-		flags |= MSG_DONTWAIT;
+	// refill from the socket if we have nothing buffered
+	available();
+	if (_rxBuffer->head >= _rxBuffer->tail) {
+		*len = _rxBuffer->head - _rxBuffer->tail;
+	} else {
+		*len = (_rxBuffer->mask + 1) - _rxBuffer->tail;
 	}
-	send(s->fd, &c, 1, flags);
+	return &_rxBuffer->bytes[_rxBuffer->tail];
+}
+
+void FastSerial::rx_consume(uint16_t len)
+{
+	_rxBuffer->tail = (_rxBuffer->tail + len) & _rxBuffer->mask;
 }
 
 // Buffer management ///////////////////////////////////////////////////////////
 
 bool FastSerial::_allocBuffer(Buffer *buffer, unsigned int size)
 {
-	return false;
+	uint8_t shift;
+
+	buffer->head = buffer->tail = 0;
+
+	// round up to a power of 2 so we can wrap with a mask
+	for (shift = 1; (1U << shift) < max(BUFFER_SIZE, size); shift++)
+		;
+	buffer->mask = (1 << shift) - 1;
+	buffer->bytes = (uint8_t *)malloc(buffer->mask + 1);
+
+	return (buffer->bytes != NULL);
 }
 
 void FastSerial::_freeBuffer(Buffer *buffer)
 {
+	buffer->head = buffer->tail = 0;
+	buffer->mask = 0;
+	if (NULL != buffer->bytes) {
+		free(buffer->bytes);
+		buffer->bytes = NULL;
+	}
 }
 
 /*
@@ -354,3 +537,17 @@ void desktop_serial_select_setup(fd_set *fds, int *fd_high)
 		}
 	}
 }
+
+/*
+  called once per main loop iteration. Sends everything the sketch
+  wrote during the loop and reads everything that has arrived, so
+  the sketch itself never has to make a syscall for serial I/O
+ */
+void desktop_serial_update(void)
+{
+	uint8_t i;
+
+	for (i=0; i<FS_MAX_PORTS; i++) {
+		serial_update(i);
+	}
+}
@@ -2,6 +2,7 @@
 #define _DESKTOP_H
 
 #include <unistd.h>
+#include <stdint.h>
 
 struct desktop_info {
 	bool slider; // slider switch state, True means CLI mode
@@ -9,13 +10,34 @@ struct desktop_info {
 	bool quadcopter; // use quadcopter outputs
 	unsigned framerate;
 	float initial_height;
+	bool virtual_clock; // time only advances when the SITL code steps it
+	bool lockstep; // step the virtual clock one simulator frame at a time
+	uint64_t virtual_usec; // current virtual time in microseconds
+	unsigned instance; // which of several copies running on one host this is
+	bool model; // use the built-in flight model, not an external simulator
+	bool running; // setup() has returned and loop() is being called
 };
 
+// Each instance uses the ports of instance 0 plus instance times
+// SITL_PORT_STRIDE, so up to SITL_MAX_INSTANCE + 1 of them can run at
+// once without the serial ports of one meeting the simulator ports of
+// another.
+#define SITL_PORT_STRIDE	10
+#define SITL_MAX_INSTANCE	25
+#define SITL_PORT(_p)		((_p) + desktop_state.instance * SITL_PORT_STRIDE)
+
 extern struct desktop_info desktop_state;
 
 void desktop_serial_select_setup(fd_set *fds, int *fd_high);
+void desktop_serial_update(void);
+#ifdef __cplusplus
+extern "C"
+#endif
+void desktop_eeprom_flush(void);
 void sitl_input(void);
 void sitl_setup(void);
+void sitl_step(void);
+void sitl_advance_time(uint32_t usec);
 int sitl_gps_pipe(void);
 ssize_t sitl_gps_read(int fd, void *buf, size_t count);
 void sitl_update_compass(float heading, float roll, float pitch, float yaw);
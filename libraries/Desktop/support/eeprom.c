@@ -1,87 +1,146 @@
+/*
+  EEPROM emulation for the desktop build
+
+  The whole EEPROM is shadowed in RAM. Reads are served from the
+  shadow, and writes only update the shadow and widen the dirty
+  range. The main loop calls desktop_eeprom_flush() to write the
+  dirty range back to eeprom.bin a bounded number of bytes at a time,
+  so a save_all or mission upload costs a handful of pwrite calls
+  rather than one per byte.
+ */
 #include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <stdint.h>
 
+#define EEPROM_SIZE 4096
+
+// most bytes written back to eeprom.bin per call to desktop_eeprom_flush()
+#define EEPROM_FLUSH_MAX 512
+
 static int eeprom_fd;
+static uint8_t eeprom[EEPROM_SIZE];
+
+// dirty range is [dirty_start, dirty_end), empty when start >= end
+static uint16_t dirty_start = EEPROM_SIZE;
+static uint16_t dirty_end;
+
+void desktop_eeprom_flush(void)
+{
+	uint16_t len;
+
+	if (dirty_start >= dirty_end) {
+		return;
+	}
+	len = dirty_end - dirty_start;
+	if (len > EEPROM_FLUSH_MAX) {
+		len = EEPROM_FLUSH_MAX;
+	}
+	pwrite(eeprom_fd, &eeprom[dirty_start], len, dirty_start);
+	dirty_start += len;
+	if (dirty_start >= dirty_end) {
+		dirty_start = EEPROM_SIZE;
+		dirty_end = 0;
+	}
+}
+
+/*
+  make sure nothing is lost on a clean exit
+ */
+static void eeprom_flush_all(void)
+{
+	while (dirty_start < dirty_end) {
+		desktop_eeprom_flush();
+	}
+}
 
 static void eeprom_open(void)
 {
 	if (eeprom_fd == 0) {
 		eeprom_fd = open("eeprom.bin", O_RDWR|O_CREAT, 0777);
-		ftruncate(eeprom_fd, 4096);
+		if (eeprom_fd == -1 || ftruncate(eeprom_fd, EEPROM_SIZE) != 0) {
+			perror("eeprom.bin");
+			exit(1);
+		}
+		if (pread(eeprom_fd, eeprom, EEPROM_SIZE, 0) != EEPROM_SIZE) {
+			perror("eeprom.bin");
+			exit(1);
+		}
+		atexit(eeprom_flush_all);
 	}
 }
 
-void eeprom_write_byte(uint8_t *p, uint8_t value)
+static void eeprom_write(intptr_t ofs, const void *buf, uint16_t size)
 {
-	intptr_t ofs = (intptr_t)p;
-	assert(ofs < 4096);
+	assert(ofs + size <= EEPROM_SIZE);
 	eeprom_open();
-	pwrite(eeprom_fd, &value, 1, ofs);
+	if (memcmp(&eeprom[ofs], buf, size) == 0) {
+		// unchanged, no need to write it back
+		return;
+	}
+	memcpy(&eeprom[ofs], buf, size);
+	if (ofs < dirty_start) {
+		dirty_start = ofs;
+	}
+	if (ofs + size > dirty_end) {
+		dirty_end = ofs + size;
+	}
+}
+
+static void eeprom_read(intptr_t ofs, void *buf, uint16_t size)
+{
+	assert(ofs + size <= EEPROM_SIZE);
+	eeprom_open();
+	memcpy(buf, &eeprom[ofs], size);
 }
 
+void eeprom_write_byte(uint8_t *p, uint8_t value)
+{
+	eeprom_write((intptr_t)p, &value, 1);
+}
 
 void eeprom_write_word(uint16_t *p, uint16_t value)
 {
-	intptr_t ofs = (intptr_t)p;
-	assert(ofs < 4096);
-	eeprom_open();
-	pwrite(eeprom_fd, &value, 2, ofs);
+	eeprom_write((intptr_t)p, &value, 2);
 }
 
-void eeprom_write_dword(uint16_t *p, uint32_t value)
+void eeprom_write_dword(uint32_t *p, uint32_t value)
 {
-	intptr_t ofs = (intptr_t)p;
-	assert(ofs < 4096);
-	eeprom_open();
-	pwrite(eeprom_fd, &value, 4, ofs);
+	eeprom_write((intptr_t)p, &value, 4);
 }
 
 uint8_t eeprom_read_byte(const uint8_t *p)
 {
-	intptr_t ofs = (intptr_t)p;
 	uint8_t value;
-	assert(ofs < 4096);
-	eeprom_open();
-	pread(eeprom_fd, &value, 1, ofs);
+	eeprom_read((intptr_t)p, &value, 1);
 	return value;
 }
 
 uint16_t eeprom_read_word(const uint16_t *p)
 {
-	intptr_t ofs = (intptr_t)p;
 	uint16_t value;
-	assert(ofs < 4096);
-	eeprom_open();
-	pread(eeprom_fd, &value, 2, ofs);
+	eeprom_read((intptr_t)p, &value, 2);
 	return value;
 }
 
 uint32_t eeprom_read_dword(const uint32_t *p)
 {
-	intptr_t ofs = (intptr_t)p;
 	uint32_t value;
-	assert(ofs < 4096);
-	eeprom_open();
-	pread(eeprom_fd, &value, 4, ofs);
+	eeprom_read((intptr_t)p, &value, 4);
 	return value;
 }
 
 void eeprom_read_block(void *buf, void *ptr, uint8_t size)
 {
-	intptr_t ofs = (intptr_t)ptr;
-	assert(ofs < 4096);
-	eeprom_open();
-	pread(eeprom_fd, buf, size, ofs);
+	eeprom_read((intptr_t)ptr, buf, size);
 }
 
 void eeprom_write_block(const void *buf, void *ptr, uint8_t size)
 {
-	intptr_t ofs = (intptr_t)ptr;
-	assert(ofs < 4096);
-	eeprom_open();
-	pwrite(eeprom_fd, buf, size, ofs);
+	eeprom_write((intptr_t)ptr, buf, size);
 }
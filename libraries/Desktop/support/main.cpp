@@ -7,7 +7,10 @@
 #include <getopt.h>
 #include <signal.h>
 #include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
 #include "desktop.h"
+#include "sitl_model.h"
 
 void setup(void);
 void loop(void);
@@ -22,23 +25,52 @@ static void usage(void)
 	printf("\t-w          wipe eeprom and dataflash\n");
 	printf("\t-r RATE     set SITL framerate\n");
 	printf("\t-H HEIGHT   initial barometric height\n");
+	printf("\t-T          run on a virtual clock, as fast as possible\n");
+	printf("\t-L          lockstep virtual clock with simulator frames\n");
+	printf("\t-I N        run as instance N (0-%u), with its own ports and\n", SITL_MAX_INSTANCE);
+	printf("\t            its eeprom and dataflash in the directory instanceN\n");
+	printf("\t-M MODEL    fly the built-in flight model MODEL, one of\n");
+	printf("\t            %s\n", sitl_model_names());
+	printf("\t-O HOME     start the model at HOME, as LAT,LON,ALT,HEADING\n");
+}
+
+/*
+  move into the directory of this instance, so that the files the
+  sketch keeps (eeprom.bin, dataflash.bin) are its own
+ */
+static void instance_dir(void)
+{
+	char dir[20];
+
+	snprintf(dir, sizeof(dir), "instance%u", desktop_state.instance);
+	if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+		perror(dir);
+		exit(1);
+	}
+	if (chdir(dir) != 0) {
+		perror(dir);
+		exit(1);
+	}
+	printf("Instance %u in %s, ports offset by %u\n", desktop_state.instance, dir,
+		   desktop_state.instance * SITL_PORT_STRIDE);
 }
 
 int main(int argc, char * const argv[])
 {
 	int opt;
+	bool wipe = false;
+	bool have_instance = false;
 	// default state
 	desktop_state.slider = false;
 	gettimeofday(&desktop_state.sketch_start_time, NULL);
 
-	while ((opt = getopt(argc, argv, "swhr:H:")) != -1) {
+	while ((opt = getopt(argc, argv, "swhr:H:TLI:M:O:")) != -1) {
 		switch (opt) {
 		case 's':
 			desktop_state.slider = true;
 			break;
 		case 'w':
-			unlink("eeprom.bin");
-			unlink("dataflash.bin");
+			wipe = true;
 			break;
 		case 'r':
 			desktop_state.framerate = (unsigned)atoi(optarg);
@@ -46,12 +78,48 @@ int main(int argc, char * const argv[])
 		case 'H':
 			desktop_state.initial_height = atof(optarg);
 			break;
+		case 'T':
+			desktop_state.virtual_clock = true;
+			break;
+		case 'L':
+			desktop_state.virtual_clock = true;
+			desktop_state.lockstep = true;
+			break;
+		case 'I':
+			desktop_state.instance = (unsigned)atoi(optarg);
+			if (desktop_state.instance > SITL_MAX_INSTANCE) {
+				usage();
+				exit(1);
+			}
+			have_instance = true;
+			break;
+		case 'M':
+			if (!sitl_model_select(optarg)) {
+				usage();
+				exit(1);
+			}
+			desktop_state.model = true;
+			break;
+		case 'O':
+			if (!sitl_model_home(optarg)) {
+				usage();
+				exit(1);
+			}
+			break;
 		default:
 			usage();
 			exit(1);
 		}
 	}
 
+	if (have_instance) {
+		instance_dir();
+	}
+	if (wipe) {
+		unlink("eeprom.bin");
+		unlink("dataflash.bin");
+	}
+
 	if (strcmp(SKETCH, "ArduCopter") == 0) {
 		desktop_state.quadcopter = true;
 		if (desktop_state.framerate == 0) {
@@ -65,6 +133,7 @@ int main(int argc, char * const argv[])
 
 	sitl_setup();
 	setup();
+	desktop_state.running = true;
 
 	while (true) {
 		struct timeval tv;
@@ -73,6 +142,14 @@ int main(int argc, char * const argv[])
 
 		FD_ZERO(&fds);
 		loop();
+		desktop_serial_update();
+		desktop_eeprom_flush();
+
+		if (desktop_state.virtual_clock) {
+			// don't sleep, just move time on
+			sitl_step();
+			continue;
+		}
 
 		desktop_serial_select_setup(&fds, &fd_high);
 		tv.tv_sec = 0;
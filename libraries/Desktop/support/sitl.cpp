@@ -28,6 +28,7 @@
 #include <AP_TimerAperiodicProcess.h>
 #include "sitl_adc.h"
 #include "sitl_rc.h"
+#include "sitl_model.h"
 #include "desktop.h"
 #include "util.h"
 
@@ -66,7 +67,7 @@ static void setup_fgear(void)
 #ifdef HAVE_SOCK_SIN_LEN
 	sockaddr.sin_len = sizeof(sockaddr);
 #endif
-	sockaddr.sin_port = htons(FGIN_PORT);
+	sockaddr.sin_port = htons(SITL_PORT(FGIN_PORT));
 	sockaddr.sin_family = AF_INET;
 
 	sitl_fd = socket(AF_INET, SOCK_DGRAM, 0);
@@ -117,6 +118,11 @@ static void sitl_fgear_input(void)
 		static uint32_t last_report;
 		static uint32_t count;
 
+		if (desktop_state.model) {
+			// the built-in model owns the state
+			return;
+		}
+
 		/* sigh, its big-endian */
 		swap_doubles(&d.fg_pkt.latitude, 16);
 		d.fg_pkt.magic = ntohl(d.fg_pkt.magic);
@@ -202,6 +208,37 @@ static void sitl_plane_output(uint16_t pwm[8])
 }
 
 
+/*
+  step the built-in flight model with the RC outputs, and take the
+  new state from it as though a simulator had sent it
+ */
+static void sitl_model_output(uint16_t pwm[8])
+{
+	static uint32_t last_step;
+	struct sitl_fdm fdm;
+	float delta_t;
+
+	delta_t = (millis() - last_step) * 0.001;
+	last_step = millis();
+	if (delta_t > 0.1) {
+		// don't take one big step after a stall
+		delta_t = 0.1;
+	}
+	sitl_model_update(pwm, delta_t, &fdm);
+
+	sim_state.latitude = fdm.latitude;
+	sim_state.longitude = fdm.longitude;
+	sim_state.altitude = fdm.altitude;
+	sim_state.speedN = fdm.speedN;
+	sim_state.speedE = fdm.speedE;
+	sim_state.roll = fdm.roll;
+	sim_state.pitch = fdm.pitch;
+	sim_state.yaw = fdm.yaw;
+	sim_state.heading = fdm.heading;
+	sim_state.airspeed = fdm.airspeed;
+	sim_state.update_count++;
+}
+
 /*
   send RC outputs to simulator for a quadcopter
  */
@@ -240,7 +277,9 @@ static void sitl_simulator_output(void)
 		pwm[i] = (*reg[i])/2;
 	}
 
-	if (desktop_state.quadcopter) {
+	if (desktop_state.model) {
+		sitl_model_output(pwm);
+	} else if (desktop_state.quadcopter) {
 		sitl_quadcopter_output(pwm);
 	} else {
 		sitl_plane_output(pwm);
@@ -263,7 +302,8 @@ static void timer_handler(int signum)
 	/* check for packet from flight sim */
 	sitl_fgear_input();
 
-	// trigger all timers
+	// trigger all timers. This runs the whole chain of registered
+	// processes, each at its own rate divider, just as Timer2 does
 	timer_scheduler.run();
 
 	// trigger RC input
@@ -293,6 +333,82 @@ static void timer_handler(int signum)
 }
 
 
+/*
+  advance the virtual clock by usec microseconds, calling the timer
+  handler once for every 1ms tick boundary that is crossed
+ */
+void sitl_advance_time(uint32_t usec)
+{
+	static bool in_timer;
+
+	while (usec > 0) {
+		uint32_t step = 1000 - (desktop_state.virtual_usec % 1000);
+		if (step > usec) {
+			step = usec;
+		}
+		desktop_state.virtual_usec += step;
+		usec -= step;
+		if ((desktop_state.virtual_usec % 1000) == 0 && !in_timer) {
+			// don't recurse if a driver delays from within the timer
+			in_timer = true;
+			timer_handler(0);
+			in_timer = false;
+		}
+	}
+}
+
+/*
+  wait for the flight simulator to send its next frame. We give up
+  after a second so a stalled or missing simulator can't hang us
+ */
+static void sitl_wait_frame(void)
+{
+	uint32_t update_count = sim_state.update_count;
+	struct timeval start, now;
+
+	gettimeofday(&start, NULL);
+	while (sim_state.update_count == update_count) {
+		struct timeval tv;
+		fd_set fds;
+
+		FD_ZERO(&fds);
+		FD_SET(sitl_fd, &fds);
+		tv.tv_sec = 0;
+		tv.tv_usec = 10000;
+		if (select(sitl_fd+1, &fds, NULL, NULL, &tv) == 1) {
+			sitl_fgear_input();
+		}
+		gettimeofday(&now, NULL);
+		if (now.tv_sec - start.tv_sec > 1) {
+			printf("SITL: no frame from simulator, continuing\n");
+			return;
+		}
+	}
+}
+
+/*
+  called from the main loop between calls to loop() when running on
+  the virtual clock. Each call moves time on by one timer tick. In
+  lockstep mode we also hold the clock at each frame boundary until
+  the simulator has sent its next frame, so the simulation runs as
+  fast as the simulator can step, and gives the same result every
+  time. The built-in model is stepped from the timer, so it is always
+  in step already
+ */
+void sitl_step(void)
+{
+	static uint64_t next_frame_usec;
+
+	if (desktop_state.lockstep && !desktop_state.model &&
+	    sim_state.update_count != 0 &&
+	    desktop_state.virtual_usec >= next_frame_usec) {
+		sitl_wait_frame();
+		next_frame_usec = desktop_state.virtual_usec + 1000000UL/desktop_state.framerate;
+	}
+	sitl_advance_time(1000);
+}
+
+
 /*
   setup a timer used to prod the ISRs
  */
@@ -323,10 +439,13 @@ void sitl_setup(void)
 	parent_pid = getppid();
 
 	fgout_addr.sin_family = AF_INET;
-	fgout_addr.sin_port = htons(FGOUT_PORT);
+	fgout_addr.sin_port = htons(SITL_PORT(FGOUT_PORT));
 	inet_pton(AF_INET, "127.0.0.1", &fgout_addr.sin_addr);
 
-	setup_timer();
+	if (!desktop_state.virtual_clock) {
+		// with a virtual clock the main loop drives the timers
+		setup_timer();
+	}
 	setup_fgear();
 	sitl_setup_adc();
 	printf("Starting SITL input\n");
@@ -336,4 +455,11 @@ void sitl_setup(void)
 	sitl_update_adc(0, 0, 0, 0);
 	sitl_update_compass(0, 0, 0, 0);
 	sitl_update_gps(0, 0, 0, 0, 0, false);
+
+	if (desktop_state.model) {
+		struct sitl_fdm fdm;
+		sitl_model_reset(&fdm);
+		sitl_update_barometer(fdm.altitude);
+		printf("Using the built-in flight model\n");
+	}
 }
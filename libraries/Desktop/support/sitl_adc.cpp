@@ -129,7 +129,7 @@ void sitl_update_adc(float roll, float pitch, float yaw, float airspeed)
 	printf("dt=%5u adc[2]=%6.1f roll=%6.1f / %6.1f yaw=%6.1f / %6.1f  yawRate=%6.3f / %6.3f\n",
 	       (unsigned)delta_t,
 	       adc[2],
-	       roll, dcm.roll_sensor/100.0, yaw, dcm.yaw_sensor/100.0, yawRate, ToDeg(omega.z));
+	       roll, dcm.roll_sensor()/100.0, yaw, dcm.yaw_sensor()/100.0, yawRate, ToDeg(omega.z));
 #endif
 }
 
@@ -0,0 +1,337 @@
+/*
+  SITL handling
+
+  A built-in flight dynamics model, so SITL can run without FlightGear
+  or a simulator script on the other end of a socket. It is stepped
+  from the SITL timer with the PWM outputs, and gives back the same
+  state the simulator packets do, so the sensor emulation doesn't know
+  the difference.
+
+  There are rigid body models of quad and hexa copters, with the
+  motors where ArduCopter's motors_*.pde expect them, and a simple
+  aerodynamic model of a small plane. The plane takes its controls the
+  way the FlightGear Rascal does (aileron, elevator, throttle, rudder
+  on channels 1 to 4, up elevator below 1500), so the autotest
+  parameters work with either.
+
+  The models are deliberately simple. They are meant to be stable,
+  cheap and repeatable, not accurate.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <AP_Math.h>
+#include "wiring.h"
+#include "sitl_model.h"
+#include "util.h"
+
+#define GRAVITY			9.80665
+#define RHO				1.225		// air density, kg/m^3
+#define DEG_TO_M		111319.5	// meters per degree of latitude
+#define ToRad(x)		((x)*0.01745329252)
+#define ToDeg(x)		((x)*57.2957795131)
+
+enum model_kind {
+	MODEL_MULTICOPTER,
+	MODEL_PLANE
+};
+
+struct motor {
+	uint8_t	channel;	// PWM output, 0 based
+	float	angle;		// degrees clockwise from the nose
+	int8_t	yaw;		// 1 for a counter clockwise prop, -1 for clockwise
+};
+
+static const struct model {
+	const char			*name;
+	enum model_kind		kind;
+	uint8_t				num_motors;
+	struct motor		motors[6];
+} models[] = {
+	{ "quad",   MODEL_MULTICOPTER, 4, {
+			{ 0,   90,  1 }, { 1,  -90,  1 }, { 2,    0, -1 }, { 3,  180, -1 } } },
+	{ "quad-x", MODEL_MULTICOPTER, 4, {
+			{ 0,   45,  1 }, { 1, -135,  1 }, { 2,  -45, -1 }, { 3,  135, -1 } } },
+	{ "hexa",   MODEL_MULTICOPTER, 6, {
+			{ 0,    0, -1 }, { 6,  -60,  1 }, { 3,   60,  1 },
+			{ 1,  180,  1 }, { 2, -120, -1 }, { 7,  120, -1 } } },
+	{ "hexa-x", MODEL_MULTICOPTER, 6, {
+			{ 1,  -90,  1 }, { 2,  -30, -1 }, { 7, -150, -1 },
+			{ 0,   90, -1 }, { 6,   30,  1 }, { 3,  150,  1 } } },
+	{ "plane",  MODEL_PLANE, 0 }
+};
+
+// multicopter airframe
+#define COPTER_MASS			1.5		// kg
+#define COPTER_ARM			0.25	// motor distance from the centre, m
+#define COPTER_HOVER		0.5		// throttle to hover
+#define COPTER_YAW_FACTOR	0.05	// yaw torque per newton of thrust, m
+#define COPTER_IXX			0.02	// moments of inertia, kg m^2
+#define COPTER_IYY			0.02
+#define COPTER_IZZ			0.04
+#define COPTER_ROT_DRAG		2.0		// angular rate damping, 1/s
+#define COPTER_LIN_DRAG		0.3		// velocity damping, 1/s
+
+// plane airframe. The moment coefficients give angular
+// accelerations directly, per unit of dynamic pressure
+#define PLANE_MASS			2.0		// kg
+#define PLANE_AREA			0.4		// wing area, m^2
+#define PLANE_THRUST		8.0	// full throttle, N
+#define PLANE_CL0			0.2
+#define PLANE_CLA			5.0		// lift slope, per radian
+#define PLANE_STALL			0.26	// stalling angle of attack, radians
+#define PLANE_CD0			0.03
+#define PLANE_CDI			0.05	// induced drag factor
+#define PLANE_CYB			0.5		// side force slope, per radian
+#define PLANE_AIL			0.02
+#define PLANE_ELEV			0.02
+#define PLANE_RUD			0.01
+#define PLANE_ALPHA			0.1		// pitch stability
+#define PLANE_BETA			0.05	// weathercock stability
+#define PLANE_DIHEDRAL		0.02
+#define PLANE_DAMP			0.02	// rate damping
+#define PLANE_ROLLING		0.05	// wheel drag on the ground, 1/s
+
+static const struct model *model = &models[0];
+
+// the starting point; the autotest home by default
+static double home_lat = -35.362938;
+static double home_lon = 149.165085;
+static double home_alt = 584;
+static double home_heading = 270;
+
+// position relative to home and velocity, both north, east, down
+static Vector3f position;
+static Vector3f velocity;
+// body rates, radians/second
+static Vector3f omega;
+// rotation from body to earth frame
+static Matrix3f dcm;
+
+bool sitl_model_select(const char *name)
+{
+	for (uint8_t i=0; i<sizeof(models)/sizeof(models[0]); i++) {
+		if (strcmp(name, models[i].name) == 0) {
+			model = &models[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *sitl_model_names(void)
+{
+	return "quad, quad-x, hexa, hexa-x or plane";
+}
+
+bool sitl_model_home(const char *home)
+{
+	double lat, lon, alt, heading;
+
+	if (sscanf(home, "%lf,%lf,%lf,%lf", &lat, &lon, &alt, &heading) != 4) {
+		return false;
+	}
+	home_lat = lat;
+	home_lon = lon;
+	home_alt = alt;
+	home_heading = heading;
+	return true;
+}
+
+static void dcm_from_euler(float roll, float pitch, float yaw)
+{
+	float cr = cos(roll), sr = sin(roll);
+	float cp = cos(pitch), sp = sin(pitch);
+	float cy = cos(yaw), sy = sin(yaw);
+
+	dcm.a = Vector3f(cp*cy, sr*sp*cy - cr*sy, cr*sp*cy + sr*sy);
+	dcm.b = Vector3f(cp*sy, sr*sp*sy + cr*cy, cr*sp*sy - sr*cy);
+	dcm.c = Vector3f(-sp,   sr*cp,            cr*cp);
+}
+
+static void dcm_to_euler(float *roll, float *pitch, float *yaw)
+{
+	*roll = atan2(dcm.c.y, dcm.c.z);
+	*pitch = -asin(constrain(dcm.c.x, -1.0, 1.0));
+	*yaw = atan2(dcm.b.x, dcm.a.x);
+}
+
+/*
+  keep the rotation matrix orthonormal, the same way AP_DCM does
+ */
+static void dcm_normalize(void)
+{
+	float error = dcm.a * dcm.b;
+	Vector3f t0 = dcm.a - (dcm.b * (0.5f * error));
+	Vector3f t1 = dcm.b - (dcm.a * (0.5f * error));
+	Vector3f t2 = t0 % t1;
+
+	dcm.a = t0 / t0.length();
+	dcm.b = t1 / t1.length();
+	dcm.c = t2 / t2.length();
+}
+
+static void fill_fdm(struct sitl_fdm *fdm)
+{
+	float roll, pitch, yaw;
+
+	dcm_to_euler(&roll, &pitch, &yaw);
+	fdm->latitude  = home_lat + position.x / DEG_TO_M;
+	fdm->longitude = home_lon + position.y / (DEG_TO_M * cos(ToRad(home_lat)));
+	fdm->altitude  = home_alt - position.z;
+	fdm->speedN    = velocity.x;
+	fdm->speedE    = velocity.y;
+	fdm->roll      = ToDeg(roll);
+	fdm->pitch     = ToDeg(pitch);
+	fdm->yaw       = normalise(ToDeg(yaw), 0, 360);
+	fdm->heading   = fdm->yaw;
+	fdm->airspeed  = velocity.length();
+}
+
+void sitl_model_reset(struct sitl_fdm *fdm)
+{
+	position = Vector3f(0, 0, 0);
+	velocity = Vector3f(0, 0, 0);
+	omega = Vector3f(0, 0, 0);
+	dcm_from_euler(0, 0, ToRad(home_heading));
+	fill_fdm(fdm);
+}
+
+/*
+  the thrust and torques of the motors. Thrust grows linearly from
+  1000 to 2000 PWM
+ */
+static void multicopter_forces(const uint16_t pwm[8], Vector3f &force, Vector3f &torque)
+{
+	float motor_thrust = COPTER_MASS * GRAVITY / (model->num_motors * COPTER_HOVER);
+	float thrust = 0;
+
+	torque = Vector3f(0, 0, 0);
+	for (uint8_t i=0; i<model->num_motors; i++) {
+		const struct motor *m = &model->motors[i];
+		float t = constrain((pwm[m->channel] - 1000) / 1000.0, 0, 1) * motor_thrust;
+		float px = COPTER_ARM * cos(ToRad(m->angle));
+		float py = COPTER_ARM * sin(ToRad(m->angle));
+
+		// r x F with F = (0, 0, -t), plus the reaction of the prop
+		torque.x += -py * t;
+		torque.y +=  px * t;
+		torque.z += m->yaw * COPTER_YAW_FACTOR * t;
+		thrust += t;
+	}
+	force = Vector3f(0, 0, -thrust);
+	torque.x /= COPTER_IXX;
+	torque.y /= COPTER_IYY;
+	torque.z /= COPTER_IZZ;
+	torque -= omega * COPTER_ROT_DRAG;
+}
+
+/*
+  lift, drag and thrust in body axes, and the angular accelerations
+  from the control surfaces and the stability of the airframe
+ */
+static void plane_forces(const uint16_t pwm[8], Vector3f &force, Vector3f &torque)
+{
+	Vector3f air = dcm.mul_transpose(velocity);
+	float speed = air.length();
+	float alpha = 0, beta = 0, cl;
+	float qbar = 0.5 * RHO * speed * speed;
+	float aileron  = constrain((pwm[0] - 1500) / 500.0, -1, 1);
+	float elevator = constrain((pwm[1] - 1500) / 500.0, -1, 1);
+	float throttle = constrain((pwm[2] - 1000) / 1000.0, 0, 1);
+	float rudder   = constrain((pwm[3] - 1500) / 500.0, -1, 1);
+
+	if (speed > 1) {
+		alpha = atan2(air.z, air.x);
+		beta = asin(constrain(air.y / speed, -1, 1));
+	}
+	if (fabs(alpha) < PLANE_STALL) {
+		cl = PLANE_CL0 + PLANE_CLA * alpha;
+	} else {
+		// past the stall most of the lift goes
+		cl = 0.3 * (PLANE_CL0 + PLANE_CLA * PLANE_STALL) * (alpha > 0 ? 1 : -1);
+	}
+	float lift = qbar * PLANE_AREA * cl;
+	float drag = qbar * PLANE_AREA * (PLANE_CD0 + PLANE_CDI * cl * cl);
+
+	force.x = throttle * PLANE_THRUST + lift * sin(alpha) - drag * cos(alpha);
+	force.y = -qbar * PLANE_AREA * PLANE_CYB * beta;
+	force.z = -lift * cos(alpha) - drag * sin(alpha);
+
+	torque.x = qbar * (PLANE_AIL * aileron - PLANE_DIHEDRAL * beta - PLANE_DAMP * omega.x);
+	torque.y = qbar * (-PLANE_ELEV * elevator - PLANE_ALPHA * (alpha - PLANE_CL0 / PLANE_CLA) -
+					   PLANE_DAMP * omega.y);
+	torque.z = qbar * (PLANE_RUD * rudder + PLANE_BETA * beta - PLANE_DAMP * omega.z);
+	// a little damping that doesn't need airflow, so it settles at rest
+	torque -= omega;
+}
+
+/*
+  stop at the ground. A copter sits level on it; a plane rolls along
+  it on its wheels, free to pitch up to take off
+ */
+static void ground_contact(float delta_t)
+{
+	float roll, pitch, yaw;
+
+	if (position.z < 0) {
+		return;
+	}
+	position.z = 0;
+	if (velocity.z > 0) {
+		velocity.z = 0;
+	}
+	dcm_to_euler(&roll, &pitch, &yaw);
+
+	if (model->kind == MODEL_MULTICOPTER) {
+		velocity = Vector3f(0, 0, velocity.z);
+		omega = Vector3f(0, 0, 0);
+		dcm_from_euler(0, 0, yaw);
+		return;
+	}
+
+	// the wheels only roll along the heading
+	float along = velocity.x * cos(yaw) + velocity.y * sin(yaw);
+	along -= along * PLANE_ROLLING * delta_t;
+	velocity.x = along * cos(yaw);
+	velocity.y = along * sin(yaw);
+	omega.x = 0;
+	if (pitch <= 0) {
+		pitch = 0;
+		if (omega.y < 0) {
+			omega.y = 0;
+		}
+	}
+	dcm_from_euler(0, pitch, yaw);
+}
+
+void sitl_model_update(const uint16_t pwm[8], float delta_t, struct sitl_fdm *fdm)
+{
+	Vector3f force, angular_accel;
+	float mass;
+
+	if (model->kind == MODEL_MULTICOPTER) {
+		multicopter_forces(pwm, force, angular_accel);
+		mass = COPTER_MASS;
+	} else {
+		plane_forces(pwm, force, angular_accel);
+		mass = PLANE_MASS;
+	}
+
+	// earth frame acceleration
+	Vector3f accel = dcm * (force / mass);
+	accel.z += GRAVITY;
+	if (model->kind == MODEL_MULTICOPTER) {
+		accel -= velocity * COPTER_LIN_DRAG;
+	}
+
+	omega += angular_accel * delta_t;
+	dcm.rotate(omega * delta_t);
+	dcm_normalize();
+	velocity += accel * delta_t;
+	position += velocity * delta_t;
+
+	ground_contact(delta_t);
+	fill_fdm(fdm);
+}
@@ -0,0 +1,40 @@
+/*
+  SITL handling
+
+  A built-in flight dynamics model, for running SITL without an
+  external simulator
+ */
+
+#ifndef _SITL_MODEL_H
+#define _SITL_MODEL_H
+
+#include <stdint.h>
+
+// what the model gives the sensor emulation each frame, in the same
+// units as the simulator packets once converted
+struct sitl_fdm {
+	double latitude, longitude; // degrees
+	double altitude; // MSL, meters
+	double heading; // degrees
+	double speedN, speedE; // m/s
+	double roll, pitch, yaw; // degrees
+	double airspeed; // m/s
+};
+
+// choose the model by name, false if there is no such model
+bool sitl_model_select(const char *name);
+
+// set the starting point from "LAT,LON,ALT,HEADING", false if it
+// doesn't parse
+bool sitl_model_home(const char *home);
+
+// the names of the models, for the usage message
+const char *sitl_model_names(void);
+
+// put the model at the starting point, at rest on the ground
+void sitl_model_reset(struct sitl_fdm *fdm);
+
+// move the model on by delta_t seconds with the given PWM outputs
+void sitl_model_update(const uint16_t pwm[8], float delta_t, struct sitl_fdm *fdm);
+
+#endif
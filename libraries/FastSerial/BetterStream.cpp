@@ -59,3 +59,28 @@ BetterStream::txspace(void)
         // by default claim that there is always space in transmit buffer
         return(INT_MAX);
 }
+
+uint8_t *
+BetterStream::tx_reserve(uint16_t, uint16_t *, uint8_t **)
+{
+        // by default there is no buffer to write into
+        return(NULL);
+}
+
+void
+BetterStream::tx_commit(uint16_t)
+{
+}
+
+const uint8_t *
+BetterStream::rx_peek(uint16_t *len)
+{
+        // by default there is no buffer to read from
+        *len = 0;
+        return(NULL);
+}
+
+void
+BetterStream::rx_consume(uint16_t)
+{
+}
@@ -30,6 +30,21 @@ public:
 
         virtual int     txspace(void);
 
+        // Zero-copy transmit.  tx_reserve() returns a pointer to free
+        // space for len bytes at the head of the transmit buffer, or
+        // NULL if there isn't room or the stream can't do it.  The
+        // first *contig bytes are at the returned pointer, the rest at
+        // *wrap.  Nothing is sent until tx_commit(len).
+        virtual uint8_t *tx_reserve(uint16_t len, uint16_t *contig, uint8_t **wrap);
+        virtual void    tx_commit(uint16_t len);
+
+        // Zero-copy receive.  rx_peek() returns a pointer to the
+        // oldest received bytes and sets *len to how many can be read
+        // there without wrapping, or returns NULL if the stream can't
+        // do it.  rx_consume(len) then discards them.
+        virtual const uint8_t *rx_peek(uint16_t *len);
+        virtual void    rx_consume(uint16_t len);
+
 #define printf_P(fmt, ...) _printf_P((const prog_char *)fmt, ## __VA_ARGS__)
 
 private:
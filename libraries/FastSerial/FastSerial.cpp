@@ -217,6 +217,66 @@ void FastSerial::write(uint8_t c)
 	*_ucsrb |= _portTxBits;
 }
 
+uint8_t *FastSerial::tx_reserve(uint16_t len, uint16_t *contig, uint8_t **wrap)
+{
+	uint16_t head, space;
+
+	if (!_open)
+		return NULL;
+
+	// the ring holds at most mask bytes, as head == tail means empty
+	head = _txBuffer->head;
+	space = (_txBuffer->tail - head - 1) & _txBuffer->mask;
+	if (len > space)
+		return NULL;
+
+	*contig = (_txBuffer->mask + 1) - head;
+	*wrap = _txBuffer->bytes;
+	return &_txBuffer->bytes[head];
+}
+
+void FastSerial::tx_commit(uint16_t len)
+{
+	uint16_t head;
+	uint8_t sreg;
+
+	head = (_txBuffer->head + len) & _txBuffer->mask;
+
+	// publish the new head in one go, so the tx interrupt never sees
+	// half of it
+	sreg = SREG;
+	cli();
+	_txBuffer->head = head;
+	SREG = sreg;
+
+	// enable the data-ready interrupt, as it may be off if the buffer is empty
+	*_ucsrb |= _portTxBits;
+}
+
+const uint8_t *FastSerial::rx_peek(uint16_t *len)
+{
+	uint16_t head, tail;
+
+	*len = 0;
+	if (!_open)
+		return NULL;
+
+	// the rx interrupt only ever moves head forward, so whatever we
+	// see here stays valid until we move tail
+	head = _rxBuffer->head;
+	tail = _rxBuffer->tail;
+	if (head >= tail)
+		*len = head - tail;
+	else
+		*len = (_rxBuffer->mask + 1) - tail;
+	return &_rxBuffer->bytes[tail];
+}
+
+void FastSerial::rx_consume(uint16_t len)
+{
+	_rxBuffer->tail = (_rxBuffer->tail + len) & _rxBuffer->mask;
+}
+
 // Buffer management ///////////////////////////////////////////////////////////
 
 bool FastSerial::_allocBuffer(Buffer *buffer, unsigned int size)
@@ -120,6 +120,25 @@ public:
 	using BetterStream::write;
 	//@}
 
+	/// @name	Zero-copy transmit
+	///
+	/// Lets a writer such as the MAVLink sender pack a whole packet
+	/// directly into the transmit ring and publish it with a single head
+	/// pointer update.
+	//@{
+	virtual uint8_t *tx_reserve(uint16_t len, uint16_t *contig, uint8_t **wrap);
+	virtual void tx_commit(uint16_t len);
+	//@}
+
+	/// @name	Zero-copy receive
+	///
+	/// Lets a reader such as the MAVLink parser scan received bytes in
+	/// place rather than pulling them out one call at a time.
+	//@{
+	virtual const uint8_t *rx_peek(uint16_t *len);
+	virtual void rx_consume(uint16_t len);
+	//@}
+
 	/// Extended port open method
 	///
 	/// Allows for both opening with specified buffer sizes, and re-opening
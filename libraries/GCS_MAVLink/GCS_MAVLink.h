@@ -7,9 +7,14 @@
 #define GCS_MAVLink_h
 
 #include <BetterStream.h>
+#include <avr/pgmspace.h>
 
 #define MAVLINK_SEPARATE_HELPERS
 
+/// X.25 CRC lookup table, in program memory
+extern const uint16_t mavlink_crc_table[256] PROGMEM;
+#define MAVLINK_CRC_TABLE_LOOKUP(i) pgm_read_word(&mavlink_crc_table[i])
+
 #ifdef MAVLINK10
 # include "include_v1.0/ardupilotmega/version.h"
 #else
@@ -76,6 +81,49 @@ static inline uint8_t comm_receive_ch(mavlink_channel_t chan)
     return data;
 }
 
+/// Receive a block of bytes from the nominated MAVLink channel
+///
+/// Hands back as much of the channel's receive buffer as can be seen in
+/// one contiguous run, without copying it.  The bytes stay in the buffer
+/// until comm_receive_done() is called.
+///
+/// @param chan		Channel to receive on
+/// @param len		Set to the number of bytes available at the pointer
+/// @returns		Pointer to the bytes, or NULL if the port can't do
+///					block reads; use comm_receive_ch() instead
+///
+static inline const uint8_t *comm_receive_block(mavlink_channel_t chan, uint16_t *len)
+{
+    switch(chan) {
+	case MAVLINK_COMM_0:
+		return mavlink_comm_0_port->rx_peek(len);
+	case MAVLINK_COMM_1:
+		return mavlink_comm_1_port->rx_peek(len);
+	default:
+		break;
+	}
+    return NULL;
+}
+
+/// Release bytes returned by comm_receive_block()
+///
+/// @param chan		Channel to receive on
+/// @param len		Number of bytes consumed
+///
+static inline void comm_receive_done(mavlink_channel_t chan, uint16_t len)
+{
+    switch(chan) {
+	case MAVLINK_COMM_0:
+		mavlink_comm_0_port->rx_consume(len);
+		break;
+	case MAVLINK_COMM_1:
+		mavlink_comm_1_port->rx_consume(len);
+		break;
+	default:
+		break;
+	}
+}
+
 /// Check for available data on the nominated MAVLink channel
 ///
 /// @param chan		Channel to check
@@ -116,6 +164,24 @@ static inline int comm_get_txspace(mavlink_channel_t chan)
     return -1;
 }
 
+/// Send a complete MAVLink frame on the nominated channel
+///
+/// Packs the header, payload and checksum straight into the port's
+/// transmit buffer, computing the X.25 checksum in the same pass.
+///
+/// @param chan		Channel to send to
+/// @param header	The MAVLINK_NUM_HEADER_BYTES header bytes, from STX on
+/// @param packet	The payload
+/// @param length	Payload length
+/// @param crc_extra	Extra CRC byte for the message, or -1 for none
+/// @returns		false if the port couldn't reserve space for the frame,
+///					in which case nothing has been sent
+///
+bool comm_send_packet(mavlink_channel_t chan, const uint8_t *header,
+					  const char *packet, uint8_t length, int16_t crc_extra);
+
+#define MAVLINK_SEND_PACKET comm_send_packet
+
 #define MAVLINK_USE_CONVENIENCE_FUNCTIONS
 #ifdef MAVLINK10
 # include "include_v1.0/ardupilotmega/mavlink.h"
@@ -26,12 +26,17 @@ extern "C" {
  **/
 static inline void crc_accumulate(uint8_t data, uint16_t *crcAccum)
 {
+#ifdef MAVLINK_CRC_TABLE_LOOKUP
+        /* the platform supplies a 256 entry table, one lookup per byte */
+        *crcAccum = (*crcAccum>>8) ^ MAVLINK_CRC_TABLE_LOOKUP((uint8_t)(data ^ *crcAccum));
+#else
         /*Accumulate one byte of data into the CRC*/
         uint8_t tmp;
 
         tmp = data ^ (uint8_t)(*crcAccum &0xff);
         tmp ^= (tmp<<4);
         *crcAccum = (*crcAccum>>8) ^ (tmp<<8) ^ (tmp <<3) ^ (tmp>>4);
+#endif
 }
 
 /**
@@ -71,12 +76,14 @@ static inline uint16_t crc_calculate(uint8_t* pBuffer, uint16_t length)
  * @param data new bytes to hash
  * @param crcAccum the already accumulated checksum
  **/
-static inline void crc_accumulate_buffer(uint16_t *crcAccum, const char *pBuffer, uint8_t length)
+static inline void crc_accumulate_buffer(uint16_t *crcAccum, const char *pBuffer, uint16_t length)
 {
 	const uint8_t *p = (const uint8_t *)pBuffer;
+	uint16_t crcTmp = *crcAccum;
 	while (length--) {
-                crc_accumulate(*p++, crcAccum);
+                crc_accumulate(*p++, &crcTmp);
         }
+	*crcAccum = crcTmp;
 }
 
 
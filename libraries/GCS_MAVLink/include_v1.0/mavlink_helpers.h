@@ -99,6 +99,17 @@ MAVLINK_HELPER void _mav_finalize_message_chan_send(mavlink_channel_t chan, uint
 	buf[4] = mavlink_system.compid;
 	buf[5] = msgid;
 	status->current_tx_seq++;
+#ifdef MAVLINK_SEND_PACKET
+	/* if the platform can, let it pack the whole frame straight
+	   into its transmit buffer, checksumming as it copies */
+#if MAVLINK_CRC_EXTRA
+	if (MAVLINK_SEND_PACKET(chan, buf, packet, length, crc_extra)) {
+#else
+	if (MAVLINK_SEND_PACKET(chan, buf, packet, length, -1)) {
+#endif
+		return;
+	}
+#endif
 	checksum = crc_calculate((uint8_t*)&buf[1], MAVLINK_CORE_HEADER_LEN);
 	crc_accumulate_buffer(&checksum, packet, length);
 #if MAVLINK_CRC_EXTRA
@@ -180,21 +191,22 @@ MAVLINK_HELPER void mavlink_update_checksum(mavlink_message_t* msg, uint8_t c)
  *
  * @endcode
  */
-MAVLINK_HELPER uint8_t mavlink_parse_char(uint8_t chan, uint8_t c, mavlink_message_t* r_message, mavlink_status_t* r_mavlink_status)
-{
-	static mavlink_message_t m_mavlink_message[MAVLINK_COMM_NUM_BUFFERS];
-
-        /*
-	  default message crc function. You can override this per-system to
-	  put this data in a different memory segment
-	*/
+/*
+  default message crc function. You can override this per-system to
+  put this data in a different memory segment. Shared by
+  mavlink_parse_char() and mavlink_parse_buffer()
+*/
 #if MAVLINK_CRC_EXTRA
 #ifndef MAVLINK_MESSAGE_CRC
-	static const uint8_t mavlink_message_crcs[256] = MAVLINK_MESSAGE_CRCS;
+static const uint8_t mavlink_message_crcs[256] = MAVLINK_MESSAGE_CRCS;
 #define MAVLINK_MESSAGE_CRC(msgid) mavlink_message_crcs[msgid]
 #endif
 #endif
 
+MAVLINK_HELPER uint8_t mavlink_parse_char(uint8_t chan, uint8_t c, mavlink_message_t* r_message, mavlink_status_t* r_mavlink_status)
+{
+	static mavlink_message_t m_mavlink_message[MAVLINK_COMM_NUM_BUFFERS];
+
 	mavlink_message_t* rxmsg = &m_mavlink_message[chan]; ///< The currently decoded message
 	mavlink_status_t* status = mavlink_get_channel_status(chan); ///< The current decode status
 	int bufferIndex = 0;
@@ -345,6 +357,113 @@ MAVLINK_HELPER uint8_t mavlink_parse_char(uint8_t chan, uint8_t c, mavlink_messa
 	return status->msg_received;
 }
 
+/**
+ * @brief Parse a block of received bytes, calling back for each message
+ *
+ * Frames that lie wholly inside the buffer are found by scanning for
+ * STX and checked with a single pass over the bytes, rather than going
+ * through the per-byte state machine. A frame that runs off the end of
+ * the buffer is handed to mavlink_parse_char() a byte at a time, and is
+ * picked up where it left off on the next call.
+ *
+ * @param chan     ID of the current channel, as for mavlink_parse_char()
+ * @param buf      received bytes
+ * @param len      number of bytes in buf
+ * @param r_mavlink_status receive statistics, as for mavlink_parse_char()
+ * @param callback called with each message decoded, and the number of
+ *                 bytes of buf up to its end; the parse stops if it
+ *                 returns 0
+ * @param arg      passed through to callback
+ * @return the number of messages decoded
+ */
+MAVLINK_HELPER uint8_t mavlink_parse_buffer(uint8_t chan, const uint8_t *buf, uint16_t len, mavlink_status_t* r_mavlink_status,
+					    mavlink_parse_callback_t callback, void *arg)
+{
+	mavlink_status_t* status = mavlink_get_channel_status(chan);
+	mavlink_message_t msg;
+	const uint8_t *start = buf;
+	uint16_t drops = 0;
+	uint8_t count = 0;
+	uint8_t more = 1;
+
+	while (len > 0 && more) {
+		uint8_t plen;
+		uint16_t flen, checksum;
+
+		if (status->parse_state == MAVLINK_PARSE_STATE_UNINIT ||
+		    status->parse_state == MAVLINK_PARSE_STATE_IDLE) {
+			if (*buf != MAVLINK_STX) {
+				/* skip to the next start of frame */
+				const uint8_t *stx = (const uint8_t *)memchr(buf, MAVLINK_STX, len);
+				if (stx == NULL) {
+					break;
+				}
+				len -= stx - buf;
+				buf = stx;
+			}
+			plen = (len > 1) ? buf[1] : 0;
+			flen = plen + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+			if (len > 1 && plen > MAVLINK_MAX_PAYLOAD_LEN) {
+				/* can't be a frame of ours */
+				drops++;
+				buf++;
+				len--;
+				continue;
+			}
+			if (len > 1 && len >= flen) {
+				crc_init(&checksum);
+				crc_accumulate_buffer(&checksum, (const char *)&buf[1], MAVLINK_CORE_HEADER_LEN + plen);
+#if MAVLINK_CRC_EXTRA
+				crc_accumulate(MAVLINK_MESSAGE_CRC(buf[5]), &checksum);
+#endif
+				if (buf[flen-2] != (checksum & 0xFF) ||
+				    buf[flen-1] != (checksum >> 8)) {
+					/* not a good frame, look for the next STX */
+					drops++;
+					buf++;
+					len--;
+					continue;
+				}
+
+				msg.checksum = checksum;
+				msg.magic = MAVLINK_STX;
+				msg.len = plen;
+				msg.seq = buf[2];
+				msg.sysid = buf[3];
+				msg.compid = buf[4];
+				msg.msgid = buf[5];
+				memcpy(_MAV_PAYLOAD(&msg), &buf[MAVLINK_NUM_HEADER_BYTES], plen);
+				buf += flen;
+				len -= flen;
+
+				status->current_rx_seq = msg.seq;
+				// Initial condition: If no packet has been received so far, drop count is undefined
+				if (status->packet_rx_success_count == 0) status->packet_rx_drop_count = 0;
+				status->packet_rx_success_count++;
+
+				count++;
+				more = callback(arg, &msg, buf - start);
+				continue;
+			}
+		}
+
+		/* part way through a frame, or a frame that runs off the
+		   end of the buffer, so let the state machine carry it */
+		if (mavlink_parse_char(chan, *buf, &msg, r_mavlink_status)) {
+			count++;
+			more = callback(arg, &msg, buf + 1 - start);
+		}
+		drops += r_mavlink_status->packet_rx_drop_count;
+		buf++;
+		len--;
+	}
+
+	r_mavlink_status->current_rx_seq = status->current_rx_seq+1;
+	r_mavlink_status->packet_rx_success_count = status->packet_rx_success_count;
+	r_mavlink_status->packet_rx_drop_count = drops;
+	return count;
+}
+
 /**
  * @brief Put a bitfield of length 1-32 bit into the buffer
  *
@@ -92,6 +92,11 @@ typedef struct __mavlink_message {
 	uint64_t payload64[(MAVLINK_MAX_PAYLOAD_LEN+MAVLINK_NUM_CHECKSUM_BYTES+7)/8];
 } mavlink_message_t;
 
+/// called by mavlink_parse_buffer() for each message decoded. used is
+/// the number of bytes of the buffer up to the end of msg. Returning 0
+/// stops the parse after msg
+typedef uint8_t (*mavlink_parse_callback_t)(void *arg, mavlink_message_t *msg, uint16_t used);
+
 typedef enum {
 	MAVLINK_TYPE_CHAR     = 0,
 	MAVLINK_TYPE_UINT8_T  = 1,